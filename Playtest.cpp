@@ -35,15 +35,18 @@ void Play(std::vector<int> roles, int difficulty){
     // While the game isn't over (while maintaining sanity checks throughout)
     int decisions_made = 0;
     
-    // While keeping track of sanity checks (at computational expense)
-    while(!the_game.is_terminal(true,true)){
+    // While keeping track of sanity checks (at computational expense: the paranoid ones, since this is for finding bugs)
+    SanityCheck::ParanoidCheck(*vanilla_board,true);
+    while(!the_game.is_terminal(false,true)){
         // First resolve any necessary non-player transisitions (card draws, etc)
         the_game.nonplayer_actions(true);
+        SanityCheck::ParanoidCheck(*vanilla_board,true);
         
         // If these transitions haven't made the game terminal, then have the agent choose a transition
-        if(!the_game.is_terminal(true,true)){
+        if(!the_game.is_terminal(false,true)){
             the_agent -> take_step(true);
             decisions_made++;
+            SanityCheck::ParanoidCheck(*vanilla_board,true);
         }
     }
     DEBUG_MSG(std::endl << "game finished!" << std::endl << "The agent made " + std::to_string(decisions_made) + " decisions.\n");
@@ -0,0 +1,342 @@
+#include <cmath>
+#include <algorithm>
+
+#include "../game_files/Board.h"
+#include "../game_files/Debug.h"
+#include "../game_files/GameLogic.h"
+#include "../game_files/StochasticActions.h"
+
+#include "Agents.h"
+#include "Heuristics.h"
+#include "ExpectimaxAgent.h"
+
+#include "search_tools/SearchStats.h"
+
+namespace
+{
+    // Every value the search backs up lies in [L,U]
+    const double L = 0.;
+    const double U = 1.;
+
+    // A player choice, the board it leads to, and how good it looked last time we checked
+    struct Child{
+        Actions::Action* action;
+        Board::Board board;
+        double order_value;
+    };
+
+    bool better_child(const Child& a,const Child& b){
+        return a.order_value > b.order_value;
+    }
+
+    bool more_likely(const StochasticActions::ChanceOutcome& a,const StochasticActions::ChanceOutcome& b){
+        return a.probability > b.probability;
+    }
+}
+
+Agents::ExpectimaxAgent::ExpectimaxAgent(GameLogic::Game& _active_game,double _time_budget,int _max_depth,double _alpha):
+    BaseAgent(_active_game)
+    {
+        time_budget = _time_budget;
+        max_depth = _max_depth;
+        alpha = _alpha;
+
+        name += " (" + std::to_string(time_budget) + "s per step, up to depth " + std::to_string(max_depth) + ")";
+
+        measurable=true;
+}
+
+bool Agents::ExpectimaxAgent::check_time(){
+    if(!out_of_time && std::chrono::steady_clock::now() >= deadline){
+        out_of_time=true;
+    }
+    return out_of_time;
+}
+
+double Agents::ExpectimaxAgent::evaluate(Board::Board& game_board){
+    leaf_evaluations++;
+    if(active_game.is_terminal(game_board)){
+        // (a broken board counts as a loss)
+        return game_board.has_won() ? U : L;
+    }
+    double heuristic_value = Heuristics::SmartCompoundHeuristic(game_board,alpha);
+    return std::min(U,std::max(L,heuristic_value));
+}
+
+double Agents::ExpectimaxAgent::value(Board::Board& game_board,int depth,double lower,double upper){
+    nodes_searched++;
+    Search::count_node();
+    if(check_time()){
+        // Doesn't matter what comes back, this iteration will be thrown away
+        return L;
+    }
+    if(depth<=0 || active_game.is_terminal(game_board)){
+        return evaluate(game_board);
+    }
+    if(active_game.is_stochastic(game_board)){
+        return chance_value(game_board,depth,lower,upper);
+    }
+    return max_value(game_board,depth,lower,upper);
+}
+
+double Agents::ExpectimaxAgent::max_value(Board::Board& game_board,int depth,double lower,double upper){
+    std::vector<Actions::Action*> actions = active_game.list_actions(game_board);
+    if(actions.empty()){
+        // Shouldn't happen on a non-terminal, non-stochastic board, but the heuristic is still a sensible answer
+        return evaluate(game_board);
+    }
+
+    std::vector<Child> children = {};
+    children.reserve(actions.size());
+    for(Actions::Action* action: actions){
+        children.push_back({action,game_board,0.});
+        action -> execute(children.back().board);
+    }
+
+    // Order children by their immediate heuristic value, unless they're about to be evaluated as leaves anyway
+    if(depth>1){
+        for(Child& child: children){
+            child.order_value = evaluate(child.board);
+        }
+        std::stable_sort(children.begin(),children.end(),better_child);
+    }
+
+    double best = L;
+    for(Child& child: children){
+        double child_value = value(child.board,depth-1,std::max(lower,best),upper);
+        if(out_of_time){
+            break;
+        }
+        if(child_value > best){
+            best = child_value;
+        }
+        if(best >= upper){
+            // The chance node above already knows enough to not want this
+            max_cutoffs++;
+            break;
+        }
+    }
+
+    for(Actions::Action* action: actions){
+        delete action;
+    }
+    return best;
+}
+
+double Agents::ExpectimaxAgent::chance_value(Board::Board& game_board,int depth,double lower,double upper){
+    std::vector<StochasticActions::ChanceOutcome> outcomes = {};
+    active_game.stochastic_outcomes(game_board,outcomes);
+    if(outcomes.empty()){
+        return evaluate(game_board);
+    }
+    // The likeliest outcomes first, so the bounds tighten fastest
+    std::stable_sort(outcomes.begin(),outcomes.end(),more_likely);
+
+    // Star1: with `seen` = sum of p*value over outcomes searched so far and `remaining` = probability of the rest,
+    // the node's value is somewhere in [seen + L*remaining, seen + U*remaining].
+    // Each outcome is searched with the window that would let the node's value fall in (lower,upper).
+    double seen = 0;
+    double remaining = 1;
+    double result = -1;
+    for(int i=0;i<(int) outcomes.size();i++){
+        StochasticActions::ChanceOutcome& outcome = outcomes[i];
+        double rest = std::max(0.,remaining - outcome.probability);
+
+        double child_lower = std::max(L,(lower - seen - U*rest)/outcome.probability);
+        double child_upper = std::min(U,(upper - seen - L*rest)/outcome.probability);
+
+        Board::Board child_board = game_board;
+        outcome.action -> execute(child_board);
+        double child_value = value(child_board,depth,child_lower,child_upper);
+        if(out_of_time){
+            result = L;
+            break;
+        }
+
+        seen += outcome.probability*child_value;
+        remaining = rest;
+
+        if(i<(int) outcomes.size()-1){
+            if(seen + U*remaining <= lower){
+                // Can't reach `lower` even if everything else is a win
+                chance_cutoffs++;
+                result = seen + U*remaining;
+                break;
+            }
+            if(seen + L*remaining >= upper){
+                // Already at `upper` even if everything else is a loss
+                chance_cutoffs++;
+                result = seen + L*remaining;
+                break;
+            }
+        }
+    }
+    if(result<0){
+        result = seen;
+    }
+
+    for(StochasticActions::ChanceOutcome& outcome: outcomes){
+        delete outcome.action;
+    }
+    return result;
+}
+
+Actions::Action* Agents::ExpectimaxAgent::generate_action(bool verbose){
+    search_stats.begin_decision();
+    deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(time_budget));
+    out_of_time = false;
+    nodes_searched = 0;
+    leaf_evaluations = 0;
+    chance_cutoffs = 0;
+    max_cutoffs = 0;
+
+    Board::Board root_board = active_game.board_copy();
+    std::vector<Actions::Action*> actions = active_game.list_actions(root_board);
+
+    // The root's children are made once, and reordered by each finished iteration
+    std::vector<Child> children = {};
+    children.reserve(actions.size());
+    for(Actions::Action* action: actions){
+        children.push_back({action,root_board,0.});
+        action -> execute(children.back().board);
+        children.back().order_value = evaluate(children.back().board);
+    }
+    std::stable_sort(children.begin(),children.end(),better_child);
+
+    // If no iteration finishes, the best-looking child is as good a choice as any
+    Actions::Action* chosen_action = children.front().action;
+    double chosen_value = children.front().order_value;
+    int completed_depth = 0;
+
+    if(children.size()>1){
+        for(int depth=1;depth<=max_depth;depth++){
+            std::vector<double> iteration_values(children.size(),L);
+            double best = L;
+            int best_child = 0;
+            for(int child_num=0;child_num<(int) children.size();child_num++){
+                // Only the best child so far needs an exact value; the others only need to be shown not to beat it
+                iteration_values[child_num] = value(children[child_num].board,depth-1,best,U);
+                if(out_of_time){
+                    break;
+                }
+                if(iteration_values[child_num] > best || child_num==0){
+                    best = iteration_values[child_num];
+                    best_child = child_num;
+                }
+            }
+            if(out_of_time){
+                if(verbose){
+                    DEBUG_MSG("[ExpectimaxAgent::generate_action()] Ran out of time during depth " << depth << std::endl);
+                }
+                unfinished_iterations++;
+                break;
+            }
+            chosen_action = children[best_child].action;
+            chosen_value = best;
+            completed_depth = depth;
+
+            for(int child_num=0;child_num<(int) children.size();child_num++){
+                children[child_num].order_value = iteration_values[child_num];
+            }
+            std::stable_sort(children.begin(),children.end(),better_child);
+
+            if(best>=U || check_time()){
+                // Nothing left to find out (or no time to find it out in)
+                break;
+            }
+        }
+    }
+
+    completed_depths.push_back(completed_depth);
+    decision_nodes.push_back((double) nodes_searched);
+    decision_chance_cutoffs.push_back((double) chance_cutoffs);
+    decision_max_cutoffs.push_back((double) max_cutoffs);
+    chosen_values.push_back(chosen_value);
+    search_stats.end_decision((int) leaf_evaluations);
+
+    for(Child& child: children){
+        if(child.action!=chosen_action){
+            delete child.action;
+        }
+    }
+    return chosen_action;
+}
+
+void Agents::ExpectimaxAgent::take_step(bool verbose){
+    Actions::Action* chosen_action = generate_action(verbose);
+    active_game.applyAction(chosen_action);
+    if(verbose){
+        DEBUG_MSG(std::endl << "[ExpectimaxAgent::take_step()] " << active_game.get_board_ptr() -> active_player().role.name << ": " << chosen_action -> repr() << std::endl);
+    }
+    delete chosen_action;
+}
+
+void Agents::ExpectimaxAgent::reset(){
+    search_stats.reset();
+    completed_depths.clear();
+    decision_nodes.clear();
+    decision_chance_cutoffs.clear();
+    decision_max_cutoffs.clear();
+    chosen_values.clear();
+    unfinished_iterations=0;
+}
+
+std::vector<std::string> Agents::ExpectimaxAgent::get_keys(){
+    std::vector<std::string> keys = {
+        "AvgCompletedDepth",
+        "MaxCompletedDepth",
+        "MinCompletedDepth",
+        "AvgNodesSearched",
+        "AvgChanceCutoffs",
+        "AvgMaxCutoffs",
+        "AvgChosenValue",
+        "UnfinishedIterations"
+    };
+
+    // Followed by the search timing/size measurements
+    std::vector<std::string> search_keys = search_stats.get_keys();
+    keys.insert(keys.end(),search_keys.begin(),search_keys.end());
+    return keys;
+}
+
+std::vector<double> Agents::ExpectimaxAgent::get_values(){
+    double depth_mean=0;
+    for(int& d : completed_depths){
+        depth_mean+=(double) d/(double) completed_depths.size();
+    }
+
+    double nodes_mean=0;
+    for(double& n : decision_nodes){
+        nodes_mean+=n/(double) decision_nodes.size();
+    }
+
+    double chance_cutoffs_mean=0;
+    for(double& c : decision_chance_cutoffs){
+        chance_cutoffs_mean+=c/(double) decision_chance_cutoffs.size();
+    }
+
+    double max_cutoffs_mean=0;
+    for(double& c : decision_max_cutoffs){
+        max_cutoffs_mean+=c/(double) decision_max_cutoffs.size();
+    }
+
+    double value_mean=0;
+    for(double& v : chosen_values){
+        value_mean+=v/(double) chosen_values.size();
+    }
+
+    std::vector<double> values = {
+        depth_mean,
+        completed_depths.empty() ? -1. : (double) *std::max_element(completed_depths.begin(),completed_depths.end()),
+        completed_depths.empty() ? -1. : (double) *std::min_element(completed_depths.begin(),completed_depths.end()),
+        nodes_mean,
+        chance_cutoffs_mean,
+        max_cutoffs_mean,
+        value_mean,
+        (double) unfinished_iterations
+    };
+
+    std::vector<double> search_values = search_stats.get_values();
+    values.insert(values.end(),search_values.begin(),search_values.end());
+    return values;
+}
@@ -0,0 +1,82 @@
+#ifndef EXPECTIMAXAGENT_H
+#define EXPECTIMAXAGENT_H
+
+#include <chrono>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+
+#include "search_tools/SearchStats.h"
+
+#include "Agents.h"
+
+namespace Agents
+{
+    // Depth-limited expectimax (*-minimax) search over the exact chance outcomes of card draws (see GameLogic::Game::stochastic_outcomes()),
+    // with the same compound heuristic as SmartCompoundWL_UCTMaxChild at the leaves.
+    //
+    //      - depth counts player decisions (incl. forced discards); card draws in between don't use any depth.
+    //        When the depth runs out the board is evaluated by the heuristic, stochastic or not.
+    //      - values live in [0,1] (win/loss = 1/0, heuristics are clamped), so chance nodes can be cut off Star1-style:
+    //        as soon as the outcomes seen so far guarantee the chance node can't land inside (alpha,beta), whatever the rest turn out to be.
+    //      - player choices are searched in order of their immediate heuristic value, which is what makes those windows narrow.
+    //      - the search is iteratively deepened until `time_budget` seconds pass (or `max_depth` is done).
+    //        An unfinished iteration is thrown away, and each iteration orders the root by the values of the last one.
+    class ExpectimaxAgent: public BaseAgent{
+        // seconds per decision
+        double time_budget;
+
+        // deepest iteration to try (in player decisions)
+        int max_depth;
+
+        // weight between component compound heuristics
+        double alpha;
+
+        // When the current decision has to stop, and whether it's gotten there
+        std::chrono::steady_clock::time_point deadline;
+        bool out_of_time=false;
+
+        // Counters for the decision in progress
+        long nodes_searched=0;
+        long leaf_evaluations=0;
+        long chance_cutoffs=0;
+        long max_cutoffs=0;
+
+        // Timing and size of each search (see SearchStats.h). A "simulation" is a leaf evaluation here.
+        Search::SearchStats search_stats;
+
+        // Per-decision measurements for the game so far
+        std::vector<int> completed_depths = {};
+        std::vector<double> decision_nodes = {};
+        std::vector<double> decision_chance_cutoffs = {};
+        std::vector<double> decision_max_cutoffs = {};
+        std::vector<double> chosen_values = {};
+        int unfinished_iterations=0;
+
+        // The heuristic, clamped to [0,1]; or the 0/1 game reward if the board is terminal
+        double evaluate(Board::Board& game_board);
+
+        // Value of a board with `depth` player decisions left to search, within the window (lower,upper)
+        double value(Board::Board& game_board,int depth,double lower,double upper);
+        double max_value(Board::Board& game_board,int depth,double lower,double upper);
+        double chance_value(Board::Board& game_board,int depth,double lower,double upper);
+
+        // Check (and remember) whether the deadline has passed
+        bool check_time();
+    public:
+        std::string name = "Expectimax Agent with Star1 chance node pruning, using (# cured diseases/4)+.15* (max fraction of cards held toward curing uncured disease) + reward for station tangency value at the leaves";
+
+        ExpectimaxAgent(GameLogic::Game& _active_game,double time_budget,int max_depth=20,double alpha=.5);
+        ~ExpectimaxAgent(){};
+
+        Actions::Action* generate_action(bool verbose = false);
+        void take_step(bool verbose = false);
+
+        std::vector<std::string> get_keys();
+        std::vector<double> get_values();
+
+        void reset();
+    };
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef HEURISTICCOMBINATORS_H
+#define HEURISTICCOMBINATORS_H
+
+#include <algorithm>
+
+#include "../game_files/Board.h"
+
+#include "Heuristics.h"
+
+// Heuristics as types instead of function pointers.
+//
+// Every composite here is a small struct with `double operator()(Board::Board&)`, and its type spells out the whole composition,
+// e.g. Clamp<WeightedSum<Fn<CureGoalConditionswStation>,Fn<LossProximity>>>. Anything templated on the heuristic
+// (GameLogic::Game::epsgreedy_heuristic_rollout()) gets a concrete type to inline, instead of an indirect call per successor board.
+// They still convert to std::function wherever one is expected (Search::expected_heuristic()).
+//
+// The heuristics themselves live in Heuristics.cpp, so it's the composition around them that's inlined, not their bodies.
+namespace Heuristics
+{
+    // A plain heuristic function as a type (e.g. Fn<CureGoalConditionswStation>)
+    template<Heuristic* H>
+    struct Fn{
+        double operator()(Board::Board& game_board) const{
+            return H(game_board);
+        }
+    };
+
+    // CompoundHeuristic(board,CureGoalConditionswStation,SmartLossProximity,alpha), fused (see SmartCompoundHeuristic())
+    struct SmartCompound{
+        double alpha = .5;
+
+        double operator()(Board::Board& game_board) const{
+            return SmartCompoundHeuristic(game_board,alpha);
+        }
+    };
+
+    // alpha * h1 + (1-alpha) * h2, like CompoundHeuristic()
+    template<class H1,class H2>
+    struct WeightedSum{
+        H1 h1;
+        H2 h2;
+        double alpha = .5;
+
+        double operator()(Board::Board& game_board) const{
+            return alpha * h1(game_board) + (1.-alpha)*h2(game_board);
+        }
+    };
+
+    // max(h1, h2)
+    template<class H1,class H2>
+    struct Max{
+        H1 h1;
+        H2 h2;
+
+        double operator()(Board::Board& game_board) const{
+            return std::max(h1(game_board),h2(game_board));
+        }
+    };
+
+    // h clamped to [lo, hi]
+    template<class H>
+    struct Clamp{
+        H h;
+        double lo = 0;
+        double hi = 1;
+
+        double operator()(Board::Board& game_board) const{
+            return std::min(std::max(h(game_board),lo),hi);
+        }
+    };
+
+    // 1 on a won board, 0 on a lost one, h otherwise
+    template<class H>
+    struct TerminalOverride{
+        H h;
+
+        double operator()(Board::Board& game_board) const{
+            if(game_board.has_won()){
+                return 1.;
+            } else if(game_board.has_lost()){
+                return 0.;
+            }
+            return h(game_board);
+        }
+    };
+
+    // ===== Makers, so the types don't have to be written out =====
+    template<class H1,class H2>
+    WeightedSum<H1,H2> weighted_sum(H1 h1,H2 h2,double alpha=.5){
+        return WeightedSum<H1,H2>{h1,h2,alpha};
+    }
+
+    template<class H1,class H2>
+    Max<H1,H2> max_of(H1 h1,H2 h2){
+        return Max<H1,H2>{h1,h2};
+    }
+
+    template<class H>
+    Clamp<H> clamp(H h,double lo=0,double hi=1){
+        return Clamp<H>{h,lo,hi};
+    }
+
+    template<class H>
+    TerminalOverride<H> terminal_override(H h){
+        return TerminalOverride<H>{h};
+    }
+}
+
+#endif
@@ -7,11 +7,12 @@
 
 #include "../Agents.h"
 #include "../Heuristics.h"
-#include "KSample_Precondition_UCTMaxChildAgent.h"
+#include "KSample_CurePrecondition_UCTMaxChildAgent.h"
 
 #include "../search_tools/Search.h"
+#include "../search_tools/ExpectedHeuristic.h"
 
-Agents::KSample_Precondition_UCTMaxChildAgent::KSample_Precondition_UCTMaxChildAgent(GameLogic::Game& _active_game, int _n_simulations, int _K,int _VisitConvergenceCriteria):
+Agents::KSample_CurePrecondition_UCTMaxChildAgent::KSample_CurePrecondition_UCTMaxChildAgent(GameLogic::Game& _active_game, int _n_simulations, int _K,int _VisitConvergenceCriteria):
     BaseAgent(_active_game)
     {   
         n_simulations = _n_simulations;
@@ -25,13 +26,17 @@ Agents::KSample_Precondition_UCTMaxChildAgent::KSample_Precondition_UCTMaxChildA
         measurable=true;
 }
 
-Actions::Action* Agents::KSample_Precondition_UCTMaxChildAgent::generate_action(bool verbose){
+Actions::Action* Agents::KSample_CurePrecondition_UCTMaxChildAgent::generate_action(bool verbose){
     // Make a new search tree, which will instantiate a root
     // This tree takes 1 sample of a stochastic sequence at each stochastic node
     // Stochasticity is "saved" and revisited again upon every subsequent traversal
     
     // This represents a potential memory leak since without being used in take_step, tree at any existing ptr won't be deleted
-    search_tree = new Search::KDeterminizedGameTree(active_game,K);
+    search_stats.begin_decision();
+    heuristic_cache.new_search();
+    search_tree = Search::make_tree(active_game,K,tree_options);
+    search_tree -> stop_at_chance_leaves = infect_outcomes>1;
+    SEARCH_LAP(search_stats,Search::EXPANSION);
     int sims_done = 0;
 
     int search_depth=0;
@@ -39,11 +44,13 @@ Actions::Action* Agents::KSample_Precondition_UCTMaxChildAgent::generate_action(
     while(sims_done<n_simulations){   
         // Make a copy of the current board state to hand to the tree for consideration
         Board::Board board_copy = active_game.board_copy();
+        SEARCH_LAP(search_stats,Search::STATE_COPY);
 
         // Give the copy state to the tree in order for it to "roll it down" the actions on the tree to end up at a new deterministic node
         // Alter the board_copy in place to end up at a "leaf" board position
         // Return the best node resulting from tree policy
-        Search::Node* best_node = search_tree -> getBestLeaf(board_copy,Search::UCB1Score);
+        Search::Node* best_node = search_tree -> getBestLeaf(board_copy,Search::tree_policy(tree_options));
+        SEARCH_LAP(search_stats,Search::SELECTION);
 
         // Update the tree depth
         if(best_node -> depth > search_depth){
@@ -52,17 +59,27 @@ Actions::Action* Agents::KSample_Precondition_UCTMaxChildAgent::generate_action(
 
         // Straight up evaluate the heuristic of the state
         // Use the "CureGoalConditions": What fraction of 4 diseases are cured at rollout end, PLUS maximum fraction of satisfied preconditions to cure actions among players
-        double reward = Heuristics::CureGoalConditionswStation(board_copy);
+        double reward;
+        if(infect_outcomes>1 && best_node -> stochastic && !best_node -> terminal){
+            // (a chance leaf: take the expectation over the draws instead)
+            reward = Search::expected_heuristic(board_copy,active_game,[this](Board::Board& board){return heuristic_cache.evaluate(board,Heuristics::CureGoalConditionswStation);},infect_outcomes);
+        } else {
+            reward = heuristic_cache.evaluate(board_copy,Heuristics::CureGoalConditionswStation);
+        }
+        SEARCH_LAP(search_stats,Search::EVALUATION);
 
         // Back up the observed reward
         // (terminal nodes never get value changed on backprop)
         best_node -> backprop(reward);
+        search_tree -> backprop_amaf(best_node,reward);
+        SEARCH_LAP(search_stats,Search::BACKPROP);
         
         // One more simulation succesfully ran
         sims_done++;
     }
 
     Search::Node* chosen_child = get_max_child(search_tree -> root);
+    SEARCH_LAP(search_stats,Search::MAX_CHILD);
 
     tree_depths.push_back(search_depth); // Maximum search depth at this step
     chosen_rewards.push_back((double) chosen_child -> TotalReward / (double) chosen_child -> N_visits); // "Expected Reward"
@@ -73,11 +90,13 @@ Actions::Action* Agents::KSample_Precondition_UCTMaxChildAgent::generate_action(
         )/ (double) n_simulations); // Fraction of all simulations spent on this choice compared to a child explored an "average" amount. Neg -> This was chosen after other heavily explored options ruled out. Pos -> This was chosen after thorough exploration. ~0 -> Most likely no good reason to choose this vs. other children.
     Board::Board board_copy = active_game.board_copy();
     state_values.push_back(Heuristics::CureGoalConditionswStation(board_copy));
+    search_stats.end_decision(sims_done,search_tree -> memory.peak,search_tree -> average_determinizations());
+
     // After the simulation budget is used up, return the action attached to the most promising child of the root
-    return chosen_child -> get_action();
+    return search_tree -> chosen_action(chosen_child);
 }
 
-Search::Node* Agents::KSample_Precondition_UCTMaxChildAgent::get_max_child(Search::Node* root){
+Search::Node* Agents::KSample_CurePrecondition_UCTMaxChildAgent::get_max_child(Search::Node* root){
     // This is to be called on root, which is a deterministic node
     // This represents GREEDY SELECTION of maximum reward
     Search::Node* best_child = nullptr;
@@ -103,7 +122,7 @@ Search::Node* Agents::KSample_Precondition_UCTMaxChildAgent::get_max_child(Searc
     return best_child;
 }
 
-double Agents::KSample_Precondition_UCTMaxChildAgent::get_max_avgreward(Search::Node* node){
+double Agents::KSample_CurePrecondition_UCTMaxChildAgent::get_max_avgreward(Search::Node* node){
     if(node -> terminal){
         // If the node is terminal it's average reward is it's only reward is a for-sure reward is the score that was set on instantiation
         return node -> score;
@@ -154,7 +173,7 @@ double Agents::KSample_Precondition_UCTMaxChildAgent::get_max_avgreward(Search::
     }
 }
 
-void Agents::KSample_Precondition_UCTMaxChildAgent::take_step(bool verbose){
+void Agents::KSample_CurePrecondition_UCTMaxChildAgent::take_step(bool verbose){
     Actions::Action* chosen_action = generate_action(verbose);
     active_game.applyAction(chosen_action);
     if(verbose){
@@ -167,7 +186,9 @@ void Agents::KSample_Precondition_UCTMaxChildAgent::take_step(bool verbose){
     }
 }
 
-void Agents::KSample_Precondition_UCTMaxChildAgent::reset(){
+void Agents::KSample_CurePrecondition_UCTMaxChildAgent::reset(){
+    search_stats.reset();
+    heuristic_cache.reset();
     tree_depths.clear();
     chosen_rewards.clear();
     chosen_confidences.clear();
@@ -175,8 +196,8 @@ void Agents::KSample_Precondition_UCTMaxChildAgent::reset(){
     state_values.clear();
 }
 
-std::vector<std::string> Agents::KSample_Precondition_UCTMaxChildAgent::get_keys(){
-    return {
+std::vector<std::string> Agents::KSample_CurePrecondition_UCTMaxChildAgent::get_keys(){
+    std::vector<std::string> keys = {
         "AvgTreeDepth",
         "StdTreeDepth",
         "MaxTreeDepth",
@@ -230,9 +251,17 @@ std::vector<std::string> Agents::KSample_Precondition_UCTMaxChildAgent::get_keys
         "Turn85StateEval",
         "Turn90StateEval"
     };
+
+    // Followed by the search timing/size measurements
+    std::vector<std::string> search_keys = search_stats.get_keys();
+    keys.insert(keys.end(),search_keys.begin(),search_keys.end());
+    // and the heuristic cache's
+    std::vector<std::string> cache_keys = heuristic_cache.get_keys();
+    keys.insert(keys.end(),cache_keys.begin(),cache_keys.end());
+    return keys;
 }
 
-std::vector<double> Agents::KSample_Precondition_UCTMaxChildAgent::get_values(){
+std::vector<double> Agents::KSample_CurePrecondition_UCTMaxChildAgent::get_values(){
     // Avg tree depth
     double depth_mean=0;
     for(int& d : tree_depths){
@@ -278,7 +307,7 @@ std::vector<double> Agents::KSample_Precondition_UCTMaxChildAgent::get_values(){
         visits_minus_avg_mean+= v / (double) chosen_visits_minus_avg.size();
     }
 
-    return {
+    std::vector<double> values = {
         depth_mean, // Average Tree-Search max depth
         depth_std, // Std Tree-search max depth
         (double) *std::max_element(tree_depths.begin(),tree_depths.end()), // Max Tree-search max depth
@@ -331,5 +360,11 @@ std::vector<double> Agents::KSample_Precondition_UCTMaxChildAgent::get_values(){
         state_values.size()>=(80+1) ? state_values[80] : -1,
         state_values.size()>=(85+1) ? state_values[85] : -1,
         state_values.size()>=(90+1) ? state_values[90] : -1
-    };  
+    };
+
+    std::vector<double> search_values = search_stats.get_values();
+    values.insert(values.end(),search_values.begin(),search_values.end());
+    std::vector<double> cache_values = heuristic_cache.get_values();
+    values.insert(values.end(),cache_values.begin(),cache_values.end());
+    return values;
 }
\ No newline at end of file
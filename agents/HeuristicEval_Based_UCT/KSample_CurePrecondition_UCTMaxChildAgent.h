@@ -1,13 +1,15 @@
-#ifndef KSAMPLE_UCTAGENT_H
-#define KSAMPLE_UCTAGENT_H
+#ifndef KSAMPLE_CUREPRECONDITION_UCTMAXCHILDAGENT_H
+#define KSAMPLE_CUREPRECONDITION_UCTMAXCHILDAGENT_H
 
 #include "search_tools/Search.h"
+#include "search_tools/SearchStats.h"
+#include "search_tools/HeuristicCache.h"
 
 #include "../Agents.h"
 
 namespace Agents
 {
-    class KSample_Precondition_UCTMaxChildAgent: public BaseAgent{
+    class KSample_CurePrecondition_UCTMaxChildAgent: public BaseAgent{
         // simulation-per-step budget
         int n_simulations;
 
@@ -20,6 +22,9 @@ namespace Agents
         // Search tree to use on each step.
         Search::GameTree* search_tree = nullptr;
 
+        // Timing and size of each search (see SearchStats.h)
+        Search::SearchStats search_stats;
+
         // Maximum depth the search tree reached
         std::vector<int> tree_depths ={};
 
@@ -37,9 +42,19 @@ namespace Agents
         std::vector<double> chosen_visits_minus_avg = {};
     public:
         std::string name = "-Determinization A-star UCT Agent with (# cured diseases/4)+.15* (max fraction of cards held toward curing uncured disease)  + reward for station tangency value rollouts.";
+
+        // Which search tree to build and how (K determinizations with no memory cap by default, see Search::TreeOptions)
+        Search::TreeOptions tree_options;
+
+        // How many heuristic evaluations to spend taking the expectation over the infect draws at a chance leaf (see Search::expected_heuristic())
+        // 1 (the default) just evaluates one sampled determinization, as always
+        int infect_outcomes=1;
+
+        // Values of boards already evaluated in this search (see Search::HeuristicCache). Off unless heuristic_cache.enabled is set.
+        Search::HeuristicCache heuristic_cache;
         
-        KSample_Precondition_UCTMaxChildAgent(GameLogic::Game& _active_game,int n_simulations,int K,int VisitConvergenceCriteria=100);
-        ~KSample_Precondition_UCTMaxChildAgent(){
+        KSample_CurePrecondition_UCTMaxChildAgent(GameLogic::Game& _active_game,int n_simulations,int K,int VisitConvergenceCriteria=100);
+        ~KSample_CurePrecondition_UCTMaxChildAgent(){
             if(search_tree){
                 delete search_tree;
             }
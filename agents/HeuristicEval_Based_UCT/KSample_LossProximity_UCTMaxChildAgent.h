@@ -1,7 +1,9 @@
-#ifndef KSAMPLE_UCTAGENT_H
-#define KSAMPLE_UCTAGENT_H
+#ifndef KSAMPLE_LOSSPROXIMITY_UCTMAXCHILDAGENT_H
+#define KSAMPLE_LOSSPROXIMITY_UCTMAXCHILDAGENT_H
 
 #include "search_tools/Search.h"
+#include "search_tools/SearchStats.h"
+#include "search_tools/HeuristicCache.h"
 
 #include "../Agents.h"
 
@@ -20,6 +22,9 @@ namespace Agents
         // Search tree to use on each step.
         Search::GameTree* search_tree = nullptr;
 
+        // Timing and size of each search (see SearchStats.h)
+        Search::SearchStats search_stats;
+
         // Maximum depth the search tree reached
         std::vector<int> tree_depths ={};
 
@@ -37,6 +42,16 @@ namespace Agents
         std::vector<double> chosen_visits_minus_avg = {};
     public:
         std::string name = "-Determinization A-star UCT Agent with loss-proximity state evaluation.";
+
+        // Which search tree to build and how (K determinizations with no memory cap by default, see Search::TreeOptions)
+        Search::TreeOptions tree_options;
+
+        // How many heuristic evaluations to spend taking the expectation over the infect draws at a chance leaf (see Search::expected_heuristic())
+        // 1 (the default) just evaluates one sampled determinization, as always
+        int infect_outcomes=1;
+
+        // Values of boards already evaluated in this search (see Search::HeuristicCache). Off unless heuristic_cache.enabled is set.
+        Search::HeuristicCache heuristic_cache;
         
         KSample_LossProximity_UCTMaxChildAgent(GameLogic::Game& _active_game,int n_simulations,int K,int VisitConvergenceCriteria=100);
         ~KSample_LossProximity_UCTMaxChildAgent(){
@@ -1,9 +1,12 @@
-#ifndef KSAMPLE_UCTAGENT_H
-#define KSAMPLE_UCTAGENT_H
+#ifndef KSAMPLE_SMARTCOMPOUNDWL_UCTMAXCHILDAGENT_H
+#define KSAMPLE_SMARTCOMPOUNDWL_UCTMAXCHILDAGENT_H
 
 #include "search_tools/Search.h"
+#include "search_tools/SearchStats.h"
+#include "search_tools/HeuristicCache.h"
 
 #include "../Agents.h"
+#include "../HeuristicCombinators.h"
 
 namespace Agents
 {
@@ -20,9 +23,15 @@ namespace Agents
         // weight between component compound heuristics;
         double alpha;
 
+        // alpha * CureGoalConditionswStation + (1-alpha) * SmartLossProximity, fused, as a concrete type (see HeuristicCombinators.h)
+        Heuristics::SmartCompound heuristic;
+
         // Search tree to use on each step.
         Search::GameTree* search_tree = nullptr;
 
+        // Timing and size of each search (see SearchStats.h)
+        Search::SearchStats search_stats;
+
         // Maximum depth the search tree reached
         std::vector<int> tree_depths ={};
 
@@ -40,6 +49,16 @@ namespace Agents
         std::vector<double> chosen_visits_minus_avg = {};
     public:
         std::string name = "-Determinization A-star UCT Agent with (# cured diseases/4)+.15* (max fraction of cards held toward curing uncured disease)  + reward for station tangency value rollouts.";
+
+        // Which search tree to build and how (K determinizations with no memory cap by default, see Search::TreeOptions)
+        Search::TreeOptions tree_options;
+
+        // How many heuristic evaluations to spend taking the expectation over the infect draws at a chance leaf (see Search::expected_heuristic())
+        // 1 (the default) just evaluates one sampled determinization, as always
+        int infect_outcomes=1;
+
+        // Values of boards already evaluated in this search (see Search::HeuristicCache). Off unless heuristic_cache.enabled is set.
+        Search::HeuristicCache heuristic_cache;
         
         KSample_SmartCompoundWL_UCTMaxChildAgent(GameLogic::Game& _active_game,int n_simulations,int K,double alpha = .5,int VisitConvergenceCriteria=100);
         ~KSample_SmartCompoundWL_UCTMaxChildAgent(){
@@ -10,6 +10,7 @@
 #include "KSample_SmartLossProximity_UCTMaxChildAgent.h"
 
 #include "../search_tools/Search.h"
+#include "../search_tools/ExpectedHeuristic.h"
 
 Agents::KSample_SmartLossProximity_UCTMaxChildAgent::KSample_SmartLossProximity_UCTMaxChildAgent(GameLogic::Game& _active_game, int _n_simulations, int _K,int _VisitConvergenceCriteria):
     BaseAgent(_active_game)
@@ -31,7 +32,11 @@ Actions::Action* Agents::KSample_SmartLossProximity_UCTMaxChildAgent::generate_a
     // Stochasticity is "saved" and revisited again upon every subsequent traversal
     
     // This represents a potential memory leak since without being used in take_step, tree at any existing ptr won't be deleted
-    search_tree = new Search::KDeterminizedGameTree(active_game,K);
+    search_stats.begin_decision();
+    heuristic_cache.new_search();
+    search_tree = Search::make_tree(active_game,K,tree_options);
+    search_tree -> stop_at_chance_leaves = infect_outcomes>1;
+    SEARCH_LAP(search_stats,Search::EXPANSION);
     int sims_done = 0;
 
     int search_depth=0;
@@ -39,11 +44,13 @@ Actions::Action* Agents::KSample_SmartLossProximity_UCTMaxChildAgent::generate_a
     while(sims_done<n_simulations){   
         // Make a copy of the current board state to hand to the tree for consideration
         Board::Board board_copy = active_game.board_copy();
+        SEARCH_LAP(search_stats,Search::STATE_COPY);
 
         // Give the copy state to the tree in order for it to "roll it down" the actions on the tree to end up at a new deterministic node
         // Alter the board_copy in place to end up at a "leaf" board position
         // Return the best node resulting from tree policy
-        Search::Node* best_node = search_tree -> getBestLeaf(board_copy,Search::UCB1Score);
+        Search::Node* best_node = search_tree -> getBestLeaf(board_copy,Search::tree_policy(tree_options));
+        SEARCH_LAP(search_stats,Search::SELECTION);
 
         // Update the tree depth
         if(best_node -> depth > search_depth){
@@ -52,17 +59,27 @@ Actions::Action* Agents::KSample_SmartLossProximity_UCTMaxChildAgent::generate_a
 
         // Straight up evaluate the heuristic of the state
         // loss proximity proportional to "badness": monotonically increasing with outbreaks & disease count
-        double reward = Heuristics::SmartLossProximity(board_copy);
+        double reward;
+        if(infect_outcomes>1 && best_node -> stochastic && !best_node -> terminal){
+            // (a chance leaf: take the expectation over the draws instead)
+            reward = Search::expected_heuristic(board_copy,active_game,[this](Board::Board& board){return heuristic_cache.evaluate(board,Heuristics::SmartLossProximity);},infect_outcomes);
+        } else {
+            reward = heuristic_cache.evaluate(board_copy,Heuristics::SmartLossProximity);
+        }
+        SEARCH_LAP(search_stats,Search::EVALUATION);
 
         // Back up the observed reward
         // (terminal nodes never get value changed on backprop)
         best_node -> backprop(reward);
+        search_tree -> backprop_amaf(best_node,reward);
+        SEARCH_LAP(search_stats,Search::BACKPROP);
         
         // One more simulation succesfully ran
         sims_done++;
     }
 
     Search::Node* chosen_child = get_max_child(search_tree -> root);
+    SEARCH_LAP(search_stats,Search::MAX_CHILD);
 
     tree_depths.push_back(search_depth); // Maximum search depth at this step
     chosen_rewards.push_back((double) chosen_child -> TotalReward / (double) chosen_child -> N_visits); // "Expected Reward"
@@ -74,8 +91,10 @@ Actions::Action* Agents::KSample_SmartLossProximity_UCTMaxChildAgent::generate_a
     Board::Board board_copy = active_game.board_copy();
     state_values.push_back(Heuristics::SmartLossProximity(board_copy));
 
+    search_stats.end_decision(sims_done,search_tree -> memory.peak,search_tree -> average_determinizations());
+
     // After the simulation budget is used up, return the action attached to the most promising child of the root
-    return chosen_child -> get_action();
+    return search_tree -> chosen_action(chosen_child);
 }
 
 Search::Node* Agents::KSample_SmartLossProximity_UCTMaxChildAgent::get_max_child(Search::Node* root){
@@ -169,6 +188,8 @@ void Agents::KSample_SmartLossProximity_UCTMaxChildAgent::take_step(bool verbose
 }
 
 void Agents::KSample_SmartLossProximity_UCTMaxChildAgent::reset(){
+    search_stats.reset();
+    heuristic_cache.reset();
     tree_depths.clear();
     chosen_rewards.clear();
     chosen_confidences.clear();
@@ -177,7 +198,7 @@ void Agents::KSample_SmartLossProximity_UCTMaxChildAgent::reset(){
 }
 
 std::vector<std::string> Agents::KSample_SmartLossProximity_UCTMaxChildAgent::get_keys(){
-    return {
+    std::vector<std::string> keys = {
         "AvgTreeDepth",
         "StdTreeDepth",
         "MaxTreeDepth",
@@ -231,6 +252,14 @@ std::vector<std::string> Agents::KSample_SmartLossProximity_UCTMaxChildAgent::ge
         "Turn85StateEval",
         "Turn90StateEval"
     };
+
+    // Followed by the search timing/size measurements
+    std::vector<std::string> search_keys = search_stats.get_keys();
+    keys.insert(keys.end(),search_keys.begin(),search_keys.end());
+    // and the heuristic cache's
+    std::vector<std::string> cache_keys = heuristic_cache.get_keys();
+    keys.insert(keys.end(),cache_keys.begin(),cache_keys.end());
+    return keys;
 }
 
 std::vector<double> Agents::KSample_SmartLossProximity_UCTMaxChildAgent::get_values(){
@@ -279,7 +308,7 @@ std::vector<double> Agents::KSample_SmartLossProximity_UCTMaxChildAgent::get_val
         visits_minus_avg_mean+= v / (double) chosen_visits_minus_avg.size();
     }
 
-    return {
+    std::vector<double> values = {
         depth_mean, // Average Tree-Search max depth
         depth_std, // Std Tree-search max depth
         (double) *std::max_element(tree_depths.begin(),tree_depths.end()), // Max Tree-search max depth
@@ -332,5 +361,11 @@ std::vector<double> Agents::KSample_SmartLossProximity_UCTMaxChildAgent::get_val
         state_values.size()>=(80+1) ? state_values[80] : -1,
         state_values.size()>=(85+1) ? state_values[85] : -1,
         state_values.size()>=(90+1) ? state_values[90] : -1
-    };  
+    };
+
+    std::vector<double> search_values = search_stats.get_values();
+    values.insert(values.end(),search_values.begin(),search_values.end());
+    std::vector<double> cache_values = heuristic_cache.get_values();
+    values.insert(values.end(),cache_values.begin(),cache_values.end());
+    return values;
 }
\ No newline at end of file
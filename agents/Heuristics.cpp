@@ -100,187 +100,13 @@ double Heuristics::CureGoalConditionswStation(Board::Board& game_board){
     // Each uncured disease gets an additional .05 if a player with ALL the necessary cards is at to a research station, OR
     //      .025 if a player with ALL the necessary cards is _next_ to a research station
 
-
-
     // heuristic ==1 IFF all diseases are cured
     // <1 otherwise.
-    double value = 0;
-
-    double BLUE_closeness=0; // max fraction of blue cards towards cure
-    int BLUE_closest_position = -1; // position of player holding max fraction of blue cards needed
 
-    double YELLOW_closeness=0; // max fraction of yellow cards towards cure
-    int YELLOW_closest_position = -1; // position of player holding max fraction of yellow cards needed
-
-    double BLACK_closeness=0; // max fraction of black cards towards cure
-    int BLACK_closest_position = -1; // position of player holding max fraction of black cards needed
-
-    double RED_closeness=0; // max fraction of red cards towards cure
-    int RED_closest_position = -1; // position of player holding max fraction of red cards needed
-    
-    // Go through each player
-    for(Players::Player& p: game_board.get_players()){
-        // find out how many of each color card they have
-        std::array<int,4> color_count = p.get_color_count();
-        
-        // for each color, define "closeness" as min(1, (# cards of this color)/(# cards required to cure))
-        if(!game_board.is_cured(Map::BLUE)){
-            double pBlue_closeness = std::min((double) color_count[Map::BLUE]/(double) p.role.required_cure_cards,1.);
-            if(pBlue_closeness > BLUE_closeness){
-                BLUE_closeness = pBlue_closeness;
-                BLUE_closest_position = p.get_position();
-            }
-        }
-
-        if(!game_board.is_cured(Map::YELLOW)){
-            double pYellow_closeness = std::min((double) color_count[Map::YELLOW]/(double) p.role.required_cure_cards,1.);
-            if(pYellow_closeness > YELLOW_closeness){
-                YELLOW_closeness = pYellow_closeness;
-                YELLOW_closest_position = p.get_position();
-            }
-        }
-
-        if(!game_board.is_cured(Map::BLACK)){
-            double pBlack_closeness = std::min((double) color_count[Map::BLACK]/(double) p.role.required_cure_cards,1.);
-            if(pBlack_closeness > BLACK_closeness){
-                BLACK_closeness = pBlack_closeness;
-                BLACK_closest_position = p.get_position();
-            }
-        }
-
-        if(!game_board.is_cured(Map::RED)){
-            double pRed_closeness = std::min((double) color_count[Map::RED]/(double) p.role.required_cure_cards,1.);
-            if(pRed_closeness > RED_closeness){
-                RED_closeness = pRed_closeness;
-                RED_closest_position = p.get_position();
-            }
-        }
-    }
-
-    // Add .05 for any disease for which all the cards are there based on whether the player is at/next to a research station
-    if(BLUE_closeness==1){
-        bool reward_claimed=false;
-        for(int  st: game_board.get_stations()){
-            if(BLUE_closest_position==st && !reward_claimed){
-                value+=.05;
-                reward_claimed=true;
-                break;
-            }
-        }
-        if(!reward_claimed){
-            std::vector<int> neighbors = Map::CITY_NEIGHBORS(BLUE_closest_position);
-            for(int& neighbor: neighbors){
-                for(int  st : game_board.get_stations()){
-                    if(st== neighbor && !reward_claimed){
-                        value+=.025;
-                        reward_claimed=true;
-                        break;
-                    }
-                }
-                if(reward_claimed){
-                    break;
-                }
-            }
-        }
-    }
-    if(YELLOW_closeness==1){
-        bool reward_claimed=false;
-        for(int  st: game_board.get_stations()){
-            if(YELLOW_closest_position==st && !reward_claimed){
-                value+=.05;
-                reward_claimed=true;
-                break;
-            }
-        }
-        if(!reward_claimed){
-            std::vector<int> neighbors = Map::CITY_NEIGHBORS(YELLOW_closest_position);
-            for(int& neighbor: neighbors){
-                for(int  st : game_board.get_stations()){
-                    if(st== neighbor && !reward_claimed){
-                        value+=.025;
-                        reward_claimed=true;
-                        break;
-                    }
-                }
-                if(reward_claimed){
-                    break;
-                }
-            }
-        }
-    }
-    if(BLACK_closeness==1){
-        bool reward_claimed=false;
-        for(int  st: game_board.get_stations()){
-            if(BLACK_closest_position==st && !reward_claimed){
-                value+=.05;
-                reward_claimed=true;
-                break;
-            }
-        }
-        if(!reward_claimed){
-            std::vector<int> neighbors = Map::CITY_NEIGHBORS(BLACK_closest_position);
-            for(int& neighbor: neighbors){
-                for(int  st : game_board.get_stations()){
-                    if(st== neighbor && !reward_claimed){
-                        value+=.025;
-                        reward_claimed=true;
-                        break;
-                    }
-                }
-                if(reward_claimed){
-                    break;
-                }
-            }
-        }
-    }
-    if(RED_closeness==1){
-        bool reward_claimed=false;
-        for(int  st: game_board.get_stations()){
-            if(RED_closest_position==st && !reward_claimed){
-                value+=.05;
-                reward_claimed=true;
-                break;
-            }
-        }
-        if(!reward_claimed){
-            std::vector<int> neighbors = Map::CITY_NEIGHBORS(RED_closest_position);
-            for(int& neighbor: neighbors){
-                for(int  st : game_board.get_stations()){
-                    if(st== neighbor && !reward_claimed){
-                        value+=.025;
-                        reward_claimed=true;
-                        break;
-                    }
-                }
-                if(reward_claimed){
-                    break;
-                }
-            }
-        }
-    }
-
-    // Add either .25 or .15*closeness for each disease
-    if(!game_board.is_cured(Map::BLUE)){
-        value+=.15*BLUE_closeness;
-    } else{
-        value+=.25;
-    }
-    if(!game_board.is_cured(Map::YELLOW)){
-        value+=.15*YELLOW_closeness;
-    } else{
-        value+=.25;
-    }
-    if(!game_board.is_cured(Map::BLACK)){
-        value+=.15*BLACK_closeness;
-    } else{
-        value+=.25;
-    }
-    if(!game_board.is_cured(Map::RED)){
-        value+=.15*RED_closeness;
-    } else{
-        value+=.25;
-    }
-    return value;
+    // The cards per color and the cities at/next to a station are all kept by the board and players, so this just reads them (see GetBoardFeatures())
+    Heuristics::BoardFeatures features;
+    GetBoardFeatures(game_board,features);
+    return FeatureCureGoalConditionswStation(features);
 }
 
 double Heuristics::LossProximity(Board::Board& game_board){
@@ -317,115 +143,99 @@ double Heuristics::SmartLossProximity(Board::Board& game_board){
     // Specifically want to fold in the fact that cities with 3 cubes are bad news for the future agent, ever if even a deep planner may not be able to recognize it.
     // This is kind of equivalent to looking at "outbreak preconditions" in the same way that we look at cure preconditions
 
-    // ========= "Badness" associated to cities with 3 disease cubes =========
-    std::array<std::array<int,48>,4> disease_count = game_board.get_disease_count();
+    // Each 3-cube city that could still be drawn again adds 1 to its disease's count, and 6 for a disease is "hella bad" (see FeatureSmartLossProximity())
+    // The board keeps its 3-cube cities per color, so this reads those rather than scanning every city (see GetBoardFeatures())
+    Heuristics::BoardFeatures features;
+    GetBoardFeatures(game_board,features);
+    return FeatureSmartLossProximity(features);
+}
+
+double Heuristics::CompoundHeuristic(Board::Board& game_board,double heuristic1(Board::Board& game_board), double heuristic2(Board::Board& game_board),double alpha){
+    return alpha * heuristic1(game_board) + (1.-alpha)*heuristic2(game_board);
+}
+
+void Heuristics::GetBoardFeatures(Board::Board& game_board,Heuristics::BoardFeatures& features){
+    std::array<int,4> closest_position = {-1,-1,-1,-1};
+    for(int color=0;color<4;color++){
+        features.cured[color] = game_board.is_cured(color);
+        features.closeness[color] = 0;
+        features.station_bonus[color] = 0;
+        features.live_3cube_cities[color] = 0;
+    }
 
-    int BLUE_count = 0;
-    int YELLOW_count = 0;
-    int BLACK_count = 0;
-    int RED_count = 0;
-    for(int city=0;city<48;city++){
-        // For cities where there's 3, check that it's possible it will ever be drawn again
-        if(disease_count[Map::BLUE][city]==3){
-            // if it's not the case that both the city has been drawn already and an epidemic is impossible in the future,
-            if(!(game_board.in_infect_discard(city) && game_board.all_epidemics_drawn())){
-                // Then increment the count
-                BLUE_count+=1;
-                // Then check neighbors to see if there's a nominal risk of chain outbreak
-                for(int neighbor: Map::CITY_NEIGHBORS(city)){
-                    if(disease_count[Map::BLUE][neighbor]==3){
-                        // Idea is that two cities next to eachother -> count = 3 = (1 + .5 + 1 + .5)
-                        // three cities w/ 3 next to eachother - > count = 6 
-                        BLUE_count+=.5;
-                    }
+    // ===== Cards toward each cure =====
+    for(Players::Player& p: game_board.get_players()){
+        std::array<int,4> color_count = p.get_color_count();
+        for(int color=0;color<4;color++){
+            if(!features.cured[color]){
+                double p_closeness = std::min((double) color_count[color]/(double) p.role.required_cure_cards,1.);
+                if(p_closeness > features.closeness[color]){
+                    features.closeness[color] = p_closeness;
+                    closest_position[color] = p.get_position();
                 }
-            } else {
-                BLUE_count+=.5; // same value as 2-cube city
             }
-        } else {
-            // If not 3, we don't care about anything but adding a much smaller quantity to the count
-            BLUE_count+= .25 * disease_count[Map::BLUE][city];
         }
-        // For cities where there's 3, check that it's possible it will ever be drawn again
-        if(disease_count[Map::YELLOW][city]==3){
-            // if it's not the case that both the city has been drawn already and an epidemic is impossible in the future,
-            if(!(game_board.in_infect_discard(city) && game_board.all_epidemics_drawn())){
-                // Then increment the count
-                YELLOW_count+=1;
-                // Then check neighbors to see if there's a nominal risk of chain outbreak
-                for(int neighbor: Map::CITY_NEIGHBORS(city)){
-                    if(disease_count[Map::YELLOW][neighbor]==3){
-                        // Idea is that two cities next to eachother -> count = 3 = (1 + .5 + 1 + .5)
-                        // three cities w/ 3 next to eachother - > count = 6 
-                        YELLOW_count+=.5;
-                    }
-                }
-            } else {
-                YELLOW_count+=.5; // same value as 2-cube city
-            }
-        } else {
-            // If not 3, we don't care about anything but adding a much smaller quantity to the count
-            YELLOW_count+= .25 * disease_count[Map::YELLOW][city];
+    }
+
+    // ===== Whether whoever could cure is at (or next to) a station =====
+    // (the board keeps which cities have, or neighbor, a station - see Board::at_station())
+    for(int color=0;color<4;color++){
+        if(features.closeness[color]==1){
+            features.station_bonus[color] = game_board.at_station(closest_position[color]) ? .05 : (game_board.next_to_station(closest_position[color]) ? .025 : 0.);
         }
+    }
 
-        // For cities where there's 3, check that it's possible it will ever be drawn again
-        if(disease_count[Map::BLACK][city]==3){
-            // if it's not the case that both the city has been drawn already and an epidemic is impossible in the future,
-            if(!(game_board.in_infect_discard(city) && game_board.all_epidemics_drawn())){
-                // Then increment the count
-                BLACK_count+=1;
-                // Then check neighbors to see if there's a nominal risk of chain outbreak
-                for(int neighbor: Map::CITY_NEIGHBORS(city)){
-                    if(disease_count[Map::BLACK][neighbor]==3){
-                        // Idea is that two cities next to eachother -> count = 3 = (1 + .5 + 1 + .5)
-                        // three cities w/ 3 next to eachother - > count = 6 
-                        BLACK_count+=.5;
-                    }
-                }
-            } else {
-                BLACK_count+=.5; // same value as 2-cube city
-            }
+    // ===== Cities with 3 cubes =====
+    // SmartLossProximity() used to scan every city with int counts, so its .5 and .25 increments (for neighbors, dead cities and smaller piles of cubes) were always truncated away.
+    // All that ever counted is each 3-cube city that could still be drawn, which is all that's counted here.
+    // The board keeps the 3-cube cities of each color as a bitmask, so this is a popcount until the last epidemic is drawn.
+    bool all_epidemics_drawn = game_board.all_epidemics_drawn();
+    for(int color=0;color<4;color++){
+        unsigned long long three_cube_cities = game_board.get_3cube_cities(color);
+        if(!all_epidemics_drawn){
+            features.live_3cube_cities[color] = __builtin_popcountll(three_cube_cities);
         } else {
-            // If not 3, we don't care about anything but adding a much smaller quantity to the count
-            BLACK_count+= .25 * disease_count[Map::BLACK][city];
-        }
-        
-        // For cities where there's 3, check that it's possible it will ever be drawn again
-        if(disease_count[Map::RED][city]==3){
-            // if it's not the case that both the city has been drawn already and an epidemic is impossible in the future,
-            if(!(game_board.in_infect_discard(city) && game_board.all_epidemics_drawn())){
-                // Then increment the count
-                RED_count+=1;
-                // Then check neighbors to see if there's a nominal risk of chain outbreak
-                for(int neighbor: Map::CITY_NEIGHBORS(city)){
-                    if(disease_count[Map::RED][neighbor]==3){
-                        // Idea is that two cities next to eachother -> count = 3 = (1 + .5 + 1 + .5)
-                        // three cities w/ 3 next to eachother - > count = 6 
-                        RED_count+=.5;
-                    }
-                }
-            } else {
-                RED_count+=.5; // same value as 2-cube city
+            while(three_cube_cities){
+                int city = __builtin_ctzll(three_cube_cities);
+                features.live_3cube_cities[color]+= !game_board.in_infect_discard(city);
+                three_cube_cities &= three_cube_cities - 1;
             }
+        }
+    }
+}
+
+double Heuristics::FeatureCureGoalConditionswStation(Heuristics::BoardFeatures& features){
+    // Station bonuses first, then .25 or .15*closeness per disease (the order the terms were always added in, so values don't move by a bit)
+    double value = 0;
+    for(int color=0;color<4;color++){
+        value+=features.station_bonus[color];
+    }
+    for(int color=0;color<4;color++){
+        if(!features.cured[color]){
+            value+=.15*features.closeness[color];
         } else {
-            // If not 3, we don't care about anything but adding a much smaller quantity to the count
-            RED_count+= .25 * disease_count[Map::RED][city];
+            value+=.25;
         }
     }
+    return value;
+}
+
+double Heuristics::FeatureSmartLossProximity(Heuristics::BoardFeatures& features){
     // Divide by 6 = value when 3 cities w/ 3 are all next to eachother 
     // (it can be worse than that, but rarely, and this would make it be appropriately hella bad anyway)
     // This means that badness for any one disease can be MORE than 1. I'm counting on the fact that this being the case for one disease would make it *not* the case for others, which is true in a vanilla game
-    // 
-    double BLUE_3cube_badness = BLUE_count/6.;
-    double YELLOW_3cube_badness = YELLOW_count/6.;
-    double BLACK_3cube_badness = BLACK_count/6.;
-    double RED_3cube_badness = RED_count/6.;
+    double BLUE_3cube_badness = features.live_3cube_cities[Map::BLUE]/6.;
+    double YELLOW_3cube_badness = features.live_3cube_cities[Map::YELLOW]/6.;
+    double BLACK_3cube_badness = features.live_3cube_cities[Map::BLACK]/6.;
+    double RED_3cube_badness = features.live_3cube_cities[Map::RED]/6.;
 
     // I normalize the sum by 2 rather than 4 since I want to stretch typical values to span more of [0,1], and I feel like typically on average they're already < 1/2 each
     // Max with 0 *just in case*, since losing (score = 0 ) should NEVER be a more attractive option than a bad board state.
     return std::max(1. - (BLUE_3cube_badness + YELLOW_3cube_badness + BLACK_3cube_badness + RED_3cube_badness)/2.,0.);
 }
 
-double Heuristics::CompoundHeuristic(Board::Board& game_board,double heuristic1(Board::Board& game_board), double heuristic2(Board::Board& game_board),double alpha){
-    return alpha * heuristic1(game_board) + (1.-alpha)*heuristic2(game_board);
-}
\ No newline at end of file
+double Heuristics::SmartCompoundHeuristic(Board::Board& game_board,double alpha){
+    Heuristics::BoardFeatures features;
+    GetBoardFeatures(game_board,features);
+    return alpha * FeatureCureGoalConditionswStation(features) + (1.-alpha)*FeatureSmartLossProximity(features);
+}
@@ -42,6 +42,26 @@ namespace Heuristics
     // Compound heuristic putting together heuristics in the form
     // alpha * heuristic1 + (1-alpha) * heuristic2 (alpha = .5 by default)
     double CompoundHeuristic(Board::Board& game_board,double heuristic1(Board::Board& game_board), double heuristic2(Board::Board& game_board),double alpha=.5);
+
+    // Everything CureGoalConditionswStation and SmartLossProximity need to know about a board, per disease (see GetBoardFeatures())
+    struct BoardFeatures{
+        std::array<bool,4> cured;
+        // max over players of min(1, (# cards of this color)/(# needed to cure)), 0 if cured
+        std::array<double,4> closeness;
+        // .05 if the closest player holds every card needed and is at a research station, .025 if next to one, 0 otherwise
+        std::array<double,4> station_bonus;
+        // cities with 3 cubes of this disease that could still be drawn again
+        std::array<int,4> live_3cube_cities;
+    };
+    // Reads the counts the board and players keep up to date as they change (cards per color, 3-cube cities, station neighborhoods), so there's no scan over cities or hands
+    void GetBoardFeatures(Board::Board& game_board,BoardFeatures& features);
+
+    // The two heuristics, from features instead of the board
+    double FeatureCureGoalConditionswStation(BoardFeatures& features);
+    double FeatureSmartLossProximity(BoardFeatures& features);
+
+    // Exactly (bit for bit) CompoundHeuristic(game_board,CureGoalConditionswStation,SmartLossProximity,alpha), but reading the board's features once instead of twice
+    double SmartCompoundHeuristic(Board::Board& game_board,double alpha=.5);
 }
 
 #endif
\ No newline at end of file
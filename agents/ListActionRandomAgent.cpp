@@ -3,6 +3,7 @@
 #include "../game_files/GameLogic.h"
 #include "../game_files/Actions.h"
 #include "../game_files/Debug.h"
+#include "../game_files/Random.h"
 
 #include "ListActionRandomAgent.h"
 #include "Agents.h"
@@ -14,7 +15,7 @@ Agents::ListActionRandomAgent::ListActionRandomAgent(GameLogic::Game& _active_ga
 
 Actions::Action* Agents::ListActionRandomAgent::generate_action(bool verbose){
     std::vector<Actions::Action*> action_list = active_game.list_actions(verbose);
-    Actions::Action* chosen_action = action_list[rand() % action_list.size()];
+    Actions::Action* chosen_action = action_list[Random::search_rand() % action_list.size()];
     return chosen_action;
 }
 
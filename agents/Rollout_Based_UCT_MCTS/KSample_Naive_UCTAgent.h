@@ -1,7 +1,8 @@
-#ifndef KSAMPLE_UCTAGENT_H
-#define KSAMPLE_UCTAGENT_H
+#ifndef KSAMPLE_NAIVE_UCTAGENT_H
+#define KSAMPLE_NAIVE_UCTAGENT_H
 
 #include "search_tools/Search.h"
+#include "search_tools/SearchStats.h"
 
 #include "../Agents.h"
 
@@ -17,6 +18,9 @@ namespace Agents
         // Search tree to use on each step.
         Search::GameTree* search_tree = nullptr;
 
+        // Timing and size of each search (see SearchStats.h)
+        Search::SearchStats search_stats;
+
         // Maximum depth the search tree reached
         std::vector<int> tree_depths ={};
 
@@ -34,6 +38,9 @@ namespace Agents
         std::vector<double> chosen_visits_minus_avg = {};
     public:
         std::string name = "-Determinization UCT Agent with 0/1 value rollouts.";
+
+        // Which search tree to build and how (K determinizations with no memory cap by default, see Search::TreeOptions)
+        Search::TreeOptions tree_options;
         
         KSample_Naive_UCTAgent(GameLogic::Game& _active_game,int n_simulations,int K);
         ~KSample_Naive_UCTAgent(){
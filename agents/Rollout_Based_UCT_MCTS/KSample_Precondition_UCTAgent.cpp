@@ -30,7 +30,9 @@ Actions::Action* Agents::KSample_Precondition_UCTAgent::generate_action(bool ver
     // Stochasticity is "saved" and revisited again upon every subsequent traversal
     
     // This represents a potential memory leak since without being used in take_step, tree at any existing ptr won't be deleted
-    search_tree = new Search::KDeterminizedGameTree(active_game,K);
+    search_stats.begin_decision();
+    search_tree = Search::make_tree(active_game,K,tree_options);
+    SEARCH_LAP(search_stats,Search::EXPANSION);
     int sims_done = 0;
 
     int search_depth=0;
@@ -38,11 +40,13 @@ Actions::Action* Agents::KSample_Precondition_UCTAgent::generate_action(bool ver
     while(sims_done<n_simulations){   
         // Make a copy of the current board state to hand to the tree for consideration
         Board::Board board_copy = active_game.board_copy();
+        SEARCH_LAP(search_stats,Search::STATE_COPY);
 
         // Give the copy state to the tree in order for it to "roll it down" the actions on the tree to end up at a new deterministic node
         // Alter the board_copy in place to end up at a "leaf" board position
         // Return the best node resulting from tree policy
-        Search::Node* best_node = search_tree -> getBestLeaf(board_copy,Search::UCB1Score);
+        Search::Node* best_node = search_tree -> getBestLeaf(board_copy,Search::tree_policy(tree_options));
+        SEARCH_LAP(search_stats,Search::SELECTION);
 
         // Update the tree depth
         if(best_node -> depth > search_depth){
@@ -51,17 +55,21 @@ Actions::Action* Agents::KSample_Precondition_UCTAgent::generate_action(bool ver
 
         // Roll out the copy of the state
         // Use the "CureGoalConditions": What fraction of 4 diseases are cured at rollout end, PLUS maximum fraction of satisfied preconditions to cure actions among players
-        double reward = active_game.rollout(board_copy,Heuristics::CureGoalConditionswStation);
+        double reward = active_game.rollout(board_copy,Heuristics::CureGoalConditionswStation,search_tree -> rollout_record());
+        SEARCH_LAP(search_stats,Search::ROLLOUT);
 
         // Back up the observed reward
         // Deterministic nodes along the way have board_state set to nullptr
         best_node -> backprop(reward);
+        search_tree -> backprop_amaf(best_node,reward);
+        SEARCH_LAP(search_stats,Search::BACKPROP);
         
         // One more simulation succesfully ran
         sims_done++;
     }
 
     Search::Node* chosen_child = search_tree -> bestRootChild(Search::UCB1Score);
+    SEARCH_LAP(search_stats,Search::MAX_CHILD);
 
     tree_depths.push_back(search_depth); // Maximum search depth at this step
     chosen_rewards.push_back((double) chosen_child -> TotalReward / (double) chosen_child -> N_visits); // "Expected Reward"
@@ -71,8 +79,10 @@ Actions::Action* Agents::KSample_Precondition_UCTAgent::generate_action(bool ver
             (double) chosen_child -> N_visits) - ((double) n_simulations/(double)chosen_child -> parent -> n_children()) 
         )/ (double) n_simulations); // Fraction of all simulations spent on this choice compared to a child explored an "average" amount. Neg -> This was chosen after other heavily explored options ruled out. Pos -> This was chosen after thorough exploration. ~0 -> Most likely no good reason to choose this vs. other children.
     state_values.push_back(search_tree -> root -> TotalReward / (double) search_tree -> root -> N_visits); // push back the root value average reward
+    search_stats.end_decision(sims_done,search_tree -> memory.peak,search_tree -> average_determinizations());
+
     // After the simulation budget is used up, return the action attached to the most promising child of the root
-    return chosen_child -> get_action();
+    return search_tree -> chosen_action(chosen_child);
 }
 
 void Agents::KSample_Precondition_UCTAgent::take_step(bool verbose){
@@ -89,6 +99,7 @@ void Agents::KSample_Precondition_UCTAgent::take_step(bool verbose){
 }
 
 void Agents::KSample_Precondition_UCTAgent::reset(){
+    search_stats.reset();
     tree_depths.clear();
     chosen_rewards.clear();
     chosen_confidences.clear();
@@ -97,7 +108,7 @@ void Agents::KSample_Precondition_UCTAgent::reset(){
 }
 
 std::vector<std::string> Agents::KSample_Precondition_UCTAgent::get_keys(){
-    return {
+    std::vector<std::string> keys = {
         "AvgTreeDepth",
         "StdTreeDepth",
         "MaxTreeDepth",
@@ -151,6 +162,11 @@ std::vector<std::string> Agents::KSample_Precondition_UCTAgent::get_keys(){
         "Turn85StateEval",
         "Turn90StateEval"
     };
+
+    // Followed by the search timing/size measurements
+    std::vector<std::string> search_keys = search_stats.get_keys();
+    keys.insert(keys.end(),search_keys.begin(),search_keys.end());
+    return keys;
 }
 
 std::vector<double> Agents::KSample_Precondition_UCTAgent::get_values(){
@@ -199,7 +215,7 @@ std::vector<double> Agents::KSample_Precondition_UCTAgent::get_values(){
         visits_minus_avg_mean+= v / (double) chosen_visits_minus_avg.size();
     }
 
-    return {
+    std::vector<double> values = {
         depth_mean, // Average Tree-Search max depth
         depth_std, // Std Tree-search max depth
         (double) *std::max_element(tree_depths.begin(),tree_depths.end()), // Max Tree-search max depth
@@ -252,5 +268,9 @@ std::vector<double> Agents::KSample_Precondition_UCTAgent::get_values(){
         state_values.size()>=(80+1) ? state_values[80] : -1,
         state_values.size()>=(85+1) ? state_values[85] : -1,
         state_values.size()>=(90+1) ? state_values[90] : -1
-    };  
+    };
+
+    std::vector<double> search_values = search_stats.get_values();
+    values.insert(values.end(),search_values.begin(),search_values.end());
+    return values;
 }
\ No newline at end of file
@@ -1,9 +1,11 @@
-#ifndef KSAMPLE_UCTAGENT_H
-#define KSAMPLE_UCTAGENT_H
+#ifndef KSAMPLE_PRECONDITION_UCTMAXCHILDAGENT_SMARTROLLOUT_H
+#define KSAMPLE_PRECONDITION_UCTMAXCHILDAGENT_SMARTROLLOUT_H
 
 #include "search_tools/Search.h"
+#include "search_tools/SearchStats.h"
 
 #include "../Agents.h"
+#include "../HeuristicCombinators.h"
 
 namespace Agents
 {
@@ -20,9 +22,17 @@ namespace Agents
         // Epsilon = probability with which rollouts will select a non-maximizing versus maximizing action
         double epsilon;
 
+        // Rollout policy: pick successors by the (2/3) - (1/3) weighted compound heuristic, evaluate the end state by cure preconditions
+        // (concrete types so the rollout is compiled around them, see HeuristicCombinators.h)
+        Heuristics::SmartCompound selection_heuristic{2./3.};
+        Heuristics::Fn<Heuristics::CureGoalConditionswStation> eval_heuristic;
+
         // Search tree to use on each step.
         Search::GameTree* search_tree = nullptr;
 
+        // Timing and size of each search (see SearchStats.h)
+        Search::SearchStats search_stats;
+
         // Maximum depth the search tree reached
         std::vector<int> tree_depths ={};
 
@@ -40,6 +50,9 @@ namespace Agents
         std::vector<double> chosen_visits_minus_avg = {};
     public:
         std::string name = "-Determinization UCT Agent with `SmartCompound` heavy rollouts and Cure Precondition state evaluations.";
+
+        // Which search tree to build and how (K determinizations with no memory cap by default, see Search::TreeOptions)
+        Search::TreeOptions tree_options;
         
         KSample_Precondition_UCTMaxChildAgent_SmartRollout(GameLogic::Game& _active_game,int n_simulations,int K,double epsilon,int VisitConvergenceCriteria=100);
         ~KSample_Precondition_UCTMaxChildAgent_SmartRollout(){
@@ -1,7 +1,8 @@
-#ifndef KSAMPLE_UCTAGENT_H
-#define KSAMPLE_UCTAGENT_H
+#ifndef KSAMPLE_SUBGOAL_UCTAGENT_H
+#define KSAMPLE_SUBGOAL_UCTAGENT_H
 
 #include "search_tools/Search.h"
+#include "search_tools/SearchStats.h"
 
 #include "../Agents.h"
 
@@ -17,6 +18,9 @@ namespace Agents
         // Search tree to use on each step.
         Search::GameTree* search_tree = nullptr;
 
+        // Timing and size of each search (see SearchStats.h)
+        Search::SearchStats search_stats;
+
         // Vectors to keep for measurement
         //      (one entry per agent decision)
         //      (To be reset beginning of each game, and measured at the end)
@@ -38,6 +42,9 @@ namespace Agents
         std::vector<double> chosen_visits_minus_avg = {};
     public:
         std::string name = "-Determinization UCT Agent with (# cured diseases/4) value rollouts.";
+
+        // Which search tree to build and how (K determinizations with no memory cap by default, see Search::TreeOptions)
+        Search::TreeOptions tree_options;
         
         KSample_Subgoal_UCTAgent(GameLogic::Game& _active_game,int n_simulations,int K);
         ~KSample_Subgoal_UCTAgent(){
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "../../game_files/Board.h"
+#include "../../game_files/GameLogic.h"
+#include "../../game_files/StochasticActions.h"
+#include "../../game_files/Random.h"
+
+#include "ExpectedHeuristic.h"
+
+double Search::expected_heuristic(Board::Board& game_board,GameLogic::Game& game_logic,std::function<double(Board::Board&)> heuristic,int outcome_budget){
+    // Sample the player card draws (player draw phase = turn action 4)
+    while(game_logic.is_stochastic(game_board) && game_board.get_turn_action()==4){
+        game_logic.resolve_stochastic_action(game_board);
+    }
+    // A forced discard, a loss, or the next player's turn
+    if(!game_logic.is_stochastic(game_board)){
+        return heuristic(game_board);
+    }
+
+    // Otherwise we're in the middle of the infect draws
+    std::vector<StochasticActions::ChanceOutcome> outcomes = {};
+    game_logic.stochastic_outcomes(game_board,outcomes);
+    if(outcomes.empty()){
+        return heuristic(game_board);
+    }
+
+    // Which outcomes to look at: all of them if the budget allows, else a uniformly random subset of `budget` of them
+    int n_outcomes = outcomes.size();
+    int n_searched = std::min(n_outcomes,std::max(outcome_budget,1));
+    for(int i=0;i<n_searched && n_searched<n_outcomes;i++){
+        std::swap(outcomes[i],outcomes[i + Random::search_rand() % (n_outcomes-i)]);
+    }
+    int child_budget = std::max(outcome_budget/n_searched,1);
+
+    double expectation = 0;
+    double probability_searched = 0;
+    for(int i=0;i<n_searched;i++){
+        Board::Board outcome_board = game_board;
+        outcomes[i].action -> execute(outcome_board);
+        expectation+= outcomes[i].probability*expected_heuristic(outcome_board,game_logic,heuristic,child_budget);
+        probability_searched+= outcomes[i].probability;
+    }
+
+    for(StochasticActions::ChanceOutcome& outcome: outcomes){
+        delete outcome.action;
+    }
+    // (the probabilities of a subset are renormalized)
+    return expectation/probability_searched;
+}
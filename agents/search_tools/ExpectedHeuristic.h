@@ -0,0 +1,25 @@
+#ifndef EXPECTEDHEURISTIC_H
+#define EXPECTEDHEURISTIC_H
+
+#include <functional>
+
+#include "../../game_files/Board.h"
+#include "../../game_files/GameLogic.h"
+
+namespace Search
+{
+    // Heuristic-eval agents normally evaluate one sampled determinization of the draws at the end of a turn.
+    // Most of what those draws do to a heuristic (especially the loss proximities) comes from which cities are infected,
+    // and those come uniformly out of the top group of the infect deck - so this takes the expectation over them instead.
+    //
+    // Called on a stochastic board (e.g. a chance leaf from a tree with stop_at_chance_leaves):
+    //      - player card draws are still sampled, in place, just like the tree would
+    //      - the infect draws that follow are enumerated exactly, each weighted by its probability, as long as that takes no more than
+    //        `outcome_budget` heuristic evaluations. Past that, a random subset of the outcomes at a draw is averaged
+    //        (still unbiased, since infect outcomes are equally likely) with the budget split between them.
+    // outcome_budget = 1 is the same as sampling one determinization. On a non-stochastic board this is just heuristic(game_board).
+    // `game_board` is left somewhere along the way, so hand in a copy you don't need anymore.
+    double expected_heuristic(Board::Board& game_board,GameLogic::Game& game_logic,std::function<double(Board::Board&)> heuristic,int outcome_budget);
+}
+
+#endif
@@ -1,9 +1,12 @@
 #include "Hashes.h"
 
+#include <array>
+
 #include <boost/container_hash/hash.hpp>
 
 #include "../../game_files/Board.h"
 #include "../../game_files/Decks.h"
+#include "../../game_files/Map.h"
 #include "../../game_files/Players.h"
 
 using namespace std;
@@ -35,6 +38,61 @@ size_t Hashes::boardHash(Board::Board& board){
     return seed;
 }
 
+size_t Hashes::heuristicHash(Board::Board& board){
+    // Everything small is packed into a few 64-bit words first, and only those are combined:
+    // this gets called on every leaf, and a hash_combine per field cost about as much as the heuristics themselves.
+    unsigned long long status = (unsigned long long) board.has_won()
+        | (unsigned long long) board.has_lost() << 1
+        | (unsigned long long) board.is_cured(Map::BLUE) << 2
+        | (unsigned long long) board.is_cured(Map::YELLOW) << 3
+        | (unsigned long long) board.is_cured(Map::BLACK) << 4
+        | (unsigned long long) board.is_cured(Map::RED) << 5
+        | (unsigned long long) (board.get_outbreak_count() & 0xF) << 6
+        | (unsigned long long) (board.get_epidemic_count() & 0xF) << 10;
+    std::array<int,4>& cubes = board.get_color_count();
+    for(int color=0;color<4;color++){
+        status |= (unsigned long long) (cubes[color] & 0x3F) << (14 + 6*color);
+    }
+
+    // Each player's position (6 bits) and cards per color (4 bits each)
+    unsigned long long positions = 0;
+    unsigned long long hands = 0;
+    int shift = 0;
+    for(Players::Player& p: board.get_players()){
+        positions = positions << 6 | (unsigned long long) (p.get_position() & 0x3F);
+        std::array<int,4> color_count = p.get_color_count();
+        for(int color=0;color<4;color++){
+            hands |= (unsigned long long) (color_count[color] & 0xF) << (shift % 64);
+            shift+=4;
+        }
+    }
+    status |= positions << 38;
+
+    size_t seed = 0;
+    boost::hash_combine(seed,status);
+    boost::hash_combine(seed,hands);
+    boost::hash_combine(seed,board.get_station_cities());
+
+    bool all_epidemics_drawn = board.all_epidemics_drawn();
+    for(int color=0;color<4;color++){
+        unsigned long long three_cube_cities = board.get_3cube_cities(color);
+        boost::hash_combine(seed,three_cube_cities);
+        if(all_epidemics_drawn && three_cube_cities){
+            // (only then do heuristics care which of them are in the discard)
+            unsigned long long discarded = 0;
+            while(three_cube_cities){
+                int city = __builtin_ctzll(three_cube_cities);
+                if(board.in_infect_discard(city)){
+                    discarded |= 1ULL << city;
+                }
+                three_cube_cities &= three_cube_cities - 1;
+            }
+            boost::hash_combine(seed,discarded);
+        }
+    }
+    return seed;
+}
+
 size_t Hashes::playerHash(const std::vector<Players::Player>& players){
     size_t out = 0;
     for(Players::Player p: players){
@@ -10,6 +10,13 @@ namespace Hashes
     // Hash the board, which requires...
     size_t boardHash(Board::Board& board);
 
+    // Hash of everything the heuristics in Heuristics.cpp read from a board, and nothing else (see Search::HeuristicCache):
+    // win/loss, cures, outbreaks, epidemics, cubes per color, 3-cube cities (and which are in the infect discard once that matters),
+    // stations, and each player's position and cards per color.
+    // Mostly the counts the board keeps up to date, so it's O(players) rather than a pass over the cities.
+    // A heuristic that reads anything else from the board needs it added here before it's cached.
+    size_t heuristicHash(Board::Board& board);
+
     // a hash of the 
     size_t playerHash(const std::vector<Players::Player>& players);
 
@@ -0,0 +1,68 @@
+#include <algorithm>
+
+#include "HeuristicCache.h"
+
+namespace
+{
+    // Seconds one timed interval reads even when nothing happens in it (one steady_clock::now() call, more or less).
+    // The intervals being timed are tens of nanoseconds, so this has to come off them.
+    double clock_overhead(){
+        static const double overhead = [](){
+            const int READS = 1000;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for(int read=0;read<READS;read++){
+                std::chrono::steady_clock::now();
+            }
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()/(double) READS;
+        }();
+        return overhead;
+    }
+}
+
+Search::HeuristicCache::HeuristicCache(int log2_slots){
+    resize(log2_slots);
+}
+
+void Search::HeuristicCache::resize(int log2_slots){
+    table.assign((size_t) 1 << log2_slots,Entry());
+    slot_mask = table.size() - 1;
+}
+
+void Search::HeuristicCache::new_search(){
+    search++;
+    if(search==0){
+        // Wrapped around (after ~4 billion searches): the stamps can't tell old slots apart anymore, so actually clear them
+        table.assign(table.size(),Entry());
+        search = 1;
+    }
+}
+
+void Search::HeuristicCache::reset(){
+    lookups = 0;
+    hits = 0;
+    timed_lookups = 0;
+    timed_lookup_seconds = 0;
+    timed_evaluations = 0;
+    timed_evaluation_seconds = 0;
+}
+
+std::vector<std::string> Search::HeuristicCache::get_keys(){
+    return {
+        "HeuristicCacheHitRate",
+        "HeuristicCacheSecondsSaved"
+    };
+}
+
+std::vector<double> Search::HeuristicCache::get_values(){
+    if(!enabled){
+        return {-1,-1};
+    }
+    double hit_rate = lookups>0 ? (double) hits/(double) lookups : 0;
+
+    // Every hit skipped an average evaluation, and every lookup paid for a hash and a probe
+    double seconds_per_evaluation = timed_evaluations>0 ? std::max(timed_evaluation_seconds/(double) timed_evaluations - clock_overhead(),0.) : 0;
+    double seconds_per_lookup = timed_lookups>0 ? std::max(timed_lookup_seconds/(double) timed_lookups - clock_overhead(),0.) : 0;
+    double seconds_saved = (double) hits*seconds_per_evaluation - (double) lookups*seconds_per_lookup;
+
+    return {hit_rate,seconds_saved};
+}
@@ -0,0 +1,108 @@
+#ifndef HEURISTICCACHE_H
+#define HEURISTICCACHE_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "../../game_files/Board.h"
+
+#include "Hashes.h"
+
+namespace Search
+{
+    // Heuristic values of boards already evaluated during this search, keyed by Hashes::heuristicHash().
+    //
+    // Heuristic-eval agents reach the same board over and over: revisited leaves, the same actions in a different order,
+    // and determinizations that happen to draw the same cards. This remembers what those evaluated to.
+    //      - Direct-mapped: each board hash has one slot, and a new board landing on an occupied slot just replaces it (lossy, but bounded)
+    //      - One per agent, shared by the whole search. new_search() forgets everything in O(1), since slots are stamped with the search they came from
+    //      - Reports its hit rate and (an estimate of) the time it saved as agent measurements
+    //
+    // A hit returns exactly what the heuristic returned for a board with the same hash. Two different boards colliding on all 64 bits would get each other's value.
+    class HeuristicCache{
+        struct Entry{
+            size_t key = 0;
+            unsigned int search = 0; // which search stored it (0 = never)
+            double value = 0;
+        };
+        std::vector<Entry> table;
+        size_t slot_mask = 0;
+        unsigned int search = 1;
+
+        // Over the game so far
+        long lookups = 0;
+        long hits = 0;
+
+        // Timing is sampled (1 in TIMING_PERIOD lookups) so the clock reads don't cost more than the heuristics do
+        static const long TIMING_PERIOD = 16;
+        long timed_lookups = 0;
+        double timed_lookup_seconds = 0; // hashing + probing, on every timed lookup
+        long timed_evaluations = 0;
+        double timed_evaluation_seconds = 0; // the heuristic itself, on timed misses
+    public:
+        // Off just evaluates the heuristic every time.
+        // Off by default: about half of leaf evaluations hit, but the heuristics here now cost about what hashing the board does (~50ns),
+        // so it only pays for itself with an expensive heuristic. HeuristicCacheSecondsSaved says whether it did.
+        bool enabled = false;
+
+        // 2^log2_slots slots of 24 bytes each
+        HeuristicCache(int log2_slots=16);
+        void resize(int log2_slots);
+
+        // Forget every stored value (call at the start of each search)
+        void new_search();
+
+        // heuristic(game_board), from the cache if this board was already evaluated this search
+        template<class Heuristic>
+        double evaluate(Board::Board& game_board,Heuristic heuristic);
+
+        // Forget the measurements from the last game
+        void reset();
+
+        //      HeuristicCacheHitRate       hits/lookups over the game (-1 when disabled)
+        //      HeuristicCacheSecondsSaved  estimated heuristic time saved by hits, minus the time spent hashing and probing on every lookup (-1 when disabled)
+        std::vector<std::string> get_keys();
+        std::vector<double> get_values();
+    };
+}
+
+template<class Heuristic>
+double Search::HeuristicCache::evaluate(Board::Board& game_board,Heuristic heuristic){
+    if(!enabled){
+        return heuristic(game_board);
+    }
+    bool timed = (lookups % TIMING_PERIOD)==0;
+    lookups++;
+    std::chrono::steady_clock::time_point start;
+    if(timed){
+        start = std::chrono::steady_clock::now();
+    }
+
+    size_t key = Hashes::heuristicHash(game_board);
+    Entry& entry = table[key & slot_mask];
+    bool hit = entry.search==search && entry.key==key;
+
+    std::chrono::steady_clock::time_point probed;
+    if(timed){
+        probed = std::chrono::steady_clock::now();
+        timed_lookups++;
+        timed_lookup_seconds+= std::chrono::duration<double>(probed - start).count();
+    }
+    if(hit){
+        hits++;
+        return entry.value;
+    }
+
+    double value = heuristic(game_board);
+    if(timed){
+        timed_evaluations++;
+        timed_evaluation_seconds+= std::chrono::duration<double>(std::chrono::steady_clock::now() - probed).count();
+    }
+    entry.key = key;
+    entry.search = search;
+    entry.value = value;
+    return value;
+}
+
+#endif
@@ -1,10 +1,101 @@
+#include <algorithm>
 #include <cmath>
+#include <functional>
+#include <map>
 
 #include "Search.h"
+#include "SearchStats.h"
 
 #include "../game_files/Actions.h"
 #include "../game_files/GameLogic.h"
 #include "../game_files/Board.h"
+#include "../game_files/Random.h"
+
+namespace
+{
+    // Estimated heap bytes of one action (vtable pointer, a movetype string and a few ints, plus allocator overhead)
+    // and of one sampled card draw (which also carries its own string representation)
+    const long ACTION_BYTES = 64;
+    const long CHANCE_ACTION_BYTES = 96;
+
+    // The root of an open-loop tree, on the game's current board
+    Search::Node* open_loop_root(GameLogic::Game& game_logic){
+        Board::Board state = game_logic.board_copy();
+        return new Search::OpenLoopNode(nullptr,nullptr,&state,game_logic,true);
+    }
+
+    // Estimated heap bytes of an untried or chosen action of `node` (a turn plan holds several)
+    long action_bytes(Search::Node* node,Actions::Action* action){
+        if(node -> macro){
+            return ACTION_BYTES*(1 + (long) static_cast<Search::TurnPlan*>(action) -> actions.size());
+        }
+        return ACTION_BYTES;
+    }
+
+    // Average reward seen through a node (a terminal node's is its fixed score)
+    double average_reward(Search::Node* node){
+        return node -> terminal ? node -> score : node -> TotalReward/(double) node -> N_visits;
+    }
+
+    // A node's average reward, blended with its AMAF average if it has one (see Search::RaveOptions)
+    double blended_average(Search::Node* node){
+        double average = node -> TotalReward/(double) node -> N_visits;
+        if(!node -> rave || node -> AMAF_visits==0){
+            return average;
+        }
+        double visits = (double) node -> N_visits;
+        double amaf_visits = (double) node -> AMAF_visits;
+
+        // How much to go by the AMAF average instead of the node's own (1 with no visits of its own, towards 0 with many)
+        double beta;
+        if(node -> rave -> schedule==Search::MINIMUM_MSE){
+            double bias = node -> rave -> bias;
+            beta = amaf_visits/(visits + amaf_visits + 4*bias*bias*visits*amaf_visits);
+        } else {
+            double k = node -> rave -> equivalence;
+            beta = std::pow(k/(3*visits + k),.5);
+        }
+        return (1-beta)*average + beta*node -> AMAF_reward/amaf_visits;
+    }
+
+    // Prior weight of each kind of action (see Search::action_prior())
+    const std::map<std::string,double> MOVETYPE_PRIORS = {
+        {"CURE",50.},
+        {"GIVE",4.},
+        {"TAKE",4.},
+        {"BUILD",3.},
+        {"MOVE",2.},
+        {"SHUTTLEFLIGHT",1.5},
+        {"DIRECTFLIGHT",1.},
+        {"FORCEDDISCARD",1.},
+        {"CHARTERFLIGHT",.5},
+        {"OPERATIONSEXPERTFLIGHT",.5},
+        {"AIRLIFT",.25},
+        {"GOVERNMENTGRANT",.25},
+        {"QUIETNIGHT",.25},
+        {"DONOTHING",.1}
+    };
+
+    // Post-order (children before parents) list of every node below `node` that could be collapsed
+    void collect_collapsible(Search::Node* node,std::vector<Search::Node*>& collapsible){
+        for(int child_num=0;child_num<node -> n_children();child_num++){
+            Search::Node* child = node -> getChild(child_num);
+            if(child){
+                collect_collapsible(child,collapsible);
+            }
+        }
+        if(node -> collapsible()){
+            collapsible.push_back(node);
+        }
+    }
+}
+
+void Search::TreeMemory::add(long delta){
+    bytes+=delta;
+    if(bytes>peak){
+        peak=bytes;
+    }
+}
 
 double Search::UCB1Score(Search::Node* node){
     // Take a node and number of simulations performed so far by this agent in considering the curreng game state
@@ -27,10 +118,66 @@ double Search::UCB1Score(Search::Node* node){
     return value;
 }
 
+double Search::RAVEScore(Search::Node* node){
+    if(!node -> rave || node -> AMAF_visits==0){
+        return Search::UCB1Score(node);
+    }
+    // The blended average takes the place of the plain one, and the exploration term is UCB1's
+    return Search::UCB1Score(node) - node -> TotalReward/(double) node -> N_visits + blended_average(node);
+}
+
+double Search::PUCTScore(Search::Node* node){
+    // (outcomes of a stochastic node have no prior)
+    if(!node -> widening || !node -> parent || node -> parent -> stochastic){
+        return Search::RAVEScore(node);
+    }
+    // Q + c * P * sqrt(# parent visits)/(1 + # child visits)
+    double exploration = node -> widening -> puct * node -> prior * std::pow((double) node -> parent -> N_visits,.5)/(1. + (double) node -> N_visits);
+    return blended_average(node) + exploration;
+}
+
+Search::ScoreFunction* Search::tree_policy(Search::TreeOptions& options){
+    if(options.widening.enabled){
+        return Search::PUCTScore;
+    } else if(options.rave.enabled){
+        return Search::RAVEScore;
+    }
+    return Search::UCB1Score;
+}
+
+double Search::action_prior(Actions::Action* action,Board::Board& game_board){
+    if(action -> movetype=="PLAN"){
+        // (a plan was already valued by where it ends up; the floor keeps a hopeless plan admissible)
+        return static_cast<Search::TurnPlan*>(action) -> value + .01;
+    }
+    std::map<std::string,double>::const_iterator found = MOVETYPE_PRIORS.find(action -> movetype);
+    double weight = found!=MOVETYPE_PRIORS.end() ? found -> second : 1.;
+    if(action -> movetype=="TREAT"){
+        // (which color isn't visible from here, so go by the most cubes of any color in the city)
+        int position = game_board.active_player().get_position();
+        int cubes = 0;
+        for(int color=0;color<4;color++){
+            cubes = std::max(cubes,game_board.get_disease_count()[color][position]);
+        }
+        weight = 1. + (double) cubes;
+    }
+    return weight;
+}
+
 Search::Node::Node(Node* _parent,Actions::Action* _action){
     parent = _parent;
     action = _action;
 
+    if(parent){
+        memory = parent -> memory;
+        rave = parent -> rave;
+        widening = parent -> widening;
+        macro = parent -> macro;
+    }
+
+    // (for nodes-per-decision in SearchStats)
+    Search::count_node();
+
     // increment stochasticities traversed if you came from a stochastic parent
     if(parent){
         if(parent -> stochastic){
@@ -41,8 +188,26 @@ Search::Node::Node(Node* _parent,Actions::Action* _action){
     }
 }
 
+Search::Node::~Node(){
+    // (derived destructors have already deleted - and so un-charged - every child)
+    if(memory){
+        memory -> add(-bytes_charged);
+    }
+}
+
+void Search::Node::recharge(){
+    if(memory){
+        long now = footprint();
+        memory -> add(now-bytes_charged);
+        bytes_charged = now;
+    }
+}
+
 Search::DeterministicNode::DeterministicNode(Search::Node* _parent,Actions::Action* _action, Board::Board* _board_state,GameLogic::Game& game_logic):
     Node(_parent,_action){
+    // Building a node (mostly list_actions()) is the expansion phase of search
+    SEARCH_EXPANSION_TIMER;
+
     // An instantiated node is always labeled with terminal = true if the state to which it's associated is terminal
     if(game_logic.is_terminal(*_board_state)){
         terminal = true;
@@ -50,9 +215,14 @@ Search::DeterministicNode::DeterministicNode(Search::Node* _parent,Actions::Acti
 
         // set the score here to 0/1. Tree evaluation should *always* see the true reward of a terminal state added into the tree
         score= (double) game_logic.reward(*_board_state);
+    } else if(macro){
+        // Sampling turn plans costs a lot more than listing actions, and most new nodes are leaves that are never visited again,
+        // so this node starts out as if it had been collapsed: its plans get sampled on its first expansion
+        terminal=false;
+        collapsed=true;
     } else {
         terminal=false;
-        action_queue = game_logic.list_actions(*_board_state);
+        queue_actions(*_board_state,game_logic);
     }
 
     if(parent){
@@ -65,6 +235,8 @@ Search::DeterministicNode::DeterministicNode(Search::Node* _parent,Actions::Acti
 
     // Always initialize empty children on a deterministic new node
     children = {};
+
+    recharge();
 }
 
 void Search::DeterministicNode::set_score(double score_fn(Search::Node*)){
@@ -112,8 +284,16 @@ Search::Node* Search::DeterministicNode::get_parent(){
 
 Search::Node* Search::DeterministicNode::best_child(Board::Board& state,GameLogic::Game& game_logic,double score_fn(Search::Node*)){
     if(!terminal){
-        if(action_queue.empty()){
-            // If there are no untried actions, always return the best child as per score that's been being updated
+        if(collapsed){
+            // This node's subtree was thrown away to save memory: list the actions again and regrow it from scratch
+            // (its own visits and reward are kept, so its parent's scores don't change)
+            SEARCH_EXPANSION_TIMER;
+            queue_actions(state,game_logic);
+            collapsed = false;
+            recharge();
+        }
+        if(!widens()){
+            // If there are no untried actions (or none admitted yet), always return the best child as per score that's been being updated
             
             // Necessary to check scores by force though
             // I do a by-force max check rather than sorting the vector because it's costly
@@ -137,12 +317,19 @@ Search::Node* Search::DeterministicNode::best_child(Board::Board& state,GameLogi
         } else {
             // Otherwise pull an action out of the stack
             Actions::Action* new_action = action_queue.back();
+            double new_action_prior = action_priors.empty() ? 0 : action_priors.back();
+
+            // (its key has to be taken before it's executed)
+            size_t new_action_key = rave ? Actions::action_key(new_action,state) : 0;
             
             // alter the state in place
             new_action -> execute(state); 
 
             // Delete the action from the stack
             action_queue.pop_back();
+            if(!action_priors.empty()){
+                action_priors.pop_back();
+            }
 
             // And define a new node with this action
             Search::Node* new_node;
@@ -153,8 +340,11 @@ Search::Node* Search::DeterministicNode::best_child(Board::Board& state,GameLogi
                 // deterministic nodes that need player choice
                 new_node = new Search::DeterministicNode(this,new_action,&state,game_logic); 
             }
+            new_node -> action_key = new_action_key;
+            new_node -> prior = new_action_prior;
             // And insert it into children for later
             children.push_back(new_node);
+            recharge();
 
             // And return it as the "best child"
             return new_node;
@@ -164,6 +354,50 @@ Search::Node* Search::DeterministicNode::best_child(Board::Board& state,GameLogi
     return nullptr;
 }
 
+void Search::DeterministicNode::queue_actions(Board::Board& state,GameLogic::Game& game_logic){
+    for(Actions::Action* action: action_queue){
+        delete action;
+    }
+    action_queue = macro ? Search::list_turn_plans(state,game_logic,*macro) : game_logic.list_actions(state);
+    if(widening){
+        rank_actions(state);
+    }
+}
+
+void Search::DeterministicNode::rank_actions(Board::Board& state){
+    // Shuffled first, so that actions with the same prior (e.g. all the moves) are admitted in random order rather than listing order
+    for(int action_num=(int) action_queue.size()-1;action_num>0;action_num--){
+        std::swap(action_queue[action_num],action_queue[Random::search_rand() % (action_num+1)]);
+    }
+    std::vector<std::pair<double,Actions::Action*>> ranked = {};
+    double total = 0;
+    for(Actions::Action* action: action_queue){
+        double weight = Search::action_prior(action,state);
+        ranked.push_back({weight,action});
+        total+=weight;
+    }
+    // Lowest first, so the best is at the back
+    std::stable_sort(ranked.begin(),ranked.end(),[](const std::pair<double,Actions::Action*>& a,const std::pair<double,Actions::Action*>& b){
+        return a.first < b.first;
+    });
+    action_priors.clear();
+    for(int action_num=0;action_num<ranked.size();action_num++){
+        action_queue[action_num] = ranked[action_num].second;
+        action_priors.push_back(ranked[action_num].first/total);
+    }
+}
+
+bool Search::DeterministicNode::widens(){
+    if(action_queue.empty()){
+        return false;
+    }
+    if(!widening){
+        return true;
+    }
+    double admitted = std::ceil(widening -> coefficient * std::pow((double) N_visits,widening -> exponent));
+    return (double) children.size() < std::max(admitted,1.);
+}
+
 void Search::DeterministicNode::addChild(Board::Board& game_board, Actions::Action* action,GameLogic::Game& game_logic){};
 
 void Search::DeterministicNode::addNullChild(){};
@@ -171,7 +405,49 @@ void Search::DeterministicNode::addNullChild(){};
 Search::Node* Search::DeterministicNode::getChild(int child){return children[child];};
 
 bool Search::DeterministicNode::converged(int num_visits){
-    return N_visits>=num_visits && action_queue.empty();
+    // (a collapsed node has no children to max over)
+    // Under progressive widening, the untried actions are ones it hasn't admitted yet, so maxing over the children it has is the best it can do
+    return N_visits>=num_visits && !collapsed && (action_queue.empty() || (widening && !children.empty()));
+}
+
+long Search::DeterministicNode::footprint(){
+    long bytes = sizeof(Search::DeterministicNode);
+    bytes+= (action_queue.capacity()+children.capacity())*sizeof(void*);
+    bytes+= action_priors.capacity()*sizeof(double);
+    for(Actions::Action* queued: action_queue){
+        bytes+= action_bytes(this,queued);
+    }
+    // The action that led here is owned by this node if it was a player's choice (sampled card draws belong to the tree)
+    if(action && parent && !parent -> stochastic){
+        bytes+= action_bytes(this,action);
+    }
+    return bytes;
+}
+
+bool Search::DeterministicNode::would_expand(int child){
+    return !terminal && (collapsed || widens());
+}
+
+bool Search::DeterministicNode::collapsible(){
+    return parent && !terminal && !collapsed && (!children.empty() || !action_queue.empty());
+}
+
+void Search::DeterministicNode::collapse(){
+    while(!action_queue.empty()){
+        delete action_queue.back();
+        action_queue.pop_back();
+    }
+    while(!children.empty()){
+        delete children.back();
+        children.pop_back();
+    }
+    // Give the vectors' storage back too
+    std::vector<Actions::Action*>().swap(action_queue);
+    std::vector<double>().swap(action_priors);
+    std::vector<Search::Node*>().swap(children);
+
+    collapsed = true;
+    recharge();
 }
 
 void Search::DeterministicNode::setChild(int child,Actions::Action* _action, Board::Board* _board_state,GameLogic::Game& game_logic){};
@@ -182,6 +458,8 @@ int Search::StochasticNode::n_children(){
 
 Search::StochasticNode::StochasticNode(Search::Node* _parent,Actions::Action* _action, Board::Board* _board_state,GameLogic::Game& game_logic):
     Node(_parent,_action){
+        SEARCH_EXPANSION_TIMER;
+
         stochastic = true;
 
         if(game_logic.is_terminal(*_board_state)){
@@ -204,6 +482,8 @@ Search::StochasticNode::StochasticNode(Search::Node* _parent,Actions::Action* _a
         // I'm choosing to implement stochastic nodes with no children on the constructor. 
         // It's up to the tree that's using such nodes to decide what to do with them.
         children = {};
+
+        recharge();
     }
 
 Search::Node* Search::StochasticNode::best_child(Board::Board& state,GameLogic::Game& game_logic,double score_fn(Search::Node*)){
@@ -213,7 +493,7 @@ Search::Node* Search::StochasticNode::best_child(Board::Board& state,GameLogic::
         if(!children.empty()){
 
             // Pick a random successor
-            Search::Node* best_child = children[rand() % children.size()];
+            Search::Node* best_child = children[Random::search_rand() % children.size()];
 
             // Apply its action to the given state
             best_child -> get_action() -> execute(state);
@@ -250,7 +530,47 @@ Search::Node* Search::StochasticNode::get_parent(){
 
 bool Search::StochasticNode::converged(int num_visits){
     // Idea: Only say it's converged if N_visits>=num_visits AND all children exist (all determinizations used)
-    return N_visits>=num_visits;
+    // (a collapsed node has no successors to average over, and neither does a chance leaf that's only been evaluated in expectation)
+    return N_visits>=num_visits && !collapsed && !children.empty();
+}
+
+long Search::StochasticNode::footprint(){
+    long bytes = sizeof(Search::StochasticNode);
+    bytes+= children.capacity()*sizeof(void*);
+    if(action && !parent -> stochastic){
+        bytes+= action_bytes(this,action);
+    }
+    return bytes;
+}
+
+bool Search::StochasticNode::would_expand(int child){
+    return !terminal && (children.empty() || !children[parent -> stochastic ? 0 : child]);
+}
+
+bool Search::StochasticNode::collapsible(){
+    // Only the first stochastic node after a choice: the rest of its chain of draws goes with it
+    // (nodes inside a chain are expected to always lead on to the chain's deterministic end)
+    if(!parent || parent -> stochastic || terminal || collapsed){
+        return false;
+    }
+    for(Search::Node* child: children){
+        if(child){
+            return true;
+        }
+    }
+    return false;
+}
+
+void Search::StochasticNode::collapse(){
+    // Empty every determinization slot; the tree fills them back in (from the same sampled draws) on later visits
+    for(int child=0;child<children.size();child++){
+        if(children[child]){
+            delete children[child];
+            children[child] = nullptr;
+        }
+    }
+    collapsed = true;
+    recharge();
 }
 
 void Search::StochasticNode::set_score(double score_fn(Search::Node*)){
@@ -283,10 +603,12 @@ void Search::StochasticNode::addChild(Board::Board& game_board, Actions::Action*
     } else {
         children.push_back(new DeterministicNode(this,_action,&game_board,game_logic));
     }
+    recharge();
 }
 
 void Search::StochasticNode::addNullChild(){
     children.push_back(nullptr);
+    recharge();
 }
 
 Search::Node* Search::StochasticNode::getChild(int child){
@@ -301,19 +623,343 @@ void Search::StochasticNode::setChild(int child,Actions::Action* _action, Board:
     } else {
         children[child] = new Search::DeterministicNode(this,_action,_board_state,game_logic);
     }
+    collapsed = false;
+}
+
+Search::OpenLoopNode::OpenLoopNode(Search::Node* _parent,Actions::Action* _action, Board::Board* _board_state,GameLogic::Game& game_logic,bool _fixed_state):
+    Node(_parent,_action){
+    SEARCH_EXPANSION_TIMER;
+
+    stochastic = false;
+    fixed_state = _fixed_state;
+
+    // (terminal is decided by the tree on each traversal, since the same choices can end the game on one set of draws and not another)
+    if(fixed_state && !game_logic.is_terminal(*_board_state)){
+        action_queue = game_logic.list_actions(*_board_state);
+    } else {
+        action_queue = {};
+    }
+
+    depth = parent ? parent -> depth+1 : 0;
+
+    children = {};
+    child_keys = {};
+
+    recharge();
+}
+
+Search::Node* Search::OpenLoopNode::add_open_loop_child(Actions::Action* new_action,size_t key,Board::Board& state,GameLogic::Game& game_logic){
+    // The child's board stays the same from one traversal to the next only if this one's does, and no card is drawn on the way
+    Search::Node* new_node = new Search::OpenLoopNode(this,new_action,&state,game_logic,fixed_state && !game_logic.is_stochastic(state));
+    children.push_back(new_node);
+    child_keys.push_back(key);
+    collapsed = false;
+    recharge();
+    return new_node;
 }
 
+Search::Node* Search::OpenLoopNode::best_child(Board::Board& state,GameLogic::Game& game_logic,double score_fn(Search::Node*)){
+    return best_child(state,game_logic,score_fn,true);
+}
+
+Search::Node* Search::OpenLoopNode::best_child(Board::Board& state,GameLogic::Game& game_logic,double score_fn(Search::Node*),bool allow_expansion){
+    if(fixed_state){
+        // Same board as always: this works just like a DeterministicNode
+        if(collapsed){
+            SEARCH_EXPANSION_TIMER;
+            action_queue = game_logic.list_actions(state);
+            collapsed = false;
+            recharge();
+        }
+        while(!action_queue.empty() && allow_expansion){
+            Actions::Action* new_action = action_queue.back();
+            action_queue.pop_back();
+            // (the key has to be taken before it's executed, the same as for the actions it's looked up with)
+            size_t key = Actions::action_key(new_action,state);
+            if(std::find(child_keys.begin(),child_keys.end(),key)!=child_keys.end()){
+                // Another copy of a choice that's already a child (e.g. from two of the same card in a hand)
+                delete new_action;
+                continue;
+            }
+            new_action -> execute(state);
+            return add_open_loop_child(new_action,key,state,game_logic);
+        }
+        double best_score=-1;
+        Search::Node* best_child = nullptr;
+        for(Search::Node* child: children){
+            double this_score = child -> update(score_fn);
+            if(this_score > best_score){
+                best_score = this_score;
+                best_child = child;
+            }
+        }
+        if(best_child){
+            best_child -> get_action() -> execute(state);
+        }
+        return best_child;
+    }
+
+    // Otherwise the board depends on this traversal's draws: see which children are legal on it, and whether anything legal hasn't been tried yet
+    std::vector<Actions::Action*> legal_actions;
+    {
+        SEARCH_EXPANSION_TIMER;
+        legal_actions = game_logic.list_actions(state);
+    }
+    std::vector<int> matching_child(legal_actions.size(),-1);
+    std::vector<size_t> keys(legal_actions.size());
+    int untried = -1;
+    for(int action_num=0;action_num<legal_actions.size();action_num++){
+        keys[action_num] = Actions::action_key(legal_actions[action_num],state);
+        for(int child_num=0;child_num<child_keys.size();child_num++){
+            if(child_keys[child_num]==keys[action_num]){
+                matching_child[action_num] = child_num;
+                break;
+            }
+        }
+        if(matching_child[action_num]<0){
+            // (the last untried one, like popping the back of an action queue)
+            untried = action_num;
+        }
+    }
+
+    Search::Node* chosen_child = nullptr;
+    if(untried>=0 && allow_expansion){
+        legal_actions[untried] -> execute(state);
+        chosen_child = add_open_loop_child(legal_actions[untried],keys[untried],state,game_logic);
+        // (the new child owns its action now)
+        legal_actions[untried] = nullptr;
+    } else {
+        double best_score=-1;
+        int best_action = -1;
+        for(int action_num=0;action_num<legal_actions.size();action_num++){
+            if(matching_child[action_num]<0){
+                continue;
+            }
+            double this_score = children[matching_child[action_num]] -> update(score_fn);
+            if(this_score > best_score){
+                best_score = this_score;
+                best_action = action_num;
+            }
+        }
+        if(best_action>=0){
+            // Execute the action that was just listed for this board, not the one stored on the child (which may have been listed for a different board)
+            legal_actions[best_action] -> execute(state);
+            chosen_child = children[matching_child[best_action]];
+        }
+    }
+    for(Actions::Action* action: legal_actions){
+        if(action){
+            delete action;
+        }
+    }
+    return chosen_child;
+}
+
+Search::Node* Search::OpenLoopNode::get_parent(){
+    return parent;
+}
+
+void Search::OpenLoopNode::set_score(double score_fn(Search::Node*)){
+    score = std::min(score_fn(this),1.);
+}
+
+double Search::OpenLoopNode::update(double score_fn(Search::Node*)){
+    set_score(score_fn);
+    return score;
+}
+
+void Search::OpenLoopNode::backprop(double reward){
+    // A board that ended the game on this traversal counts its true reward (and might not end it on the next one)
+    double value = terminal ? score : reward;
+    terminal = false;
+    TotalReward+=value;
+    N_visits+=1;
+    if(parent){
+        parent -> backprop(value);
+    }
+}
+
+Actions::Action* Search::OpenLoopNode::get_action(){
+    return action;
+}
+
+int Search::OpenLoopNode::n_children(){
+    return children.size();
+}
+
+long Search::OpenLoopNode::footprint(){
+    long bytes = sizeof(Search::OpenLoopNode);
+    bytes+= (action_queue.capacity()+children.capacity())*sizeof(void*);
+    bytes+= child_keys.capacity()*sizeof(size_t);
+    bytes+= action_queue.size()*ACTION_BYTES;
+    if(action){
+        bytes+= ACTION_BYTES;
+    }
+    return bytes;
+}
+
+bool Search::OpenLoopNode::would_expand(int child){
+    // (below a draw there's no telling without listing this traversal's actions)
+    return !fixed_state || collapsed || !action_queue.empty();
+}
+
+bool Search::OpenLoopNode::collapsible(){
+    return parent && !collapsed && (!children.empty() || !action_queue.empty());
+}
+
+void Search::OpenLoopNode::collapse(){
+    while(!action_queue.empty()){
+        delete action_queue.back();
+        action_queue.pop_back();
+    }
+    while(!children.empty()){
+        delete children.back();
+        children.pop_back();
+    }
+    std::vector<Actions::Action*>().swap(action_queue);
+    std::vector<Search::Node*>().swap(children);
+    std::vector<size_t>().swap(child_keys);
+
+    collapsed = true;
+    recharge();
+}
+
+bool Search::OpenLoopNode::converged(int num_visits){
+    // Below a draw, not every child is available on every traversal, so maxing over them would credit each with the draws that suited it.
+    // Those nodes are only ever judged by their own average.
+    return fixed_state && N_visits>=num_visits && action_queue.empty() && !collapsed && !children.empty();
+}
+
+void Search::OpenLoopNode::addChild(Board::Board& game_board,Actions::Action* action,GameLogic::Game& game_logic){};
+
+void Search::OpenLoopNode::addNullChild(){};
+
+Search::Node* Search::OpenLoopNode::getChild(int child){return children[child];};
+
+size_t Search::OpenLoopNode::getChildKey(int child){return child_keys[child];};
+
+void Search::OpenLoopNode::setChild(int child,Actions::Action* _action, Board::Board* _board_state,GameLogic::Game& game_logic){};
+
 Search::GameTree::GameTree(GameLogic::Game& _game_logic): game_logic(_game_logic){
     // Get a copy of the board under consideration
     Board::Board state = game_logic.board_copy();
 
     // A game tree is only ever instantiated for an agent at a decision point (so deterministic node)
     root = new Search::DeterministicNode(nullptr,nullptr,&state,game_logic);
+
+    // Everything below the root inherits this
+    root -> memory = &memory;
+    root -> recharge();
+}
+
+Search::GameTree::GameTree(GameLogic::Game& _game_logic,Search::Node* _root): game_logic(_game_logic){
+    root = _root;
+    root -> memory = &memory;
+    root -> recharge();
+}
+
+void Search::GameTree::set_memory_limit(Search::MemoryLimit _memory_limit){
+    memory_limit = _memory_limit;
+}
+
+void Search::GameTree::set_rave(Search::RaveOptions _rave){
+    rave = _rave;
+    root -> rave = rave.enabled ? &rave : nullptr;
+}
+
+Actions::Action* Search::GameTree::chosen_action(Search::Node* root_child){
+    return root_child -> get_action();
+}
+
+void Search::GameTree::set_widening(Search::ProgressiveWidening _widening){
+    widening = _widening;
+    if(widening.enabled){
+        root -> widening = &widening;
+        Board::Board state = game_logic.board_copy();
+        static_cast<Search::DeterministicNode*>(root) -> rank_actions(state);
+        root -> recharge();
+    }
+}
+
+std::vector<size_t>* Search::GameTree::rollout_record(){
+    return rave.enabled ? &rollout_actions : nullptr;
+}
+
+void Search::GameTree::backprop_amaf(Search::Node* leaf,double reward){
+    if(!rave.enabled){
+        return;
+    }
+    // (backprop() passes a terminal leaf's fixed score up instead of the reward)
+    double value = leaf -> terminal ? leaf -> score : reward;
+
+    // Going up from the leaf, `path_actions` holds every choice made below the current node. Together with the rollout's actions,
+    // those are what was played "later" from that node, and each of its children whose action is among them gets this simulation's AMAF credit.
+    std::sort(rollout_actions.begin(),rollout_actions.end());
+    std::vector<size_t> path_actions = {};
+    for(Search::Node* node=leaf;node -> parent;node=node -> parent){
+        Search::Node* parent = node -> parent;
+        if(parent -> stochastic){
+            // (a card draw, not anyone's choice)
+            continue;
+        }
+        path_actions.push_back(node -> action_key);
+        for(int child_num=0;child_num<parent -> n_children();child_num++){
+            Search::Node* child = parent -> getChild(child_num);
+            bool played = std::find(path_actions.begin(),path_actions.end(),child -> action_key)!=path_actions.end()
+                || std::binary_search(rollout_actions.begin(),rollout_actions.end(),child -> action_key);
+            if(played){
+                child -> AMAF_visits++;
+                child -> AMAF_reward+=value;
+            }
+        }
+    }
+    rollout_actions.clear();
+}
+
+double Search::GameTree::average_determinizations(){
+    if(branched_chance_nodes==0){
+        return -1;
+    }
+    return (double) determinizations/(double) branched_chance_nodes;
+}
+
+bool Search::GameTree::frozen(){
+    return memory_limit.max_bytes>0 && memory_limit.policy==Search::FREEZE && memory.bytes>=memory_limit.max_bytes;
+}
+
+int Search::GameTree::enforce_memory_limit(){
+    if(memory_limit.max_bytes<=0 || memory_limit.policy!=Search::PRUNE || memory.bytes<=memory_limit.max_bytes){
+        return 0;
+    }
+    // Least-visited first. A node never has more visits than its parent, and the stable sort keeps ties in post-order,
+    // so every node comes up before any of its ancestors and nothing is touched after an ancestor's collapse has deleted it.
+    std::vector<Search::Node*> candidates = {};
+    collect_collapsible(root,candidates);
+    std::stable_sort(candidates.begin(),candidates.end(),[](Search::Node* a,Search::Node* b){
+        return a -> N_visits < b -> N_visits;
+    });
+
+    long target = (long) (memory_limit.prune_to*(double) memory_limit.max_bytes);
+    int n_collapsed = 0;
+    for(Search::Node* node: candidates){
+        if(memory.bytes<=target){
+            break;
+        }
+        node -> collapse();
+        n_collapsed++;
+    }
+    return n_collapsed;
 }
 
-Search::KDeterminizedGameTree::KDeterminizedGameTree(GameLogic::Game& _game_logic,int _samples_per_stochasticity):GameTree(_game_logic){
+Search::KDeterminizedGameTree::KDeterminizedGameTree(GameLogic::Game& _game_logic,int _samples_per_stochasticity,Search::AdaptiveDeterminizations _adaptive,Search::DeterminizationSampling _sampling):GameTree(_game_logic){
     samples_per_stochasticity = _samples_per_stochasticity;
-    for(int det=0;det<samples_per_stochasticity;det++){
+    adaptive = _adaptive;
+    sampling = _sampling;
+    adaptive.max_K = std::max(adaptive.max_K,samples_per_stochasticity);
+
+    // (an adaptive tree might need as many as max_K)
+    int n_determinizations = adaptive.enabled ? adaptive.max_K : samples_per_stochasticity;
+    for(int det=0;det<n_determinizations;det++){
         // Initialize the determinization queue with empty determinizations
         determinization_queue.push_back({});
     }
@@ -333,17 +979,36 @@ Search::Node* Search::KDeterminizedGameTree::getBestLeaf(Board::Board& game_boar
     This tree traverses the tree evolving `game_board` in place with actions on traversed nodes.
     */
 
+    // Keep to the memory limit (if there is one) before going any further
+    enforce_memory_limit();
+
+    // Out of memory under the FREEZE policy: this simulation ends at the first node that would have to grow the tree
+    bool freeze = frozen();
+    if(freeze && root -> would_expand(0)){
+        return root;
+    }
+
     // Always start by asking the root for a best child
     // We're assuming this is only ever a deterministic node
     // (this request advances the game_board in place)
     Search::Node* best_choice = root -> best_child(game_board,game_logic,score_fn);
 
     // Choose which determinization we'll use for all the stochasticities in this traversal
-    int determinization = rand() % samples_per_stochasticity;
+    // (at random, or the next one in turn when the determinizations were sampled together)
+    int determinization;
+    if(sampling==Search::INDEPENDENT){
+        determinization = Random::search_rand() % samples_per_stochasticity;
+    } else {
+        determinization = next_determinization;
+        next_determinization = (next_determinization+1) % samples_per_stochasticity;
+    }
 
     // Then traverse the tree until it's forced to instantiate a new node
     // Goal is to end up at the next node thats an unvisited decision node or terminal node
     while(!best_choice -> terminal && (best_choice -> N_visits > 0)){
+        if(freeze && best_choice -> would_expand(determinization)){
+            return best_choice;
+        }
         // If this is a deterministic node
         if(!best_choice -> stochastic){
             // then select the best performing child node
@@ -354,6 +1019,11 @@ Search::Node* Search::KDeterminizedGameTree::getBestLeaf(Board::Board& game_boar
         }
     }
 
+    // A brand new chance node can be handed back as it is, for the agent to take an expectation over
+    if(stop_at_chance_leaves && best_choice -> stochastic && !best_choice -> terminal && best_choice -> n_children()==0){
+        return best_choice;
+    }
+
     // Return either the deterministic node, or the `determinization`th deterministic successor of a deterministic successor
     return GetDeterministicChild(best_choice,game_board,determinization);
 }
@@ -374,11 +1044,29 @@ Actions::Action* Search::KDeterminizedGameTree::GetOrCreateAction(Search::Node*
         new_action =  determinization_queue[determinization][node_for_expansion -> stochasticities_traversed];
         // (k stochasticities have been traversed -> We need to use the (k+1)th to advance to the next node)
         // (and (k+1)th entry = index k)
+
+        // ...unless this branch got to its (k+1)th draw differently than the one that sampled it, and it can't happen here
+        // (e.g. an epidemic upped the infection rate on one branch but not another, so their draws are out of step, or the card's already gone)
+        StochasticActions::DrawAction* draw = dynamic_cast<StochasticActions::DrawAction*>(new_action);
+        if(!draw || !draw -> possible(board_copy)){
+            SEARCH_EXPANSION_TIMER;
+            new_action = game_logic.get_stochastic_action(board_copy);
+            // This one belongs to this branch alone
+            unshared_draws.push_back(new_action);
+            memory.add(CHANCE_ACTION_BYTES+sizeof(Actions::Action*));
+        }
     } else {
         // If there aren't as many as we need, then by construction (since this is a single new node on the tree) we *should* only require one new action
-        new_action = game_logic.get_stochastic_action(board_copy);
+        // (sampling a new determinization counts as expansion)
+        SEARCH_EXPANSION_TIMER;
+        if(sampling==Search::INDEPENDENT){
+            new_action = game_logic.get_stochastic_action(board_copy);
+        } else {
+            new_action = game_logic.stochastic_action_at(board_copy,draw_quantile(determinization,node_for_expansion -> stochasticities_traversed));
+        }
         // We put this new action on the `determinization`th determinization queue
         determinization_queue[determinization].push_back(new_action);
+        memory.add(CHANCE_ACTION_BYTES+sizeof(Actions::Action*));
     }
     return new_action;
 }
@@ -398,8 +1086,16 @@ Search::Node* Search::KDeterminizedGameTree::GetDeterministicChild(Search::Node*
                 for(int _=0;_<samples_per_stochasticity;_++){
                     node -> addNullChild();
                 }
+                branched_chance_nodes++;
+                determinizations+=samples_per_stochasticity;
             }
         }
+        if(!on_chain && adaptive.enabled){
+            // Each branching node picks its own determinization (uniformly over however many it has by now),
+            // and the chain of draws below it follows that one
+            maybe_add_determinization(node);
+            determinization = sampling==Search::INDEPENDENT ? Random::search_rand() % node -> n_children() : node -> N_visits % node -> n_children();
+        }
     }
 
     // If the appropriate child is already defined...
@@ -426,4 +1122,137 @@ Search::Node* Search::KDeterminizedGameTree::GetDeterministicChild(Search::Node*
         // recursively call the function
         return GetDeterministicChild(child,game_board,determinization,true);
     }
-}
\ No newline at end of file
+}
+
+void Search::KDeterminizedGameTree::maybe_add_determinization(Search::Node* node){
+    if(node -> n_children()>=adaptive.max_K){
+        return;
+    }
+    // Only judge once every determinization has been seen enough (and none were thrown away to save memory)
+    double mean = 0;
+    for(int child_num=0;child_num<node -> n_children();child_num++){
+        Search::Node* child = node -> getChild(child_num);
+        if(!child || child -> N_visits<adaptive.min_visits){
+            return;
+        }
+        mean+=average_reward(child)/(double) node -> n_children();
+    }
+    double variance = 0;
+    for(int child_num=0;child_num<node -> n_children();child_num++){
+        double child_mean = average_reward(node -> getChild(child_num));
+        variance+=(child_mean-mean)*(child_mean-mean)/(double) node -> n_children();
+    }
+    // A single determinization has no spread to judge, so it always gets a second look
+    if(node -> n_children()==1 || variance>adaptive.variance_threshold){
+        node -> addNullChild();
+        determinizations++;
+    }
+}
+
+double Search::KDeterminizedGameTree::draw_quantile(int determinization,int draw){
+    int n_determinizations = determinization_queue.size();
+    while(draw_quantiles.size()<=draw){
+        // Every determinization's next draw is placed at once, so between them they cover the whole distribution
+        std::vector<double> quantiles(n_determinizations,0.);
+        if(sampling==Search::ANTITHETIC){
+            for(int det=0;det<n_determinizations;det+=2){
+                quantiles[det] = (double) Random::search_rand()/((double) RAND_MAX+1.);
+                if(det+1<n_determinizations){
+                    quantiles[det+1] = 1.-quantiles[det];
+                }
+            }
+        } else {
+            // One uniform point in each of n_determinizations equal strata, dealt out to the determinizations in random order
+            // (so that under adaptive determinizations, the first few aren't always the low end of the distribution)
+            std::vector<int> strata(n_determinizations);
+            for(int stratum=0;stratum<n_determinizations;stratum++){
+                strata[stratum] = stratum;
+            }
+            for(int stratum=n_determinizations-1;stratum>0;stratum--){
+                std::swap(strata[stratum],strata[Random::search_rand() % (stratum+1)]);
+            }
+            for(int det=0;det<n_determinizations;det++){
+                quantiles[det] = ((double) strata[det] + (double) Random::search_rand()/((double) RAND_MAX+1.))/(double) n_determinizations;
+            }
+        }
+        draw_quantiles.push_back(quantiles);
+        memory.add(n_determinizations*sizeof(double));
+    }
+    return draw_quantiles[draw][determinization];
+}
+
+Search::MacroGameTree::MacroGameTree(GameLogic::Game& _game_logic,int _samples_per_stochasticity,Search::MacroOptions _macro,Search::AdaptiveDeterminizations _adaptive,Search::DeterminizationSampling _sampling):
+    KDeterminizedGameTree(_game_logic,_samples_per_stochasticity,_adaptive,_sampling){
+    macro = _macro;
+    // The root listed single actions when it was made: list plans instead (every node below inherits `macro`)
+    root -> macro = &macro;
+    if(!root -> terminal){
+        Board::Board state = game_logic.board_copy();
+        static_cast<Search::DeterministicNode*>(root) -> queue_actions(state,game_logic);
+        root -> recharge();
+    }
+}
+
+Actions::Action* Search::MacroGameTree::chosen_action(Search::Node* root_child){
+    return static_cast<Search::TurnPlan*>(root_child -> get_action()) -> actions.front();
+}
+
+Search::OpenLoopGameTree::OpenLoopGameTree(GameLogic::Game& _game_logic):GameTree(_game_logic,open_loop_root(_game_logic)){}
+
+void Search::OpenLoopGameTree::sample_draws(Board::Board& game_board){
+    // (nothing keeps these draws, so they're played straight onto the board. If one breaks it, is_terminal() says so)
+    while(!game_logic.is_terminal(game_board) && game_logic.is_stochastic(game_board)){
+        game_logic.resolve_stochastic_action(game_board);
+    }
+}
+
+Search::Node* Search::OpenLoopGameTree::getBestLeaf(Board::Board& game_board,double score_fn(Search::Node*)){
+    enforce_memory_limit();
+
+    // Out of memory under the FREEZE policy: only follow choices that are already in the tree
+    bool freeze = frozen();
+
+    // Follow (or add) a choice at each node, drawing fresh cards after every one that needs them,
+    // until the game ends or a node is seen for the first time
+    Search::Node* node = root;
+    do {
+        if(game_logic.is_terminal(game_board)){
+            break;
+        }
+        Search::Node* child = static_cast<Search::OpenLoopNode*>(node) -> best_child(game_board,game_logic,score_fn,!freeze);
+        if(!child){
+            // (frozen, and nothing tried here before is legal on this board)
+            break;
+        }
+        sample_draws(game_board);
+        node = child;
+    } while(node -> N_visits>0);
+
+    if(game_logic.is_terminal(game_board)){
+        node -> terminal = true;
+        node -> score = (double) game_logic.reward(game_board);
+    }
+    return node;
+}
+
+Search::Node* Search::OpenLoopGameTree::bestRootChild(double score_fn(Search::Node*)){
+    Board::Board state = game_logic.board_copy();
+    return root -> best_child(state,game_logic,score_fn);
+}
+
+Search::GameTree* Search::make_tree(GameLogic::Game& game,int K,Search::TreeOptions options){
+    Search::GameTree* tree;
+    if(options.open_loop){
+        tree = new Search::OpenLoopGameTree(game);
+    } else if(options.macro.enabled){
+        tree = new Search::MacroGameTree(game,K,options.macro,options.adaptive,options.sampling);
+    } else {
+        tree = new Search::KDeterminizedGameTree(game,K,options.adaptive,options.sampling);
+    }
+    tree -> set_memory_limit(options.memory_limit);
+    if(!options.open_loop){
+        tree -> set_rave(options.rave);
+        tree -> set_widening(options.widening);
+    }
+    return tree;
+}
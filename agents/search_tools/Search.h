@@ -2,14 +2,95 @@
 #define SEARCH_H
 
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "../../game_files/Actions.h"
 #include "../../game_files/GameLogic.h"
 #include "../../game_files/Debug.h"
 
+#include "TurnPlans.h"
+
 namespace Search
 {
+    // Estimated heap bytes held by one search tree (nodes, the untried actions they hold, and sampled determinizations), and the most it's held at once.
+    // These are estimates from sizeof() and a fixed per-action size, not allocator counts (see SEARCH_PROFILING in SearchStats.h for those),
+    // but they're cheap enough to always keep and they move with the things that actually grow the tree.
+    class TreeMemory{
+    public:
+        long bytes=0;
+        long peak=0;
+
+        void add(long delta);
+    };
+
+    // What a tree does once its estimated memory reaches `max_bytes`
+    enum MemoryPolicy{
+        PRUNE,  // collapse the least-visited subtrees (keeping their own visit counts and rewards) until back under prune_to*max_bytes
+        FREEZE  // stop growing: each simulation ends at the first node that would need expanding, and is evaluated from there
+    };
+
+    struct MemoryLimit{
+        long max_bytes = 0; // 0 = no limit
+        MemoryPolicy policy = PRUNE;
+        double prune_to = .75;
+    };
+
+    // How a KDeterminizedGameTree picks how many determinizations each chance node gets.
+    // Off, every chance node branches K ways. On, each starts at K and grows one at a time (up to max_K) while its children disagree:
+    // once every child has `min_visits` visits, another determinization is added if the variance of their average rewards is over `variance_threshold`.
+    struct AdaptiveDeterminizations{
+        bool enabled = false;
+        int max_K = 8;
+        double variance_threshold = .002;
+        int min_visits = 5;
+    };
+
+    // How a KDeterminizedGameTree samples the draws of its determinizations.
+    //      INDEPENDENT: every determinization samples every draw on its own, and each simulation follows a determinization picked at random
+    //      STRATIFIED:  the i-th draw of the K determinizations is taken at K quantiles of that draw's outcome distribution (GameLogic::Game::stochastic_action_at()),
+    //                   one from each 1/K-wide stratum, so e.g. an epidemic that's 1/3 likely turns up in about a third of them and an infect group's cards aren't repeated.
+    //                   Each stratum holds the same probability, so equal visits weigh them correctly
+    //      ANTITHETIC:  as above, but determinizations come in pairs at quantiles u and 1-u
+    // Outside of INDEPENDENT, simulations go round-robin over the determinizations instead of picking one at random.
+    enum DeterminizationSampling{
+        INDEPENDENT,
+        STRATIFIED,
+        ANTITHETIC
+    };
+
+    // How much RAVEScore() trusts a child's AMAF average over its own, as a function of its visits N and AMAF visits N~ (beta, from 1 down to 0)
+    //      EQUIVALENCE:  beta = sqrt(k/(3N+k)), so the two count about equally at N = k visits (`equivalence`)
+    //      MINIMUM_MSE:  beta = N~/(N+N~+4b^2 N N~), the weighting that minimizes the squared error if the AMAF average is off by about b (`bias`)
+    enum RaveSchedule{
+        EQUIVALENCE,
+        MINIMUM_MSE
+    };
+
+    // Rapid Action Value Estimation: each node also keeps "all moves as first" (AMAF) statistics, i.e. the rewards of every simulation through its parent
+    // in which its action (by the same player, see Actions::action_key()) was played anywhere later on: further down the tree or in the rollout.
+    // Those come in much faster than the node's own visits, and RAVEScore() leans on them until its own visits are enough.
+    struct RaveOptions{
+        bool enabled = false;
+        RaveSchedule schedule = EQUIVALENCE;
+        double equivalence = 1000;
+        double bias = .1;
+    };
+
+    // Progressive widening of decision nodes, for boards with far more legal actions than a node will see visits (Airlift, OperationsExpertFlight, CharterFlight...).
+    // A node ranks its actions once, when it's created, by a cheap prior (action_prior()), and only its first max(1,ceil(coefficient * N^exponent)) actions
+    // in that order get children, N being the node's visits so far. PUCTScore() then picks among those by Q + puct * P * sqrt(N)/(1+n),
+    // P being the action's share of the node's total prior, and n the child's visits.
+    struct ProgressiveWidening{
+        bool enabled = false;
+        double coefficient = 1;
+        double exponent = .5;
+        double puct = 1;
+    };
+
+    // Unnormalized prior weight of `action` on the board it's about to be executed on: mostly by kind of action (curing first, events and doing nothing last),
+    // plus how many cubes treating would take off. It's only there to order actions for progressive widening, and has to be cheap (no board copies).
+    double action_prior(Actions::Action* action,Board::Board& game_board);
 
     class Node{
 
@@ -18,7 +99,7 @@ namespace Search
 
     public:
         Node(Node* _parent,Actions::Action* _action);
-        virtual ~Node(){};
+        virtual ~Node();
         
         // action applied after parent action in order to derive a new, unique state
         // For deterministic nodes this is clear enough
@@ -31,7 +112,26 @@ namespace Search
 
         int N_visits=0; // # of times tree search has gone through this node
         double TotalReward=0; // Amount of total reward realized on passes through this node during search
-        
+
+        // RAVE statistics (see RaveOptions): simulations through the parent that played this node's action later on, and their total reward
+        int AMAF_visits=0;
+        double AMAF_reward=0;
+
+        // Actions::action_key() of the player choice that led here (0 for card draws, or if the tree doesn't keep RAVE statistics)
+        size_t action_key=0;
+
+        // RAVE settings of the tree this node is in (inherited from the parent; nullptr unless the tree keeps RAVE statistics)
+        const RaveOptions* rave = nullptr;
+
+        // Progressive widening settings of the tree this node is in (inherited from the parent; nullptr unless the tree widens progressively)
+        const ProgressiveWidening* widening = nullptr;
+
+        // Under progressive widening: the action's share of its parent's total action_prior() (0 otherwise)
+        double prior = 0;
+
+        // How the tree this node is in makes turn plans (inherited from the parent; nullptr unless its decision nodes choose whole turns, see MacroGameTree)
+        const MacroOptions* macro = nullptr;
+
         // Number of stochastic traversed from the beginning of the game tree to get to this node
         // This can be used to track the determinizations to apply at a given stochastic node
         int stochasticities_traversed = 0;
@@ -43,6 +143,15 @@ namespace Search
         // parent
         Node* parent = nullptr;
 
+        // Memory accounting of the tree this node is in (inherited from the parent; the tree sets it on the root)
+        TreeMemory* memory = nullptr;
+
+        // Bytes this node last reported to `memory`
+        long bytes_charged = 0;
+
+        // Whether everything below this node has been thrown away to save memory (it grows back on the next visit)
+        bool collapsed=false;
+
         // tree depth (increments only when it's deterministic, or parent is deterministic)
         // (this choice is supposed to induce correspondence to the *theoretical* idea of each choice and chance node individually increasing depth by 1, rather than chance nodes that are part of one resolution of stochasticity each incrementing depth)
         int depth=0;
@@ -66,6 +175,21 @@ namespace Search
 
         virtual int n_children()=0;
 
+        // Estimated bytes held by this node itself (not counting its children)
+        virtual long footprint(){return sizeof(Node);};
+
+        // Report any change in footprint() since the last report to the tree's memory
+        void recharge();
+
+        // Whether visiting this node would construct a new node (`child` = which determinization, for stochastic nodes)
+        virtual bool would_expand(int child){return false;};
+
+        // Whether collapse() would free anything (and is safe: never the root, or a stochastic node inside a chain of draws)
+        virtual bool collapsible(){return false;};
+
+        // Delete everything below this node but keep its own statistics
+        virtual void collapse(){};
+
         // Be able to add a child with an action curated from the outside
         // (for stochastic childclass only)
         virtual void addChild(Board::Board& game_board,Actions::Action* action,GameLogic::Game& game_logic)=0;
@@ -102,8 +226,13 @@ namespace Search
     class DeterministicNode: public Node{
 
         std::vector<Actions::Action*> action_queue; // The actions returned by gamelogic as being applicable in the state attached to this node.
+        // Under progressive widening, action_queue is sorted by prior (best at the back, where actions are taken from) and these are their normalized priors
+        std::vector<double> action_priors;
 
         std::vector<Node*> children;
+
+        // Whether the next visit should add a child (there's an untried action, and progressive widening admits another child at this many visits)
+        bool widens();
     public:
         // Always instantiate for a specific state
         // State should be the state being "rolled down" from the root and accumulating an action.execute() change at each node
@@ -148,11 +277,24 @@ namespace Search
         bool is_stochastic(); // whether the action attached to this node results in a state from which a game-logic stochastic transition is required
 
         // Use the score that' been defined and iterated during tree growth to pull the best child
-        // If action queue isn't empty yet, always return a Node for the new action
+        // If action queue isn't empty yet, always return a Node for the new action (under progressive widening, only while another child is admitted)
         Node* best_child(Board::Board& state,GameLogic::Game& game_logic,double score_fn(Node*));
 
+        // Sort the untried actions by action_prior() on `state` (the board of this node), for progressive widening
+        // (nodes rank their own actions when they're created; this is for a root made before its tree's settings were)
+        void rank_actions(Board::Board& state);
+
+        // List the actions of `state` (the board of this node) into action_queue, replacing any untried ones:
+        // turn plans under `macro`, ranked under progressive widening
+        void queue_actions(Board::Board& state,GameLogic::Game& game_logic);
+
         int n_children();
 
+        long footprint();
+        bool would_expand(int child);
+        bool collapsible();
+        void collapse();
+
         void addChild(Board::Board& game_board,Actions::Action* action,GameLogic::Game& game_logic);
         void addNullChild();
         Node* getChild(int child);
@@ -220,9 +362,81 @@ namespace Search
 
         int n_children();
 
+        long footprint();
+        bool would_expand(int child);
+        bool collapsible();
+        void collapse();
+
+        void addChild(Board::Board& game_board,Actions::Action* action,GameLogic::Game& game_logic);
+        void addNullChild();
+        Node* getChild(int child);
+        void setChild(int child,Actions::Action* _action, Board::Board* _board_state,GameLogic::Game& game_logic);
+
+        bool converged(int num_visits);
+    };
+
+    // A node of an OpenLoopGameTree: it stands for a sequence of player choices from the root, and nothing about the draws in between.
+    // The board it's reached with is whatever the draws of the current traversal made it, so
+    //      - its children are keyed by their action's Actions::action_key(), taken before it's executed: on each visit, only the children whose action is legal on this traversal's board are candidates,
+    //        and the action that's executed is the one just listed for this board (the stored one only names it)
+    //      - `terminal`/`score` describe the board of the current traversal only (set by the tree, cleared again by backprop())
+    //      - until the first draw below the root, the board is the same every time, so a node keeps a queue of untried actions instead of relisting them
+    class OpenLoopNode: public Node{
+        std::vector<Node*> children;
+        // Actions::action_key() of each child's action
+        std::vector<size_t> child_keys;
+
+        // Untried actions, for a node whose board is the same on every traversal
+        std::vector<Actions::Action*> action_queue;
+
+        // Add a child for `new_action`, which has just been executed on `state` (the child owns the action).
+        // `key` is its action_key(), from before it was executed.
+        Node* add_open_loop_child(Actions::Action* new_action,size_t key,Board::Board& state,GameLogic::Game& game_logic);
+    public:
+        // Whether no card has been drawn between the root and this node (so it's always reached with the same board)
+        bool fixed_state;
+
+        OpenLoopNode(Node* _parent,Actions::Action* _action,Board::Board* _board_state,GameLogic::Game& game_logic,bool _fixed_state);
+        ~OpenLoopNode(){
+            // (the root has no action; every other node owns the action that names it)
+            if(action){
+                delete action;
+            }
+            while(!action_queue.empty()){
+                delete action_queue.back();
+                action_queue.pop_back();
+            }
+            while(!children.empty()){
+                delete children.back();
+                children.pop_back();
+            }
+        }
+
+        Node* get_parent();
+
+        void set_score(double score_fn(Node*));
+        double update(double score_fn(Node*));
+
+        void backprop(double reward);
+
+        Actions::Action* get_action();
+
+        // Pick (or add) a child for the board `state`, execute its action on `state` and return it.
+        // Without `allow_expansion` only existing children are considered (nullptr if none of them is legal here).
+        Node* best_child(Board::Board& state,GameLogic::Game& game_logic,double score_fn(Node*));
+        Node* best_child(Board::Board& state,GameLogic::Game& game_logic,double score_fn(Node*),bool allow_expansion);
+
+        int n_children();
+
+        long footprint();
+        bool would_expand(int child);
+        bool collapsible();
+        void collapse();
+
         void addChild(Board::Board& game_board,Actions::Action* action,GameLogic::Game& game_logic);
         void addNullChild();
         Node* getChild(int child);
+        size_t getChildKey(int child); // the key `child` is looked up by
         void setChild(int child,Actions::Action* _action, Board::Board* _board_state,GameLogic::Game& game_logic);
 
         bool converged(int num_visits);
@@ -234,10 +448,58 @@ namespace Search
     class GameTree{
     public:
         GameTree(GameLogic::Game& _game_logic);
+        // (for trees whose root isn't a DeterministicNode)
+        GameTree(GameLogic::Game& _game_logic,Node* _root);
         virtual ~GameTree(){};
         Node* root;
         GameLogic::Game& game_logic; // reference to game logic used by agent
 
+        // Estimated memory held by the tree, and the limit it keeps to (none unless set)
+        TreeMemory memory;
+        MemoryLimit memory_limit;
+
+        void set_memory_limit(MemoryLimit _memory_limit);
+
+        // RAVE statistics the tree keeps (none unless set)
+        RaveOptions rave;
+
+        // How the tree widens its decision nodes (all at once unless set)
+        ProgressiveWidening widening;
+
+        // Start widening progressively (re-ranks the root's untried actions, so call this on a new tree)
+        void set_widening(ProgressiveWidening _widening);
+
+        // Player actions the current simulation's rollout has played so far (see rollout_record())
+        std::vector<size_t> rollout_actions = {};
+
+        // Start keeping RAVE statistics (only nodes added from now on get an action key, so call this on a new tree)
+        void set_rave(RaveOptions _rave);
+
+        // Where a rollout records the Actions::action_key() of each player action it plays, for backprop_amaf() (nullptr unless the tree keeps RAVE statistics)
+        std::vector<size_t>* rollout_record();
+
+        // Update the AMAF statistics along the path from the root to `leaf` with this simulation's reward (after leaf -> backprop()),
+        // then forget the rollout's recorded actions. Does nothing unless the tree keeps RAVE statistics.
+        void backprop_amaf(Node* leaf,double reward);
+
+        // How many ways the tree's chance nodes branched (over every node that branched, ever)
+        long branched_chance_nodes=0;
+        long determinizations=0;
+
+        // Determinizations per branched chance node (-1 if none branched)
+        double average_determinizations();
+
+        // If set, a simulation whose new leaf is a chance node (the draws after a player's last action) stops right there, before any cards are sampled,
+        // so the agent can evaluate the expectation over the draws itself (see ExpectedHeuristic.h). The next visit to that node samples as usual.
+        bool stop_at_chance_leaves=false;
+
+        // Whether the limit has been reached under the FREEZE policy (so nothing new should be added to the tree)
+        bool frozen();
+
+        // Under the PRUNE policy, if over the limit, collapse the least-visited subtrees until back under prune_to*max_bytes.
+        // Returns how many subtrees were collapsed. (Call between simulations, never during one.)
+        int enforce_memory_limit();
+
         // Use scores on existing nodes to get to the "best" leaf
         // (which may be a previously untried action on a "best" distal child)
         // (Equivalent of "TreePolicy" to return a leaf for exploration)
@@ -245,6 +507,9 @@ namespace Search
 
         // Return the best root-child (which has action to take by agent)
         virtual Node* bestRootChild(double score_fn(Node*))=0; 
+
+        // The action for the agent to take, having chosen `root_child` (the child's own action, unless the tree's actions aren't single game actions)
+        virtual Actions::Action* chosen_action(Node* root_child);
     };
 
     // A tree that will sample and track K determinizations lazily upon tree traversal and use one of K at random upon each subsequent traversal
@@ -252,9 +517,17 @@ namespace Search
     // More specifically, will randomly generate K (probably but maybe not different) sequences of card draws, each of which terminates at an agent decision node
     class KDeterminizedGameTree: public GameTree{
         int samples_per_stochasticity=1;
+        AdaptiveDeterminizations adaptive;
+        DeterminizationSampling sampling = INDEPENDENT;
         std::vector<std::vector<Actions::Action*>> determinization_queue = {};
+        // Under STRATIFIED/ANTITHETIC sampling, the quantile each determinization draws its i-th card at (draw_quantiles[i][determinization])
+        std::vector<std::vector<double>> draw_quantiles = {};
+        // Next determinization in the round-robin
+        int next_determinization = 0;
+        // Draws sampled for a branch whose determinization couldn't be replayed on it (see GetOrCreateAction())
+        std::vector<Actions::Action*> unshared_draws = {};
     public:
-        KDeterminizedGameTree(GameLogic::Game& _game_logic, int _samples_per_stochasticity);
+        KDeterminizedGameTree(GameLogic::Game& _game_logic, int _samples_per_stochasticity,AdaptiveDeterminizations _adaptive = {},DeterminizationSampling _sampling = INDEPENDENT);
         ~KDeterminizedGameTree(){
             delete root;
             // Send cascade of deletes down the tree
@@ -265,6 +538,9 @@ namespace Search
                 determinization.clear();
             }
             determinization_queue.clear();
+            for(Actions::Action* action: unshared_draws){
+                delete action;
+            }
         }
         Node* getBestLeaf(Board::Board& game_board,double score_fn(Node*));
 
@@ -276,10 +552,76 @@ namespace Search
 
         // Get the deterministic successor of a stochastic node that resulted from a deterministic action
         Search::Node* GetDeterministicChild(Node* stochastic_node, Board::Board& game_board, int determinization,bool on_chain=false);
+
+        // Under adaptive determinizations: add another determinization to a branching chance node if its children still disagree too much
+        void maybe_add_determinization(Node* stochastic_node);
+
+        // The quantile at which `determinization` takes its `draw`th draw (making the quantiles of that draw for every determinization, if they don't exist yet)
+        double draw_quantile(int determinization,int draw);
     };
 
+    // A KDeterminizedGameTree whose decision nodes choose between whole turn plans (see TurnPlan and list_turn_plans()) rather than single actions,
+    // so a player's turn is one decision instead of four and the tree gets about 4x as deep in turns on the same number of nodes.
+    // The draws between turns are determinized exactly as in a KDeterminizedGameTree.
+    // The price is that a node only ever considers the `macro.width` plans it sampled, not every action sequence.
+    // The agent still plays one action at a time: chosen_action() is the first action of the chosen plan, and the next search plans the rest of the turn again.
+    class MacroGameTree: public KDeterminizedGameTree{
+        MacroOptions macro;
+    public:
+        MacroGameTree(GameLogic::Game& _game_logic,int _samples_per_stochasticity,MacroOptions _macro,AdaptiveDeterminizations _adaptive = {},DeterminizationSampling _sampling = INDEPENDENT);
+
+        Actions::Action* chosen_action(Node* root_child);
+    };
+
+    // An open-loop tree: nodes are sequences of player choices only, and the draws are sampled afresh on every traversal instead of being stored.
+    // (see OpenLoopNode for how a stored choice is checked against each traversal's board)
+    // There are no stochastic nodes or determinization queues, so the tree holds a fraction of what a KDeterminizedGameTree does per simulation.
+    // Its statistics average over draws rather than being split up by them, which is what lets it go deeper on the same budget,
+    // and also what makes it optimistic: a choice below a draw gets credit from the draws where it was best.
+    class OpenLoopGameTree: public GameTree{
+    public:
+        OpenLoopGameTree(GameLogic::Game& _game_logic);
+        ~OpenLoopGameTree(){
+            delete root;
+        }
+        Node* getBestLeaf(Board::Board& game_board,double score_fn(Node*));
+
+        Node* bestRootChild(double score_fn(Node*));
+
+        // Sample every draw (and chance effect) until someone has to make a choice or the game is over
+        void sample_draws(Board::Board& game_board);
+    };
+
+    // Everything about a search tree an agent can configure
+    struct TreeOptions{
+        // OpenLoopGameTree instead of KDeterminizedGameTree (which ignores `adaptive`, `sampling`, `rave`, `widening` and `macro`)
+        bool open_loop = false;
+        // MacroGameTree instead of KDeterminizedGameTree
+        MacroOptions macro;
+        MemoryLimit memory_limit;
+        AdaptiveDeterminizations adaptive;
+        DeterminizationSampling sampling = INDEPENDENT;
+        RaveOptions rave;
+        ProgressiveWidening widening;
+    };
+
+    // A new search tree for the current board of `game` (K = determinizations per stochasticity, for a KDeterminizedGameTree)
+    GameTree* make_tree(GameLogic::Game& game,int K,TreeOptions options);
+
     // UCB1 score
     double UCB1Score(Node* node);
+
+    // UCB1 score with the node's average reward blended with its AMAF average (see RaveOptions and RaveSchedule).
+    // Just UCB1Score() on a node without AMAF statistics.
+    double RAVEScore(Node* node);
+
+    // Prior-weighted PUCT score for progressive widening (see ProgressiveWidening), on the same (RAVE-blended, if kept) average as RAVEScore().
+    // Just RAVEScore() on a node of a tree that doesn't widen progressively.
+    double PUCTScore(Node* node);
+
+    // The score to select children with in a tree built with `options`
+    typedef double ScoreFunction(Node*);
+    ScoreFunction* tree_policy(TreeOptions& options);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#include "SearchStats.h"
+
+namespace
+{
+    thread_local long node_count = 0;
+    thread_local long byte_count = 0;
+
+    // The stats object mid-decision on this thread (for node construction to report expansion time to)
+    thread_local Search::SearchStats* active_stats = nullptr;
+
+    double seconds_since(std::chrono::steady_clock::time_point start){
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count();
+    }
+
+    double mean(std::vector<double>& xs){
+        double total = 0;
+        for(double& x: xs){
+            total+=x;
+        }
+        return xs.empty() ? 0 : total/(double) xs.size();
+    }
+}
+
+#ifdef SEARCH_PROFILING
+// Count every heap allocation made on each thread, so a decision can report how many bytes it asked for.
+// (Only replaced when profiling: it's cheap, but it's still a global change to the binary.)
+void* operator new(std::size_t size){
+    byte_count+= (long) size;
+    void* ptr = std::malloc(size ? size : 1);
+    if(!ptr){
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr,std::size_t size) noexcept{
+    std::free(ptr);
+}
+#endif
+
+void Search::count_node(){
+    node_count++;
+}
+
+long Search::nodes_created(){
+    return node_count;
+}
+
+long Search::bytes_allocated(){
+    return byte_count;
+}
+
+void Search::SearchStats::begin_decision(){
+    decision_start = std::chrono::steady_clock::now();
+    last_lap = decision_start;
+    nested_seconds = 0;
+
+    nodes_at_start = node_count;
+    bytes_at_start = byte_count;
+
+    active_stats = this;
+}
+
+void Search::SearchStats::end_decision(int simulations,long peak_tree_bytes,double average_determinizations){
+    decision_seconds.push_back(seconds_since(decision_start));
+    decision_simulations.push_back((double) simulations);
+    decision_nodes.push_back((double) (node_count - nodes_at_start));
+    decision_bytes.push_back((double) (byte_count - bytes_at_start));
+    if(peak_tree_bytes>=0){
+        decision_tree_bytes.push_back((double) peak_tree_bytes);
+    }
+    if(average_determinizations>=0){
+        decision_determinizations.push_back(average_determinizations);
+    }
+
+    if(active_stats==this){
+        active_stats = nullptr;
+    }
+}
+
+void Search::SearchStats::lap(Search::SearchPhase phase){
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - last_lap;
+
+    // Anything a nested timer already claimed isn't this phase's
+    phase_seconds[phase]+= elapsed.count() - nested_seconds;
+
+    last_lap = now;
+    nested_seconds = 0;
+}
+
+void Search::SearchStats::add_nested(Search::SearchPhase phase,double seconds){
+    phase_seconds[phase]+=seconds;
+    nested_seconds+=seconds;
+}
+
+void Search::SearchStats::reset(){
+    decision_seconds.clear();
+    decision_simulations.clear();
+    decision_nodes.clear();
+    decision_bytes.clear();
+    decision_tree_bytes.clear();
+    decision_determinizations.clear();
+    for(int phase=0;phase<N_SEARCH_PHASES;phase++){
+        phase_seconds[phase] = 0;
+    }
+}
+
+std::vector<std::string> Search::SearchStats::get_keys(){
+    return {
+        "SimsPerSecond",
+        "AvgDecisionSeconds",
+        "AvgNodesPerDecision",
+        "AvgPeakTreeBytes",
+        "MaxPeakTreeBytes",
+        "AvgDeterminizations",
+        "AvgBytesPerDecision",
+        "StateCopySeconds",
+        "SelectionSeconds",
+        "ExpansionSeconds",
+        "RolloutSeconds",
+        "EvaluationSeconds",
+        "BackpropSeconds",
+        "MaxChildSeconds"
+    };
+}
+
+std::vector<double> Search::SearchStats::get_values(){
+    double total_seconds = 0;
+    double total_simulations = 0;
+    for(int decision=0;decision<decision_seconds.size();decision++){
+        total_seconds+=decision_seconds[decision];
+        total_simulations+=decision_simulations[decision];
+    }
+
+    std::vector<double> values = {
+        total_seconds>0 ? total_simulations/total_seconds : 0, // simulations per second over the whole game
+        mean(decision_seconds), // average time per decision
+        mean(decision_nodes), // average nodes constructed per decision
+        decision_tree_bytes.empty() ? -1 : mean(decision_tree_bytes), // the search tree's estimated peak size, on average
+        decision_tree_bytes.empty() ? -1 : *std::max_element(decision_tree_bytes.begin(),decision_tree_bytes.end()), // ...and at its largest
+        decision_determinizations.empty() ? -1 : mean(decision_determinizations) // how many ways the tree's chance nodes branched, on average
+    };
+
+    #ifdef SEARCH_PROFILING
+        values.push_back(mean(decision_bytes));
+        for(int phase=0;phase<N_SEARCH_PHASES;phase++){
+            values.push_back(phase_seconds[phase]);
+        }
+    #else
+        // Not measured without SEARCH_PROFILING
+        for(int value=0;value<1+N_SEARCH_PHASES;value++){
+            values.push_back(-1);
+        }
+    #endif
+
+    return values;
+}
+
+Search::ExpansionTimer::ExpansionTimer(){
+    stats = active_stats;
+    if(stats){
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+Search::ExpansionTimer::~ExpansionTimer(){
+    if(stats){
+        stats -> add_nested(Search::EXPANSION,seconds_since(start));
+    }
+}
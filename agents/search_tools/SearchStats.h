@@ -0,0 +1,98 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Where does a search agent's time actually go?
+//
+// Every UCT agent owns a SearchStats and reports it through get_keys()/get_values() like any of its other measurements.
+//      - Always on (a couple of clock reads per *decision*, and a counter bump per node):
+//          simulations/second, seconds per decision, nodes created per decision, the tree's estimated peak memory per decision,
+//          and how many ways its chance nodes branched on average
+//      - Only with -DSEARCH_PROFILING (e.g. `make runner SEARCH_FLAGS=-DSEARCH_PROFILING`):
+//          seconds spent in each phase of a simulation, and bytes allocated per decision
+//        Without the flag the SEARCH_LAP/SEARCH_EXPANSION_TIMER macros compile to nothing and those values are reported as -1.
+//
+// Phases are timed as "laps": the agent marks the end of each phase of a simulation with SEARCH_LAP(stats,phase),
+// and the time since the previous lap is charged to that phase. Node construction (list_actions() for deterministic nodes)
+// happens inside getBestLeaf(), so it's timed separately by SEARCH_EXPANSION_TIMER in the node constructors and taken out of the selection time.
+namespace Search
+{
+    enum SearchPhase{
+        STATE_COPY, // copying the root board for a simulation
+        SELECTION,  // getBestLeaf() traversal (excluding node construction)
+        EXPANSION,  // node construction (incl. list_actions()) and sampling new determinizations
+        ROLLOUT,    // default policy play-out from the leaf
+        EVALUATION, // heuristic evaluation of the leaf
+        BACKPROP,   // backprop() of the reward
+        MAX_CHILD,  // final root child selection (get_max_child()/bestRootChild())
+        N_SEARCH_PHASES
+    };
+
+    class SearchStats{
+        // Per-decision measurements for the game so far
+        std::vector<double> decision_seconds = {};
+        std::vector<double> decision_simulations = {};
+        std::vector<double> decision_nodes = {};
+        std::vector<double> decision_bytes = {};
+        std::vector<double> decision_tree_bytes = {};
+        std::vector<double> decision_determinizations = {};
+
+        // Total seconds spent in each phase over the game so far
+        double phase_seconds[N_SEARCH_PHASES] = {};
+
+        // The decision in progress
+        std::chrono::steady_clock::time_point decision_start;
+        std::chrono::steady_clock::time_point last_lap;
+        double nested_seconds = 0; // time charged to nested timers (expansion) since the last lap
+        long nodes_at_start = 0;
+        long bytes_at_start = 0;
+    public:
+        // Mark the start/end of one agent decision (one generate_action())
+        // (begin_decision() also makes this the stats object that node construction on this thread reports to)
+        // `peak_tree_bytes` is the search tree's estimated peak memory (Search::TreeMemory), if the agent has one,
+        // and `average_determinizations` its determinizations per branched chance node (GameTree::average_determinizations())
+        void begin_decision();
+        void end_decision(int simulations,long peak_tree_bytes=-1,double average_determinizations=-1);
+
+        // Charge the time since the last lap to `phase`
+        void lap(SearchPhase phase);
+
+        // Charge `seconds` to `phase` from a timer nested inside a lap
+        void add_nested(SearchPhase phase,double seconds);
+
+        // Forget everything from the last game
+        void reset();
+
+        std::vector<std::string> get_keys();
+        std::vector<double> get_values();
+    };
+
+    // Scoped timer charging its lifetime to EXPANSION of whichever stats object is mid-decision on this thread (if any)
+    class ExpansionTimer{
+        SearchStats* stats;
+        std::chrono::steady_clock::time_point start;
+    public:
+        ExpansionTimer();
+        ~ExpansionTimer();
+    };
+
+    // Called by every Node constructor
+    void count_node();
+
+    // Nodes constructed / bytes allocated on this thread so far (bytes are only counted with SEARCH_PROFILING)
+    long nodes_created();
+    long bytes_allocated();
+}
+
+#ifdef SEARCH_PROFILING
+    #define SEARCH_LAP(stats,phase) (stats).lap(phase)
+    #define SEARCH_EXPANSION_TIMER Search::ExpansionTimer expansion_timer
+#else
+    #define SEARCH_LAP(stats,phase)
+    #define SEARCH_EXPANSION_TIMER
+#endif
+
+#endif
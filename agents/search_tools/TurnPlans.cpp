@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <unordered_set>
+
+#include <boost/container_hash/hash.hpp>
+
+#include "TurnPlans.h"
+#include "Hashes.h"
+#include "Search.h"
+
+#include "../Heuristics.h"
+#include "../../game_files/Random.h"
+
+namespace
+{
+    // Boards reached by different plans are the same if this is. boardHash() leaves out cures (which also show up in the hands)
+    // and whether Quiet Night is on (which doesn't), so those are added.
+    size_t plan_key(Board::Board& game_board){
+        size_t seed = Hashes::boardHash(game_board);
+        boost::hash_combine(seed,(unsigned long long) Hashes::VecHash(game_board.get_cure_status()));
+        boost::hash_combine(seed,game_board.quiet_night_status());
+        return seed;
+    }
+
+    // One of the actions legal on `game_board`, drawn with probability proportional to its Search::action_prior()
+    Actions::Action* prior_weighted_action(Board::Board& game_board,GameLogic::Game& game_logic){
+        std::vector<Actions::Action*> actions = game_logic.list_actions(game_board);
+        std::vector<double> weights(actions.size());
+        double total = 0;
+        for(int action_num=0;action_num<actions.size();action_num++){
+            weights[action_num] = Search::action_prior(actions[action_num],game_board);
+            total+=weights[action_num];
+        }
+        double draw = total*(double) Random::search_rand()/((double) RAND_MAX+1.);
+        int chosen = 0;
+        while(chosen+1<actions.size() && draw>=weights[chosen]){
+            draw-=weights[chosen];
+            chosen++;
+        }
+        for(int action_num=0;action_num<actions.size();action_num++){
+            if(action_num!=chosen){
+                delete actions[action_num];
+            }
+        }
+        return actions[chosen];
+    }
+}
+
+Search::TurnPlan::TurnPlan(std::vector<Actions::Action*> _actions,double _value,size_t _actions_key){
+    movetype = "PLAN";
+    actions = _actions;
+    value = _value;
+    actions_key = _actions_key;
+}
+
+Search::TurnPlan::~TurnPlan(){
+    for(Actions::Action* action: actions){
+        delete action;
+    }
+}
+
+void Search::TurnPlan::execute(Board::Board& new_board){
+    for(Actions::Action* action: actions){
+        action -> execute(new_board);
+    }
+}
+
+std::string Search::TurnPlan::repr(){
+    std::string plan = "PLAN";
+    for(int action_num=0;action_num<actions.size();action_num++){
+        plan+= (action_num==0 ? ": " : "; ") + actions[action_num] -> repr();
+    }
+    return plan;
+}
+
+size_t Search::TurnPlan::key_args(Board::Board& game_board){
+    return actions_key;
+}
+
+std::vector<Actions::Action*> Search::list_turn_plans(Board::Board& game_board,GameLogic::Game& game_logic,const Search::MacroOptions& options){
+    std::vector<Search::TurnPlan*> plans = {};
+    std::unordered_set<size_t> reached = {};
+    for(int sample=0;sample<options.samples;sample++){
+        Board::Board board = game_board;
+        std::vector<Actions::Action*> actions = {};
+        size_t actions_key = 0;
+        do{
+            Actions::Action* action = prior_weighted_action(board,game_logic);
+            boost::hash_combine(actions_key,Actions::action_key(action,board));
+            action -> execute(board);
+            actions.push_back(action);
+        } while(!game_logic.is_terminal(board) && !game_logic.is_stochastic(board));
+
+        if(reached.insert(plan_key(board)).second){
+            double value = game_logic.is_terminal(board) ? (double) game_logic.reward(board) : Heuristics::SmartCompoundHeuristic(board,options.alpha);
+            plans.push_back(new Search::TurnPlan(actions,value,actions_key));
+        } else {
+            // (another ordering of a plan that's already there)
+            for(Actions::Action* action: actions){
+                delete action;
+            }
+        }
+    }
+
+    // Best first, to keep the best `width`, then the other way around for the node's queue
+    std::stable_sort(plans.begin(),plans.end(),[](Search::TurnPlan* a,Search::TurnPlan* b){
+        return a -> value > b -> value;
+    });
+    while(plans.size()>options.width){
+        delete plans.back();
+        plans.pop_back();
+    }
+    return std::vector<Actions::Action*>(plans.rbegin(),plans.rend());
+}
@@ -0,0 +1,50 @@
+#ifndef TURNPLANS_H
+#define TURNPLANS_H
+
+#include <string>
+#include <vector>
+
+#include "../../game_files/Actions.h"
+#include "../../game_files/Board.h"
+#include "../../game_files/GameLogic.h"
+
+namespace Search
+{
+    // How a MacroGameTree makes the turn plans its decision nodes choose between (see list_turn_plans())
+    struct MacroOptions{
+        bool enabled = false;
+        // Random plans sampled per decision node
+        int samples = 64;
+        // Most plans a node keeps (the best, by heuristic of the board they end on)
+        int width = 16;
+        // Weight on CureGoalConditionswStation in the SmartCompoundHeuristic plans are ranked by
+        double alpha = 2./3.;
+    };
+
+    // Every player decision from a board up to the next card draw (or the end of the game), as one action:
+    // the rest of a turn's four actions (events included), or the forced discards between two draws.
+    // It owns its actions, which were listed for the board it starts on, so it's only meant for that board.
+    class TurnPlan: public Actions::Action{
+    public:
+        std::vector<Actions::Action*> actions;
+        // Heuristic value of the board the plan ends on
+        double value;
+        // The Actions::action_key() of each of its actions, taken as they were played, combined
+        size_t actions_key;
+
+        TurnPlan(std::vector<Actions::Action*> _actions,double _value,size_t _actions_key);
+        ~TurnPlan();
+        void execute(Board::Board& new_board); // Execute every action in order
+        std::string repr();
+        size_t key_args(Board::Board& game_board); // actions_key
+    };
+
+    // Candidate plans on `game_board` (which has to be a player's decision): `options.samples` random plans, each action drawn
+    // in proportion to its Search::action_prior() (curing, trading and treating far more often than flying or events),
+    // one per distinct board they end on, since most turns have several orderings of the same actions.
+    // Of those, the best `options.width` by SmartCompoundHeuristic() of their final board, sorted worst to best
+    // (so a DeterministicNode, which takes its untried actions from the back, tries the best plan first).
+    std::vector<Actions::Action*> list_turn_plans(Board::Board& game_board,GameLogic::Game& game_logic,const MacroOptions& options);
+}
+
+#endif
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+
+#include "../game_files/Debug.h"
+
+#include "Bench.h"
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    double seconds_since(Clock::time_point start){
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        return elapsed.count();
+    }
+
+    // Run `iterations` ops and return {seconds, items}
+    std::pair<double,long> time_ops(Bench::Benchmark& bench,long iterations){
+        double seconds = 0;
+        long items = 0;
+        if(bench.setup){
+            // Each op timed on its own so that setup stays off the clock
+            for(long i=0;i<iterations;i++){
+                bench.setup();
+                Clock::time_point start = Clock::now();
+                items+=bench.op();
+                seconds+=seconds_since(start);
+            }
+        } else {
+            Clock::time_point start = Clock::now();
+            for(long i=0;i<iterations;i++){
+                items+=bench.op();
+            }
+            seconds = seconds_since(start);
+        }
+        return {seconds,items};
+    }
+
+    std::string json_number(double value){
+        std::ostringstream out;
+        out << std::setprecision(10) << value;
+        return out.str();
+    }
+}
+
+Bench::Suite::Suite(std::string _suite_name){
+    suite_name = _suite_name;
+}
+
+std::string Bench::Suite::name(){
+    return suite_name;
+}
+
+void Bench::Suite::add(std::string name,std::function<long()> op,std::string item_name,std::function<void()> setup){
+    benchmarks.push_back({name,op,item_name,setup});
+}
+
+std::vector<Bench::Record> Bench::Suite::run(Registry::Params& params){
+    std::string filter = params.get_string("filter","");
+    double min_time = params.get_double("min_time",.5);
+    int samples = std::max(1,params.get_int("samples",5));
+    unsigned int seed = (unsigned int) params.get_long("seed",1);
+
+    std::vector<Bench::Record> records = {};
+    for(Bench::Benchmark& bench: benchmarks){
+        if(!filter.empty() && bench.name.find(filter)==std::string::npos){
+            continue;
+        }
+        srand(seed);
+
+        // Warm up and find how many ops fill one sample (min_time/samples seconds)
+        double sample_time = min_time/(double) samples;
+        long iterations = 1;
+        while(true){
+            std::pair<double,long> trial = time_ops(bench,iterations);
+            if(trial.first >= sample_time/4 || iterations >= (1l<<30)){
+                iterations = std::max(1l,(long) ((double) iterations * sample_time/std::max(trial.first,1e-9)));
+                break;
+            }
+            iterations*=4;
+        }
+
+        // Then the real samples, each starting from the same seed
+        std::vector<double> ns_per_op = {};
+        long total_ops = 0;
+        long total_items = 0;
+        for(int sample=0;sample<samples;sample++){
+            srand(seed);
+            std::pair<double,long> timed = time_ops(bench,iterations);
+            ns_per_op.push_back(1e9*timed.first/(double) iterations);
+            total_ops+=iterations;
+            total_items+=timed.second;
+        }
+        std::sort(ns_per_op.begin(),ns_per_op.end());
+        double median = ns_per_op[ns_per_op.size()/2];
+        double items_per_op = (double) total_items/(double) total_ops;
+
+        Bench::Record record = {bench.name,{
+            {"ns_per_op",median,true,true},
+            {"min_ns_per_op",ns_per_op[0],true,false},
+            {"iterations",(double) total_ops,true,false}
+        }};
+        if(!bench.item_name.empty()){
+            record.metrics.push_back({"items_per_op",items_per_op,true,false});
+            record.metrics.push_back({"ns_per_item",items_per_op>0 ? median/items_per_op : 0,true,false});
+        }
+        records.push_back(record);
+
+        DEBUG_MSG("[Bench::Suite::run()] " << std::left << std::setw(40) << bench.name << std::right << std::setw(14) << std::fixed << std::setprecision(1) << median << " ns/op");
+        if(!bench.item_name.empty()){
+            DEBUG_MSG("  (" << items_per_op << " " << bench.item_name << "/op)");
+        }
+        DEBUG_MSG(std::defaultfloat << std::setprecision(6) << std::endl);
+    }
+    return records;
+}
+
+bool Bench::WriteJSON(std::string path,std::string suite_name,std::vector<Bench::Record>& records){
+    std::ofstream out(path,std::ios::out | std::ios::trunc);
+    if(!out.is_open()){
+        return false;
+    }
+    out << "{" << std::endl;
+    out << "  \"suite\": \"" << suite_name << "\"," << std::endl;
+    out << "  \"benchmarks\": [" << std::endl;
+    for(int r=0;r<records.size();r++){
+        out << "    {\"name\": \"" << records[r].name << "\"";
+        for(Bench::Metric& metric: records[r].metrics){
+            out << ", \"" << metric.key << "\": " << json_number(metric.value);
+        }
+        out << "}" << (r+1<records.size() ? "," : "") << std::endl;
+    }
+    out << "  ]" << std::endl;
+    out << "}" << std::endl;
+    return true;
+}
+
+std::map<std::string,std::map<std::string,double>> Bench::ReadJSON(std::string path){
+    // Only needs to read back what WriteJSON() writes: one record per line
+    std::map<std::string,std::map<std::string,double>> records = {};
+    std::ifstream in(path);
+    std::string line;
+    std::regex name_pattern("\"name\": \"([^\"]*)\"");
+    std::regex number_pattern("\"([A-Za-z0-9_]+)\": (-?[0-9.eE+-]+)");
+    while(std::getline(in,line)){
+        std::smatch name_match;
+        if(!std::regex_search(line,name_match,name_pattern)){
+            continue;
+        }
+        std::map<std::string,double>& metrics = records[name_match[1]];
+        for(std::sregex_iterator it(line.begin(),line.end(),number_pattern);it!=std::sregex_iterator();it++){
+            metrics[(*it)[1]] = std::atof((*it)[2].str().c_str());
+        }
+    }
+    return records;
+}
+
+int Bench::CompareToBaseline(std::vector<Bench::Record>& records,std::map<std::string,std::map<std::string,double>>& baseline,double tolerance){
+    int regressions = 0;
+    for(Bench::Record& record: records){
+        if(baseline.count(record.name)==0){
+            DEBUG_MSG("[Bench::CompareToBaseline()] " << record.name << ": not in baseline" << std::endl);
+            continue;
+        }
+        for(Bench::Metric& metric: record.metrics){
+            if(!metric.compared || baseline[record.name].count(metric.key)==0){
+                continue;
+            }
+            double base = baseline[record.name][metric.key];
+            if(base==0){
+                continue;
+            }
+            // > 1 always means worse
+            double ratio = metric.lower_is_better ? metric.value/base : base/metric.value;
+            bool regressed = ratio > 1+tolerance;
+            if(regressed){
+                regressions++;
+            }
+            DEBUG_MSG("[Bench::CompareToBaseline()] " << std::left << std::setw(40) << record.name << std::setw(18) << metric.key << std::right
+                << " baseline " << std::setw(12) << base << "  now " << std::setw(12) << metric.value
+                << "  (" << std::fixed << std::setprecision(1) << 100*std::abs(ratio-1) << (ratio>1 ? "% worse)" : "% better)") << std::defaultfloat << std::setprecision(6)
+                << (regressed ? "  <-- REGRESSION" : "") << std::endl);
+        }
+    }
+    return regressions;
+}
+
+int Bench::Report(std::string suite_name,std::vector<Bench::Record>& records,Registry::Params& params){
+    std::string out_path = params.get_string("out","results/bench_"+suite_name+".json");
+    if(Bench::WriteJSON(out_path,suite_name,records)){
+        DEBUG_MSG("[Bench::Report()] Wrote " << records.size() << " results to " << out_path << std::endl);
+    } else {
+        DEBUG_MSG("[Bench::Report()] Couldn't write " << out_path << std::endl);
+    }
+
+    if(!params.has("baseline") || params.get_string("baseline")=="none"){
+        return 0;
+    }
+    std::map<std::string,std::map<std::string,double>> baseline = Bench::ReadJSON(params.get_string("baseline"));
+    if(baseline.empty()){
+        DEBUG_MSG("[Bench::Report()] Baseline " << params.get_string("baseline") << " is missing or empty" << std::endl);
+        return 1;
+    }
+    double tolerance = params.get_double("tolerance",.1);
+    int regressions = Bench::CompareToBaseline(records,baseline,tolerance);
+    DEBUG_MSG("[Bench::Report()] " << regressions << " regression(s) beyond " << 100*tolerance << "% of " << params.get_string("baseline") << std::endl);
+    return regressions>0 ? 1 : 0;
+}
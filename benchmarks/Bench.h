@@ -0,0 +1,78 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../experimental_tools/Registry.h"
+
+// A small timing harness for the benchmarks in this directory.
+//
+// Benchmarks are repeatable: rand() is re-seeded with the same `seed` before every benchmark, so each one walks the same games every run.
+// Results are written as JSON (one record per line, so they diff nicely) and can be compared against a stored baseline file:
+// any compared metric that got worse by more than `tolerance` (relative) is flagged as a regression.
+namespace Bench
+{
+    // One named number in a record, e.g. ns_per_op or games_per_sec
+    struct Metric{
+        std::string key;
+        double value;
+
+        // Direction that counts as "worse" when compared against a baseline
+        bool lower_is_better = true;
+
+        // Only compared metrics can flag a regression (the rest are just reported)
+        bool compared = true;
+    };
+
+    // Everything measured for one benchmark
+    struct Record{
+        std::string name;
+        std::vector<Metric> metrics;
+    };
+
+    // A timed operation. `op` returns how many "items" it processed (e.g. player cards drawn in a rollout) so that
+    // long, variable-length operations can also be reported per item (items_per_op, ns_per_item); `item_name` is just for the printout.
+    // `setup` (optional) runs before every op with the clock stopped.
+    struct Benchmark{
+        std::string name;
+        std::function<long()> op;
+        std::string item_name;
+        std::function<void()> setup;
+    };
+
+    class Suite{
+        std::string suite_name;
+        std::vector<Benchmark> benchmarks = {};
+    public:
+        Suite(std::string _suite_name);
+
+        void add(std::string name,std::function<long()> op,std::string item_name="",std::function<void()> setup=nullptr);
+
+        // Run every benchmark whose name contains `filter` (all of them by default)
+        // Params: filter, min_time (seconds of measurement per benchmark, default .5), samples (default 5), seed (default 1)
+        std::vector<Record> run(Registry::Params& params);
+
+        std::string name();
+    };
+
+    // Write records as JSON to `path`
+    bool WriteJSON(std::string path,std::string suite_name,std::vector<Record>& records);
+
+    // Read a file written by WriteJSON() into name -> (metric key -> value)
+    std::map<std::string,std::map<std::string,double>> ReadJSON(std::string path);
+
+    // Print each compared metric next to its baseline value and return the number of regressions beyond `tolerance`
+    int CompareToBaseline(std::vector<Record>& records,std::map<std::string,std::map<std::string,double>>& baseline,double tolerance);
+
+    // Shared command-line handling for benchmark binaries:
+    //      --out=<path>        where to write JSON (default results/bench_<suite>.json)
+    //      --baseline=<path>   compare against this file (`none` to skip); exit code 1 if anything regressed
+    //      --tolerance=<frac>  allowed relative slowdown (default .1)
+    // Returns the process exit code
+    int Report(std::string suite_name,std::vector<Record>& records,Registry::Params& params);
+}
+
+#endif
@@ -0,0 +1,290 @@
+#include <iostream>
+
+#include "../game_files/Board.h"
+#include "../game_files/GameLogic.h"
+#include "../game_files/Map.h"
+
+#include "../agents/Heuristics.h"
+#include "../agents/HeuristicCombinators.h"
+#include "../agents/search_tools/Search.h"
+#include "../agents/search_tools/Hashes.h"
+#include "../agents/search_tools/HeuristicCache.h"
+
+#include "../experimental_tools/Registry.h"
+#include "../experimental_tools/Scenarios.h"
+
+#include "Bench.h"
+
+// Microbenchmarks of the engine's hot paths: the pieces every simulation of every search agent is made of.
+//
+//      benchmarks/Microbenchmarks.out [--filter=<substring>] [--min_time=<s>] [--samples=<n>] [--seed=<n>]
+//                                     [--out=<json>] [--baseline=<json>] [--tolerance=<fraction>]
+//
+// e.g. save a baseline, change something, then check nothing got slower:
+//      benchmarks/Microbenchmarks.out --out=results/micro_before.json
+//      benchmarks/Microbenchmarks.out --baseline=results/micro_before.json
+//
+// All boards are built from a fixed seed, so every run benchmarks the same positions.
+
+// Results get added in here so the optimizer can't throw the benchmarked work away
+volatile double sink = 0;
+
+// The SmartRollout agent's selection heuristic as a plain function, for the function-pointer rollout
+double smart_compound_two_thirds(Board::Board& game_board){
+    return Heuristics::SmartCompoundHeuristic(game_board,2./3.);
+}
+
+// A vanilla board (roles 1,2,3 at difficulty 4) advanced by a few turns of by-group random play, so that hands, cubes and the decks look like a game in progress.
+// Always left at a player decision (the last one before the game ended, if random play loses that quickly).
+Board::Board* midgame_board(unsigned int seed,int player_actions){
+    srand(seed);
+    Scenarios::VanillaGameScenario scenario;
+    GameLogic::Game game;
+    game.reset_board(scenario.make_board({1,2,3},4));
+
+    Board::Board* decision_board = new Board::Board(game.board_copy());
+    int actions_taken = 0;
+    while(actions_taken<player_actions && !game.is_terminal()){
+        game.nonplayer_actions();
+        if(!game.is_terminal()){
+            *decision_board = game.board_copy();
+
+            Actions::Action* action = game.get_random_action_bygroup();
+            game.applyAction(action);
+            delete action;
+            actions_taken++;
+        }
+    }
+    game.nonplayer_actions();
+    if(!game.is_terminal()){
+        *decision_board = game.board_copy();
+    }
+    return decision_board;
+}
+
+// A BusyBoardScenario board where city 0, its neighbors and their neighbors all hold 3 cubes of disease 0,
+// so that one more cube in city 0 sets off a chain of outbreaks.
+Board::Board* cascade_board(unsigned int seed){
+    srand(seed);
+    Scenarios::BusyBoardScenario scenario;
+    Board::Board* board = scenario.make_board({1,2,3},4);
+
+    std::vector<int> loaded = {0};
+    for(int neighbor: Map::CITIES[0].neighbors){
+        loaded.push_back(neighbor);
+        for(int second: Map::CITIES[neighbor].neighbors){
+            loaded.push_back(second);
+        }
+    }
+    for(int city: loaded){
+        if(board -> get_disease_count()[0][city]==0){
+            board -> set_disease_count(city,0,3);
+        }
+    }
+    return board;
+}
+
+int main(int argc,char** argv){
+    Registry::Params params;
+    if(!params.read_args(argc,argv)){
+        std::cout << "Usage: Microbenchmarks.out [--filter=<substring>] [--min_time=<s>] [--samples=<n>] [--seed=<n>] [--out=<json>] [--baseline=<json>] [--tolerance=<fraction>]" << std::endl;
+        return 1;
+    }
+    unsigned int seed = (unsigned int) params.get_long("seed",1);
+
+    Board::Board* start = midgame_board(seed,0);
+    Board::Board* midgame = midgame_board(seed,20);
+    Board::Board* cascade = cascade_board(seed);
+
+    // Board the benchmarks with setup() mutate (reset off the clock)
+    Board::Board scratch = *start;
+
+    GameLogic::Game game;
+    game.reset_board(new Board::Board(*midgame));
+
+    Bench::Suite suite("micro");
+
+    // ===== State handling =====
+    suite.add("board_copy",[&](){
+        Board::Board copy(*midgame);
+        sink = sink + copy.get_outbreak_count();
+        return 1l;
+    });
+
+    // ===== Game status (reads of the phase the board keeps, see Board::update_phase()) =====
+    suite.add("is_terminal",[&](){
+        sink = sink + game.is_terminal(*midgame);
+        return 1l;
+    });
+    suite.add("is_stochastic",[&](){
+        sink = sink + game.is_stochastic(*midgame);
+        return 1l;
+    });
+    // ... and working the phase out the long way, as they used to on every call
+    suite.add("derive_phase",[&](){
+        sink = sink + game.derive_phase(*midgame);
+        return 1l;
+    });
+
+    // ===== Action generation =====
+    suite.add("list_actions",[&](){
+        std::vector<Actions::Action*> actions = game.list_actions(*midgame);
+        long n_actions = actions.size();
+        for(Actions::Action* action: actions){
+            delete action;
+        }
+        return n_actions;
+    },"actions");
+
+    suite.add("get_random_action_bygroup",[&](){
+        Actions::Action* action = game.get_random_action_bygroup(*midgame);
+        sink = sink + 1;
+        delete action;
+        return 1l;
+    });
+
+    // ===== Rollouts (from the start of a game, to the end) =====
+    suite.add("rollout_bygroup",[&](){
+        int cards_before = scratch.remaining_player_cards();
+        sink = sink + game.rollout(scratch);
+        return (long) (cards_before - scratch.remaining_player_cards());
+    },"player_cards",[&](){
+        scratch = *start;
+    });
+
+    // Same selection/evaluation heuristics as the SmartRollout agent, as the same concrete types (see HeuristicCombinators.h)
+    Heuristics::SmartCompound rollout_selection{2./3.};
+    Heuristics::Fn<Heuristics::CureGoalConditionswStation> rollout_eval;
+    suite.add("epsgreedy_heuristic_rollout",[&](){
+        int cards_before = scratch.remaining_player_cards();
+        sink = sink + game.epsgreedy_heuristic_rollout(scratch,.1,rollout_selection,rollout_eval);
+        return (long) (cards_before - scratch.remaining_player_cards());
+    },"player_cards",[&](){
+        scratch = *start;
+    });
+    // ... and through function pointers
+    suite.add("epsgreedy_heuristic_rollout_fnptr",[&](){
+        int cards_before = scratch.remaining_player_cards();
+        sink = sink + game.epsgreedy_heuristic_rollout<Heuristics::Heuristic*,Heuristics::Heuristic*>(scratch,.1,smart_compound_two_thirds,Heuristics::CureGoalConditionswStation);
+        return (long) (cards_before - scratch.remaining_player_cards());
+    },"player_cards",[&](){
+        scratch = *start;
+    });
+
+    // ===== Draw phases =====
+    // Everything between a player's last action and the next player's first: two player cards and the infect cards
+    Board::Board draw_phase = *midgame;
+    while(!game.is_stochastic(draw_phase) && !game.is_terminal(draw_phase)){
+        Actions::Action* action = game.get_random_action_bygroup(draw_phase);
+        action -> execute(draw_phase);
+        delete action;
+    }
+    suite.add("nonplayer_actions",[&](){
+        game.nonplayer_actions(scratch);
+        sink = sink + scratch.get_outbreak_count();
+        return 1l;
+    },"",[&](){
+        scratch = draw_phase;
+    });
+
+    // ===== Infection =====
+    suite.add("infect_outbreak_cascade",[&](){
+        std::array<int,2> result = scratch.infect(0,0,1);
+        return (long) result[0];
+    },"outbreaks",[&](){
+        scratch = *cascade;
+    });
+
+    // ===== Heuristics (on the midgame board) =====
+    std::vector<std::pair<std::string,Heuristics::Heuristic*>> heuristics = {
+        {"PureGameReward",Heuristics::PureGameReward},
+        {"CureGoalHeuristic",Heuristics::CureGoalHeuristic},
+        {"CureGoalConditions",Heuristics::CureGoalConditions},
+        {"CureGoalConditionswStation",Heuristics::CureGoalConditionswStation},
+        {"LossProximity",Heuristics::LossProximity},
+        {"SmartLossProximity",Heuristics::SmartLossProximity}
+    };
+    for(std::pair<std::string,Heuristics::Heuristic*>& heuristic: heuristics){
+        Heuristics::Heuristic* fn = heuristic.second;
+        suite.add("heuristic_"+heuristic.first,[&,fn](){
+            sink = sink + fn(*midgame);
+            return 1l;
+        });
+    }
+    suite.add("heuristic_CompoundHeuristic",[&](){
+        sink = sink + Heuristics::CompoundHeuristic(*midgame,Heuristics::CureGoalConditionswStation,Heuristics::SmartLossProximity,2./3.);
+        return 1l;
+    });
+    // (the same value, from one pass over the board)
+    suite.add("heuristic_SmartCompoundHeuristic",[&](){
+        sink = sink + Heuristics::SmartCompoundHeuristic(*midgame,2./3.);
+        return 1l;
+    });
+
+    // ===== Heuristic cache (see Search::HeuristicCache) =====
+    // The key alone, then a lookup that hits (the midgame board is stored on the first call)
+    suite.add("heuristic_cache_hash",[&](){
+        sink = sink + (double) Hashes::heuristicHash(*midgame);
+        return 1l;
+    });
+    Search::HeuristicCache cache;
+    cache.enabled = true;
+    Heuristics::SmartCompound cached_heuristic{2./3.};
+    suite.add("heuristic_cache_hit",[&](){
+        sink = sink + cache.evaluate(*midgame,cached_heuristic);
+        return 1l;
+    });
+
+    // ===== Heuristic composition: function pointers vs. combinator types (see HeuristicCombinators.h) =====
+    suite.add("compose_fnptr_weighted_sum",[&](){
+        sink = sink + Heuristics::CompoundHeuristic(*midgame,Heuristics::CureGoalConditionswStation,Heuristics::LossProximity,2./3.);
+        return 1l;
+    });
+    auto weighted = Heuristics::weighted_sum(Heuristics::Fn<Heuristics::CureGoalConditionswStation>(),Heuristics::Fn<Heuristics::LossProximity>(),2./3.);
+    suite.add("compose_typed_weighted_sum",[&](){
+        sink = sink + weighted(*midgame);
+        return 1l;
+    });
+    // clamp(max(h1,h2)) over pointers, as a lambda converted to a function pointer would be called...
+    Heuristics::Heuristic* clamped_max_fnptr = [](Board::Board& game_board){
+        return std::min(std::max(std::max(Heuristics::CureGoalConditions(game_board),Heuristics::LossProximity(game_board)),0.),1.);
+    };
+    suite.add("compose_fnptr_clamp_max",[&](){
+        sink = sink + clamped_max_fnptr(*midgame);
+        return 1l;
+    });
+    // ... and as one type
+    auto clamped_max = Heuristics::clamp(Heuristics::max_of(Heuristics::Fn<Heuristics::CureGoalConditions>(),Heuristics::Fn<Heuristics::LossProximity>()));
+    suite.add("compose_typed_clamp_max",[&](){
+        sink = sink + clamped_max(*midgame);
+        return 1l;
+    });
+
+    // ===== Search =====
+    // One getBestLeaf() + backprop() on a 3-determinization tree over the midgame board.
+    // The tree is rebuilt (off the clock) every 1000 simulations so that it stays about the size an agent would see.
+    Search::GameTree* tree = nullptr;
+    int tree_sims = 0;
+    suite.add("uct_getBestLeaf_backprop",[&](){
+        Search::Node* leaf = tree -> getBestLeaf(scratch,Search::UCB1Score);
+        leaf -> backprop(.5);
+        tree_sims++;
+        return 1l;
+    },"",[&](){
+        if(!tree || tree_sims>=1000){
+            delete tree;
+            tree = new Search::KDeterminizedGameTree(game,3);
+            tree_sims = 0;
+        }
+        scratch = *midgame;
+    });
+
+    std::vector<Bench::Record> records = suite.run(params);
+    int status = Bench::Report(suite.name(),records,params);
+
+    delete tree;
+    delete start;
+    delete midgame;
+    delete cascade;
+    return status;
+}
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../game_files/Debug.h"
+
+#include "../experimental_tools/Experiments.h"
+#include "../experimental_tools/Measurements.h"
+#include "../experimental_tools/Registry.h"
+
+#include "Bench.h"
+
+// End-to-end throughput: play a fixed, seeded set of games with each agent family through RunExperiment(), exactly like a real experiment,
+// and report games/sec, simulations/sec, peak RSS and decision latency percentiles.
+//
+//      benchmarks/Throughput.out [--filter=<family>] [--games_scale=<x>] [--seed=<n>]
+//                                [--out=<json>] [--baseline=<json>|none] [--tolerance=<fraction>] [--isolate=0]
+//
+// By default the results are compared against the checked-in benchmarks/baselines/throughput.json, and the exit code is 1 if anything
+// got slower than `tolerance` (default 15%). Regenerate the baseline with --out=benchmarks/baselines/throughput.json --baseline=none
+// after an intentional change (or on a new machine).
+//
+// Each family runs in its own forked process (unless --isolate=0) so that its peak RSS is its own.
+
+namespace
+{
+    // One agent family: a registered agent and its parameters, and how many games make a run
+    struct Family{
+        std::string name;
+        std::string agent;
+        int n_games;
+        int n_simulations; // per decision (0 for agents that don't search)
+        int K;
+    };
+
+    // Sized so that each family takes a few seconds
+    const std::vector<Family> FAMILIES = {
+        {"ByGroupRandom","ByGroupRandom",4000,0,1},
+        {"Naive_UCT","Naive_UCT",40,100,1},
+        {"Precondition_UCT","Precondition_UCT",40,100,1},
+        {"HeuristicEval_UCT","SmartCompoundWL_UCTMaxChild",20,500,3},
+        {"SmartRollout_UCT","Precondition_UCTMaxChild_SmartRollout",10,20,1}
+    };
+
+    Bench::Record run_family(const Family& family,Registry::Params& params){
+        double games_scale = params.get_double("games_scale",1);
+        int n_games = std::max(1,(int) (games_scale*(double) family.n_games));
+        long seed = params.get_long("seed",1);
+
+        Registry::Params exp_params;
+        exp_params.set("agent",family.agent);
+        exp_params.set("name","Throughput_"+family.name);
+        exp_params.set("n_games",std::to_string(n_games));
+        exp_params.set("n_simulations",std::to_string(std::max(family.n_simulations,1)));
+        exp_params.set("K",std::to_string(family.K));
+        exp_params.set("seed",std::to_string(seed));
+        exp_params.set("measurements","WinLose");
+
+        srand((unsigned int) seed);
+        // Every decision of every game also goes into one histogram for the whole run (the per-game columns just end up in the results file)
+        Measurements::LatencyHistogram latencies;
+        Experiments::ConfiguredExperiment experiment(exp_params);
+        experiment.measureCons.push_back(new Measurements::DecisionLatencyConstructor(1,&latencies));
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Experiments::RunExperiment(&experiment,false);
+        std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+        double decision_seconds = latencies.total();
+        double decisions = (double) latencies.count();
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF,&usage);
+
+        // {key, value, lower_is_better, compared}
+        Bench::Record record = {family.name,{
+            {"games_per_sec",(double) n_games/wall.count(),false,true},
+            {"decisions_per_sec",decision_seconds>0 ? decisions/decision_seconds : 0,false,true},
+            {"sims_per_sec",decision_seconds>0 ? (double) family.n_simulations*decisions/decision_seconds : 0,false,true},
+            {"peak_rss_kb",(double) usage.ru_maxrss,true,true},
+            {"latency_p50_ms",1000*latencies.percentile(.5),true,true},
+            {"latency_p90_ms",1000*latencies.percentile(.9),true,true},
+            {"latency_p99_ms",1000*latencies.percentile(.99),true,false},
+            {"latency_max_ms",1000*latencies.max(),true,false},
+            {"games",(double) n_games,true,false},
+            {"decisions",decisions,true,false}
+        }};
+        return record;
+    }
+
+    // Run a family in a child process and read its record back over a pipe
+    Bench::Record run_family_isolated(const Family& family,Registry::Params& params){
+        int fds[2];
+        if(pipe(fds)!=0){
+            return run_family(family,params);
+        }
+        pid_t pid = fork();
+        if(pid==0){
+            close(fds[0]);
+            Bench::Record record = run_family(family,params);
+            std::ostringstream out;
+            out.precision(10);
+            for(Bench::Metric& metric: record.metrics){
+                out << metric.key << " " << metric.value << " " << metric.lower_is_better << " " << metric.compared << "\n";
+            }
+            std::string text = out.str();
+            ssize_t written = write(fds[1],text.c_str(),text.size());
+            close(fds[1]);
+            _exit(written==(ssize_t) text.size() ? 0 : 1);
+        }
+        close(fds[1]);
+        std::string text;
+        char buffer[4096];
+        ssize_t n_read;
+        while((n_read = read(fds[0],buffer,sizeof(buffer)))>0){
+            text.append(buffer,n_read);
+        }
+        close(fds[0]);
+        int status;
+        waitpid(pid,&status,0);
+
+        Bench::Record record = {family.name,{}};
+        std::istringstream in(text);
+        Bench::Metric metric;
+        while(in >> metric.key >> metric.value >> metric.lower_is_better >> metric.compared){
+            record.metrics.push_back(metric);
+        }
+        return record;
+    }
+}
+
+int main(int argc,char** argv){
+    Registry::Params params;
+    if(!params.read_args(argc,argv)){
+        std::cout << "Usage: Throughput.out [--filter=<family>] [--games_scale=<x>] [--seed=<n>] [--out=<json>] [--baseline=<json>|none] [--tolerance=<fraction>] [--isolate=0]" << std::endl;
+        return 1;
+    }
+    if(!params.has("baseline")){
+        params.set("baseline","benchmarks/baselines/throughput.json");
+    }
+    if(!params.has("tolerance")){
+        params.set("tolerance",".15");
+    }
+
+    std::string filter = params.get_string("filter","");
+    std::vector<Bench::Record> records = {};
+    for(const Family& family: FAMILIES){
+        if(!filter.empty() && family.name.find(filter)==std::string::npos){
+            continue;
+        }
+        Bench::Record record = params.get_bool("isolate",true) ? run_family_isolated(family,params) : run_family(family,params);
+        if(record.metrics.empty()){
+            DEBUG_MSG("[Throughput] " << family.name << " failed to report" << std::endl);
+            continue;
+        }
+        DEBUG_MSG("[Throughput] " << family.name << ":");
+        for(Bench::Metric& metric: record.metrics){
+            DEBUG_MSG(" " << metric.key << "=" << metric.value);
+        }
+        DEBUG_MSG(std::endl);
+        records.push_back(record);
+    }
+
+    return Bench::Report("throughput",records,params);
+}
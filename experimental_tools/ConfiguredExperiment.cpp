@@ -0,0 +1,148 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <ctime>
+
+#include "../game_files/Debug.h"
+
+#include "Experiments.h"
+#include "Registry.h"
+
+Experiments::ConfiguredExperiment::ConfiguredExperiment(Registry::Params& _params):
+    params(_params)
+{
+    agent_type = params.get_string("agent");
+    if(Registry::agents().find(agent_type)==Registry::agents().end()){
+        DEBUG_MSG("[ConfiguredExperiment::ConfiguredExperiment()] Unknown agent '" << agent_type << "'" << std::endl);
+        valid=false;
+    }
+
+    experiment_name = params.get_string("name",agent_type+"Experiment");
+    description = params.get_string("description","Experiment configured at run-time by ExperimentRunner");
+    fileheader = params.get_string("fileheader",experiment_name);
+
+    scenario = Registry::make_scenario(params.get_string("scenario","VanillaGame"));
+    if(!scenario){
+        valid=false;
+    }
+
+    roles = params.get_ints("roles",{1,2,3});
+    difficulty = params.get_int("difficulty",4);
+    n_games = params.get_int("n_games",100);
+
+    if(params.has("seed")){
+        seeded = true;
+        seed = (uint64_t) params.get_long("seed");
+    }
+
+    sanity.full_every = params.get_int("sanity.full_every",sanity.full_every);
+    sanity.game_fraction = params.get_double("sanity.game_fraction",sanity.game_fraction);
+    sanity.paranoid = params.get_bool("sanity.paranoid",sanity.paranoid);
+
+    if(params.has("stop.rule")){
+        stopping_rule = Registry::make_stopping_rule(params);
+        if(!stopping_rule){
+            valid=false;
+        }
+    }
+
+    // Just the registered name - its parameters show up in the Configuration section of the header
+    // (the agent constructors decide which of those they actually read)
+    agent_name = agent_type;
+
+    for(std::string& measure_name: params.get_strings("measurements",Registry::DEFAULT_MEASUREMENTS)){
+        Measurements::MeasurementConstructor* con = Registry::make_measurement(measure_name,params);
+        if(con){
+            measureCons.push_back(con);
+        } else {
+            valid=false;
+        }
+    }
+
+    for(Measurements::MeasurementConstructor* con: measureCons){
+        for(std::string key: con-> get_value_keys()){
+            log_headers.push_back(key);
+        }
+    }
+    log_headers.push_back("BrokeReasons"); // Always track any reasons the board broke
+}
+
+void Experiments::ConfiguredExperiment::write_header(){
+    std::ofstream header(Experiments::OUTPUT_DIR + fileheader+".header",std::ios::out | std::ios::trunc);
+
+    header << "Experiment Name: " << experiment_name << std::endl;
+    header << "Experiment Description: " << description << std::endl << std::endl;
+
+    header << "Scenario Name: " << (*scenario).name << std::endl;
+    header << "Scenario Description: " << (*scenario).description << std::endl << std::endl;
+
+    header << "Agent Name: " << agent_name << std::endl;
+
+    // Dump the entire configuration so that the run can be reproduced from the header alone
+    header << "==========================================" << std::endl;
+    header << "============= Configuration ==============" << std::endl<< std::endl;
+    for(std::string& key: params.keys()){
+        header << key << " = " << params.get_string(key) << std::endl;
+    }
+    header << std::endl;
+
+    if(stopping_rule){
+        header << "Stopping Rule: " << stopping_rule -> name << std::endl;
+        header << "Stopping Rule Description: " << stopping_rule -> description << std::endl << std::endl;
+    }
+
+    header << "==========================================" << std::endl;
+    header << "=========== Measurements Taken ===========" << std::endl<< std::endl;
+
+    for(Measurements::MeasurementConstructor* con: measureCons){
+        header << "Measurement Name: " << (*con).name << std::endl;
+        header << "Measurement Description: " << (*con).description << std::endl << std::endl;
+    }
+
+    time_t start_time;
+    struct tm * timeinfo;
+    char buffer[80];
+
+    time (&start_time);
+    timeinfo = localtime(&start_time);
+
+    strftime(buffer,sizeof(buffer),"%d-%m-%Y %H:%M:%S",timeinfo);
+    std::string str(buffer);
+
+    header << "Start Time: " << str << std::endl;
+
+    header.close();
+}
+
+void Experiments::ConfiguredExperiment::reset_board(Board::Board* game_board){
+    scenario -> reset_board(game_board);
+}
+
+void Experiments::ConfiguredExperiment::append_header(std::string extras){
+    std::ofstream header(Experiments::OUTPUT_DIR + fileheader+".header",std::ios::out | std::ios::app);
+    header << extras;
+    header.close();
+}
+
+void Experiments::ConfiguredExperiment::write_experiment(std::string data){
+    std::ofstream logfile(Experiments::OUTPUT_DIR + fileheader + ".csv",std::ios::out | std::ios::trunc);
+    logfile << data;
+    logfile.close();
+}
+
+Board::Board* Experiments::ConfiguredExperiment::get_board(){
+    return scenario -> make_board(roles,difficulty);
+}
+
+Agents::BaseAgent* Experiments::ConfiguredExperiment::get_agent(GameLogic::Game* game){
+    return Registry::make_agent(agent_type,*game,params);
+}
+
+std::vector<Measurements::GameMeasurement*> Experiments::ConfiguredExperiment::get_game_measures(Board::Board* game){
+    std::vector<Measurements::GameMeasurement*> game_measures = {};
+
+    for(Measurements::MeasurementConstructor* con: measureCons){
+        game_measures.push_back(con -> construct_measure(*game));
+    }
+    return game_measures;
+}
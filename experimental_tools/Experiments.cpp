@@ -1,10 +1,48 @@
+#include <chrono>
+
 #include "../game_files/Debug.h"
 
 #include "../agents/Agents.h"
 
 #include "Experiments.h"
 
-void Experiments::RunExperiment(Experiments::Experiment* exp,bool log_output){
+void Experiments::PlayGame(GameLogic::Game* the_game,Agents::BaseAgent* the_agent,std::vector<Measurements::GameMeasurement*>& game_measures,Random::ChanceStreams* chance,SanityCheck::Checker* checker){
+    SanityCheck::Checker default_checker;
+    if(!checker){
+        checker = &default_checker;
+    }
+    Board::Board& game_board = *the_game -> get_board_ptr();
+
+    checker -> step(game_board);
+    while(!the_game -> is_terminal()){
+        // First resolve any necessary non-player transisitions (card draws)
+        // (only these draws come out of the game's chance streams - the agent's search below uses Random::search_rand())
+        {
+            Random::ChanceScope scope(chance);
+            the_game -> nonplayer_actions();
+        }
+
+        // If these transitions haven't made the game terminal, then have the agent choose a transition
+        if(!the_game -> is_terminal()){
+            // Update each measurement
+            for(Measurements::GameMeasurement* meas: game_measures){
+                meas -> update();
+            }
+            // Have the agent take a step
+            //      (Agents with measurements will update them during this step)
+            the_agent -> take_step();
+
+            for(Measurements::GameMeasurement* meas: game_measures){
+                meas -> after_step();
+            }
+        }
+        // (whatever the schedule says is due: a check that breaks the board ends the game)
+        checker -> step(game_board);
+    }
+    checker -> end_game(game_board);
+}
+
+void Experiments::RunExperiment(Experiments::Experiment* exp,bool log_output,Experiments::ProgressReporter* progress){
     // Write the header file including start timestamp (REMOVE any file that existed before)
     // Will need to append the finish time later
     exp -> write_header();
@@ -46,29 +84,60 @@ void Experiments::RunExperiment(Experiments::Experiment* exp,bool log_output){
     output_str+="\r\n";
 
     int games_played=0;
+    int games_won=0;
+
+    // Card draw streams for seeded experiments, re-seeded every game (and a stream for everything else the game needs, see Random::SearchScope)
+    Random::ChanceStreams chance;
+    Random::Stream search;
+
+    // Invariant checks on the experiment's schedule, and the time all the games took (to say what share of it the checks were)
+    SanityCheck::Checker checker((*exp).sanity);
+    double play_seconds = 0;
+
+    // With a stopping rule the run can end anywhere between its min and max game counts
+    StoppingRules::StoppingRule* stopping_rule = (*exp).stopping_rule;
+    int max_games = stopping_rule ? stopping_rule -> max_games : (*exp).n_games;
+    bool stopped_early = false;
+    if(stopping_rule){
+        stopping_rule -> reset();
+    }
 
     // By int coercion, log_interval should be floor of this division I think?
     // This is every 5% of games completed (unless <20 n_games, then 1)
-    int log_interval = ((int) (*exp).n_games/20) > 0 ? ((int) (*exp).n_games/20) : 1;
+    int log_interval = ((int) max_games/20) > 0 ? ((int) max_games/20) : 1;
 
     // Enter the experimental loop!
-    while(games_played<(*exp).n_games){
+    while(games_played<max_games && !stopped_early){
         if(log_output){
             if(games_played % log_interval==0){
-                DEBUG_MSG("[Experiments::RunExperiment()] has ran " << games_played << " games (~"<< ((int) (100*games_played)/(*exp).n_games) << "% completed)" << std::endl);
+                DEBUG_MSG("[Experiments::RunExperiment()] has ran " << games_played << " games (~"<< ((int) (100*games_played)/max_games) << "% completed)" << std::endl);
             }
         }
 
+        std::chrono::steady_clock::time_point game_start = std::chrono::steady_clock::now();
+
         // Write the game number in the first column of the experiment output
         output_str+= std::to_string(games_played+1);
 
-        // If there isn't already a board
-        if(!game_board){
-            // Instantiate a new board using the given scenario
-            game_board = exp -> get_board();
-        } else {
-            // otherwise use the experiment definition to reset the board using its scenario
-            exp -> reset_board(game_board);
+        // Seeded experiments draw this game's cards from their own streams (starting with the scenario setup)
+        if((*exp).seeded){
+            chance.seed(Random::GameSeed((*exp).seed,games_played));
+            search.seed(Random::SearchSeed((*exp).seed,games_played));
+        }
+        Random::ChanceStreams* game_chance = (*exp).seeded ? &chance : nullptr;
+        // (for the rest of this game, on this thread)
+        Random::SearchScope search_scope((*exp).seeded ? &search : nullptr);
+
+        {
+            Random::ChanceScope scope(game_chance);
+            // If there isn't already a board
+            if(!game_board){
+                // Instantiate a new board using the given scenario
+                game_board = exp -> get_board();
+            } else {
+                // otherwise use the experiment definition to reset the board using its scenario
+                exp -> reset_board(game_board);
+            }
         }
 
         if(!the_game -> hasBoard()){
@@ -88,21 +157,9 @@ void Experiments::RunExperiment(Experiments::Experiment* exp,bool log_output){
         // Reset any game-level info held in the agent for play
         the_agent -> reset();
 
-        while(!the_game -> is_terminal(true,false)){
-            // First resolve any necessary non-player transisitions (card draws)
-            the_game -> nonplayer_actions();
-            
-            // If these transitions haven't made the game terminal, then have the agent choose a transition (no sanity check here)
-            if(!the_game -> is_terminal(false,false)){
-                // Update each measurement
-                for(Measurements::GameMeasurement* meas: game_measures){
-                    meas -> update();
-                }
-                // Have the agent take a step
-                //      (Agents with measurements will update them during this step)
-                the_agent -> take_step();
-            }
-        } 
+        checker.start_game(games_played);
+        PlayGame(the_game,the_agent,game_measures,game_chance,&checker);
+
         // At the end of the game, write out the resulting measures to the output_str
         for(Measurements::GameMeasurement* meas: game_measures){
             std::vector<double> output_values = meas -> get_values();
@@ -129,9 +186,23 @@ void Experiments::RunExperiment(Experiments::Experiment* exp,bool log_output){
         output_str+="\r\n";
 
         games_played++;
+        if(game_board -> win_lose()==1){
+            games_won++;
+        }
+
+        if(stopping_rule){
+            stopped_early = stopping_rule -> update(games_won,games_played);
+        }
+
+        std::chrono::duration<double> game_time = std::chrono::steady_clock::now() - game_start;
+        play_seconds+= game_time.count();
+        if(progress){
+            progress -> game_finished(exp,games_played,game_time.count());
+        }
     };
 
     DEBUG_MSG("[[Experiments::RunExperiment()]] ...successfully executed " + std::to_string(games_played) + " games with the "<< (*exp).experiment_name << " experiment." << std::endl);
+    DEBUG_MSG("[[Experiments::RunExperiment()]] Sanity checks (" << checker.describe() << ") took " << checker.seconds_per_game() << "s per game, " << 100.*checker.overhead(play_seconds) << "% of the time spent playing." << std::endl);
 
     // Write the entire contents of the experiments all at once into a csv (REMOVE any file that existed before)
     exp -> write_experiment(output_str);
@@ -148,5 +219,14 @@ void Experiments::RunExperiment(Experiments::Experiment* exp,bool log_output){
     strftime(buffer,sizeof(buffer),"%d-%m-%Y %H:%M:%S",timeinfo);
     std::string str(buffer);
 
+    if(stopping_rule){
+        exp -> append_header("Games Played: "+std::to_string(games_played)+" ("+std::to_string(games_won)+" won)\r\n");
+        exp -> append_header("Stopping Reason: "+stopping_rule -> reason+"\r\n");
+    }
+
+    exp -> append_header("Sanity Checks: "+checker.describe()+"\r\n");
+    exp -> append_header("Sanity Checks Run: "+std::to_string(checker.checks[SanityCheck::QUICK])+" quick, "+std::to_string(checker.checks[SanityCheck::FULL])+" full, "+std::to_string(checker.checks[SanityCheck::PARANOID])+" paranoid\r\n");
+    exp -> append_header("Sanity Check Overhead: "+std::to_string(checker.seconds_per_game())+"s per game ("+std::to_string(100.*checker.overhead(play_seconds))+"% of game time)\r\n");
+
     exp -> append_header("End Time: "+str+"\r\n");
 }
\ No newline at end of file
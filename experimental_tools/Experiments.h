@@ -1,8 +1,14 @@
+#ifndef EXPERIMENTS_H
+#define EXPERIMENTS_H
+
 #include "../game_files/GameLogic.h"
 #include "../game_files/Board.h"
+#include "../game_files/Random.h"
 
 #include "Scenarios.h"
 #include "Measurements.h"
+#include "Registry.h"
+#include "StoppingRules.h"
 
 #include "../agents/Agents.h"
 
@@ -38,6 +44,20 @@ namespace Experiments
         // number of games that aget
         int n_games=0;
 
+        // Optional rule for stopping before n_games on the win/lose record (nullptr = always play n_games)
+        // When there is one, its min_games/max_games bound the run instead of n_games
+        StoppingRules::StoppingRule* stopping_rule = nullptr;
+
+        // When seeded, the card draws of game i (scenario setup and nonplayer_actions()) come from streams seeded with Random::GameSeed(seed,i)
+        // instead of rand(). Any two experiments with the same seed then deal the same cards in game i, whatever their agents do while searching.
+        // The agent's own random numbers come from a stream seeded with Random::SearchSeed(seed,i), so the whole game is reproducible, on any thread.
+        bool seeded=false;
+        uint64_t seed=0;
+
+        // Which invariant checks run during play (see SanityCheck::Schedule). By default just the quick ones after every step,
+        // and CheckBoard() on each game's final board: production runs don't pay for the full checks unless they ask.
+        SanityCheck::Schedule sanity;
+
         // Functional methods
         
         // For writing results
@@ -57,9 +77,78 @@ namespace Experiments
 
     };
 
+    // Something that wants to hear about every finished game (e.g. to estimate time remaining)
+    // RunExperiment() calls game_finished() after each game with the wall-clock time that game took
+    class ProgressReporter{
+    public:
+        ProgressReporter(){};
+        virtual ~ProgressReporter(){};
+
+        virtual void game_finished(Experiment* exp,int games_played,double game_seconds)=0;
+    };
+
+    // Play one game to the end on the game's current board: nonplayer transitions, then measurement updates and an agent step, until terminal.
+    // If `chance` isn't nullptr, the nonplayer transitions draw from it (see Random.h)
+    // The board is checked after every step, and at the end, by `checker` (by default, a Checker with the default Schedule).
+    // Call checker -> start_game() first if the schedule samples games.
+    void PlayGame(GameLogic::Game* the_game,Agents::BaseAgent* the_agent,std::vector<Measurements::GameMeasurement*>& game_measures,Random::ChanceStreams* chance=nullptr,SanityCheck::Checker* checker=nullptr);
+
     // A function to take an experiment and run it.
     // This is it's own standalone just because the internal functionality is practically always the same
-    void RunExperiment(Experiment* exp,bool log_output=false);
+    void RunExperiment(Experiment* exp,bool log_output=false,ProgressReporter* progress=nullptr);
+
+    // Head-to-head comparison of the agents of two experiments on common random numbers:
+    // game i of both is dealt from Random::GameSeed(seed,i), so both agents are shown the same cards and only their decisions differ.
+    // Writes OUTPUT_DIR/<fileheader>.csv (both agents' measurements for each game) and a .header with the paired difference (A - B)
+    // of `metric` (any measurement key, e.g. GameWon) and its standard error.
+    // The experiments' own n_games/seed/stopping rule are ignored.
+    void RunPairedComparison(Experiment* exp_a,Experiment* exp_b,std::string fileheader,std::string metric,uint64_t seed,int n_games,bool log_output=false);
+
+    // An experiment put together at run-time from a Registry::Params bag (usually a config file) instead of a hard-coded class.
+    // Recognized keys (anything else is assumed to be an agent parameter, see Registry::agents()):
+    //      name, description, fileheader   - experiment naming (fileheader defaults to name)
+    //      agent                           - registered agent name, e.g. SmartCompoundWL_UCTMaxChild
+    //      scenario                        - registered scenario name (default VanillaGame)
+    //      roles, difficulty               - e.g. `roles = 1,2,3` and `difficulty = 4`
+    //      measurements                    - comma separated registered measurement names (default Registry::DEFAULT_MEASUREMENTS)
+    //      n_games                         - number of games to play
+    //      seed                            - seeds the per-game card draws and the agent's random numbers (see Experiment::seeded), and the runner's srand()
+    //      stop.*                          - optional early stopping rule, see Registry::make_stopping_rule()
+    //      sanity.full_every, sanity.game_fraction, sanity.paranoid
+    //                                      - when the full invariant checks run (see SanityCheck::Schedule; default: only on each game's final board)
+    class ConfiguredExperiment: public Experiment{
+    public:
+        ConfiguredExperiment(Registry::Params& _params);
+        ~ConfiguredExperiment(){
+            delete scenario;
+            delete stopping_rule;
+            for(Measurements::MeasurementConstructor* cons: measureCons){
+                delete cons;
+            }
+            measureCons.clear();
+        };
+
+        // The whole configuration, kept around so it can be written into the header
+        Registry::Params params;
+
+        // Registered name of the agent handed out by get_agent()
+        std::string agent_type;
+
+        std::vector<int> roles;
+        int difficulty;
+
+        // False if any agent/scenario/measurement name didn't resolve (the runner should refuse to run it)
+        bool valid=true;
+
+        void write_header();
+        void append_header(std::string extras);
+        void write_experiment(std::string data);
+
+        Board::Board* get_board();
+        Agents::BaseAgent* get_agent(GameLogic::Game* game);
+        std::vector<Measurements::GameMeasurement*> get_game_measures(Board::Board* board);
+        void reset_board(Board::Board* game_board);
+    };
 
     class UniformRandomAgentGameExperiment: public Experiment{
     public:
@@ -1131,4 +1220,5 @@ namespace Experiments
         std::vector<Measurements::GameMeasurement*> get_game_measures(Board::Board* board);
         void reset_board(Board::Board* game_board);
     };
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -8,6 +8,7 @@
 
 #include <chrono>
 #include <algorithm>
+#include <cmath>
 
 Measurements::GameMeasurement::GameMeasurement(){}
 
@@ -581,4 +582,118 @@ void Measurements::TimeTaken::reset(Board::Board& game_board){
     start_time = std::chrono::steady_clock::now();
 
     active_board = &game_board;   
-}
\ No newline at end of file
+}
+// ===== DecisionLatency measurements =====
+Measurements::LatencyHistogram::LatencyHistogram(){
+    clear();
+}
+
+void Measurements::LatencyHistogram::clear(){
+    buckets.fill(0);
+    n_recorded=0;
+    max_seconds=0;
+    total_seconds=0;
+}
+
+int Measurements::LatencyHistogram::bucket(double seconds){
+    if(seconds<=MIN_SECONDS){
+        return 0;
+    }
+    int b = (int) std::floor(std::log2(seconds/MIN_SECONDS)*(double) BUCKETS_PER_DOUBLING);
+    return std::min(std::max(b,0),N_BUCKETS-1);
+}
+
+double Measurements::LatencyHistogram::upper_edge(int bucket){
+    return MIN_SECONDS*std::exp2((double) (bucket+1)/(double) BUCKETS_PER_DOUBLING);
+}
+
+void Measurements::LatencyHistogram::record(double seconds){
+    buckets[bucket(seconds)]++;
+    n_recorded++;
+    max_seconds = std::max(max_seconds,seconds);
+    total_seconds+=seconds;
+}
+
+long Measurements::LatencyHistogram::count(){
+    return n_recorded;
+}
+
+double Measurements::LatencyHistogram::max(){
+    return max_seconds;
+}
+
+double Measurements::LatencyHistogram::total(){
+    return total_seconds;
+}
+
+double Measurements::LatencyHistogram::percentile(double p){
+    if(n_recorded==0){
+        return 0;
+    }
+    // Nearest rank: the smallest bucket by which at least p of everything has been counted
+    long rank = std::max(1l,(long) std::ceil(p*(double) n_recorded));
+    long seen=0;
+    for(int b=0;b<N_BUCKETS;b++){
+        seen+=buckets[b];
+        if(seen>=rank){
+            return std::min(upper_edge(b),max_seconds);
+        }
+    }
+    return max_seconds;
+}
+
+Measurements::DecisionLatencyConstructor::DecisionLatencyConstructor(double _threshold,LatencyHistogram* _run_histogram){
+    threshold = _threshold;
+    run_histogram = _run_histogram;
+
+    name="Decision Latency";
+    description="Wall time (s) of each agent decision in the game: count, p50/p90/p99/max, and how many took longer than "+std::to_string(threshold)+"s";
+}
+
+Measurements::GameMeasurement* Measurements::DecisionLatencyConstructor::construct_measure(Board::Board& active_board){
+    return new Measurements::DecisionLatency(active_board,threshold,run_histogram);
+}
+
+std::vector<std::string> Measurements::DecisionLatencyConstructor::get_value_keys(){
+    return {"Decisions","DecisionP50","DecisionP90","DecisionP99","DecisionMax","DecisionsOverThreshold"};
+}
+
+Measurements::DecisionLatency::DecisionLatency(Board::Board& _active_board,double _threshold,LatencyHistogram* _run_histogram){
+    active_board = &_active_board;
+    threshold = _threshold;
+    run_histogram = _run_histogram;
+}
+
+std::vector<double> Measurements::DecisionLatency::get_values(){
+    return {
+        (double) histogram.count(),
+        histogram.percentile(.5),
+        histogram.percentile(.9),
+        histogram.percentile(.99),
+        histogram.max(),
+        (double) over_threshold
+    };
+}
+
+// Called right before the agent's step: start the clock
+void Measurements::DecisionLatency::update(){
+    step_start = std::chrono::steady_clock::now();
+}
+
+void Measurements::DecisionLatency::after_step(){
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - step_start;
+    histogram.record(elapsed.count());
+    if(run_histogram){
+        run_histogram -> record(elapsed.count());
+    }
+    if(elapsed.count()>threshold){
+        over_threshold++;
+    }
+}
+
+void Measurements::DecisionLatency::reset(Board::Board& game_board){
+    histogram.clear();
+    over_threshold=0;
+
+    active_board = &game_board;
+}
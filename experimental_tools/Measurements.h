@@ -3,6 +3,7 @@
 
 #include "../game_files/Board.h"
 
+#include <array>
 #include <chrono>
 
 namespace Measurements
@@ -18,6 +19,9 @@ namespace Measurements
         virtual std::vector<double> get_values()=0;
         virtual void update()=0;
         virtual void reset(Board::Board& game_board)=0;
+
+        // Called right after each agent step (update() is called right before it), for measurements that want to bracket decisions
+        virtual void after_step(){};
     };
 
     // A class that can be held by Experiments and used to repeatedly get new measurement classes for each new game
@@ -286,6 +290,69 @@ namespace Measurements
         GameMeasurement* construct_measure(Board::Board& active_board);
     };
 
+    // Fixed-size log-bucketed histogram of durations (seconds), so that recording one never allocates.
+    // Buckets are 1/8 of a doubling wide starting at 100 nanoseconds (so a percentile is off by at most ~9%, even for a random agent's decisions),
+    // and the last bucket catches everything past ~25s.
+    // The exact max is kept alongside.
+    class LatencyHistogram{
+    public:
+        static const int BUCKETS_PER_DOUBLING = 8;
+        static const int N_BUCKETS = 28*BUCKETS_PER_DOUBLING;
+        static constexpr double MIN_SECONDS = 1e-7;
+
+        LatencyHistogram();
+
+        void record(double seconds);
+        void clear();
+
+        long count();
+        double max();
+        // Sum of everything recorded (exact, not bucketed)
+        double total();
+
+        // Upper edge of the bucket holding the p-quantile (0<p<=1), capped at the max. 0 if nothing was recorded.
+        double percentile(double p);
+    private:
+        std::array<long,N_BUCKETS> buckets;
+        long n_recorded=0;
+        double max_seconds=0;
+        double total_seconds=0;
+
+        int bucket(double seconds);
+        double upper_edge(int bucket);
+    };
+
+    // To track the distribution of the wall time of each agent decision (one take_step()) within a game:
+    // count, p50/p90/p99/max (seconds) and how many decisions took longer than `threshold` seconds.
+    // If given a `run_histogram`, every decision is recorded there too, across games (e.g. for a whole benchmark run).
+    class DecisionLatency: public GameMeasurement{
+        std::chrono::steady_clock::time_point step_start;
+        LatencyHistogram histogram;
+        LatencyHistogram* run_histogram;
+        double threshold;
+        int over_threshold=0;
+    public:
+        DecisionLatency(Board::Board& _active_board,double _threshold,LatencyHistogram* _run_histogram=nullptr);
+        ~DecisionLatency(){};
+
+        std::vector<double> get_values();
+        void update();
+        void after_step();
+        void reset(Board::Board& game_board);
+    };
+
+    class DecisionLatencyConstructor: public MeasurementConstructor{
+        double threshold;
+        LatencyHistogram* run_histogram;
+    public:
+        // (the run histogram is the caller's, and has to outlive the experiment)
+        DecisionLatencyConstructor(double _threshold,LatencyHistogram* _run_histogram=nullptr);
+        ~DecisionLatencyConstructor(){};
+
+        std::vector<std::string> get_value_keys();
+        GameMeasurement* construct_measure(Board::Board& active_board);
+    };
+
 }
 
 #endif
\ No newline at end of file
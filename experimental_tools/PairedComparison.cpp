@@ -0,0 +1,207 @@
+#include <iostream>
+#include <fstream>
+#include <cmath>
+#include <ctime>
+
+#include "../game_files/Debug.h"
+#include "../game_files/Random.h"
+
+#include "Experiments.h"
+
+namespace
+{
+    // Everything one side of the comparison needs to play games
+    struct Side{
+        Experiments::Experiment* exp = nullptr;
+        GameLogic::Game* game = nullptr;
+        Agents::BaseAgent* agent = nullptr;
+        Board::Board* board = nullptr;
+        std::vector<Measurements::GameMeasurement*> measures = {};
+
+        // Column of `metric` in the measurement values (-1 -> use win_lose())
+        int metric_idx = -1;
+    };
+
+    // Play one game on one side, dealing from `chance` (and with the agent drawing from `search`). Returns every measurement value, in log_headers order.
+    std::vector<double> play_side(Side& side,Random::ChanceStreams& chance,Random::Stream& search){
+        Random::SearchScope search_scope(&search);
+        {
+            Random::ChanceScope scope(&chance);
+            if(!side.board){
+                side.board = side.exp -> get_board();
+            } else {
+                side.exp -> reset_board(side.board);
+            }
+        }
+        if(!side.game -> hasBoard()){
+            side.game -> reset_board(side.board);
+        }
+        if(side.measures.empty()){
+            side.measures = side.exp -> get_game_measures(side.board);
+        } else {
+            for(Measurements::GameMeasurement* meas: side.measures){
+                meas -> reset(*side.board);
+            }
+        }
+        side.agent -> reset();
+
+        Experiments::PlayGame(side.game,side.agent,side.measures,&chance);
+
+        std::vector<double> values = {};
+        for(Measurements::GameMeasurement* meas: side.measures){
+            for(double& val: meas -> get_values()){
+                values.push_back(val);
+            }
+        }
+        return values;
+    }
+
+    double mean(std::vector<double>& xs){
+        double total=0;
+        for(double& x: xs){
+            total+=x;
+        }
+        return xs.empty() ? 0 : total/(double) xs.size();
+    }
+
+    // Sample variance (n-1)
+    double variance(std::vector<double>& xs){
+        if(xs.size()<2){
+            return 0;
+        }
+        double m = mean(xs);
+        double total=0;
+        for(double& x: xs){
+            total+=(x-m)*(x-m);
+        }
+        return total/(double) (xs.size()-1);
+    }
+}
+
+void Experiments::RunPairedComparison(Experiment* exp_a,Experiment* exp_b,std::string fileheader,std::string metric,uint64_t seed,int n_games,bool log_output){
+    Side sides[2];
+    sides[0].exp = exp_a;
+    sides[1].exp = exp_b;
+
+    std::string output_str = "Game,Seed";
+    for(int s=0;s<2;s++){
+        sides[s].game = new GameLogic::Game();
+        sides[s].agent = sides[s].exp -> get_agent(sides[s].game);
+
+        std::string prefix = s==0 ? "A_" : "B_";
+        // log_headers ends with BrokeReasons, which isn't a measurement value
+        for(int k=0;k<(int) sides[s].exp -> log_headers.size()-1;k++){
+            std::string key = sides[s].exp -> log_headers[k];
+            output_str+=","+prefix+key;
+            if(key==metric){
+                sides[s].metric_idx = k;
+            }
+        }
+    }
+    output_str+=",A_"+metric+",B_"+metric+",Difference\r\n";
+
+    if(sides[0].metric_idx<0 || sides[1].metric_idx<0){
+        DEBUG_MSG("[Experiments::RunPairedComparison()] " << metric << " isn't measured by both experiments, comparing win/lose instead" << std::endl);
+        metric = "GameWon";
+    }
+
+    DEBUG_MSG("[Experiments::RunPairedComparison()] Comparing " << exp_a -> agent_name << " (A) and " << exp_b -> agent_name << " (B) over " << n_games << " paired games..." << std::endl);
+
+    std::vector<double> metric_a = {};
+    std::vector<double> metric_b = {};
+    std::vector<double> differences = {};
+
+    Random::ChanceStreams chance;
+    Random::Stream search;
+    int log_interval = (n_games/20) > 0 ? (n_games/20) : 1;
+
+    for(int game=0;game<n_games;game++){
+        if(log_output && game % log_interval==0){
+            DEBUG_MSG("[Experiments::RunPairedComparison()] has ran " << game << " paired games (~" << (100*game)/n_games << "% completed)" << std::endl);
+        }
+        uint64_t game_seed = Random::GameSeed(seed,game);
+        output_str+=std::to_string(game+1)+","+std::to_string(game_seed);
+
+        double metric_values[2];
+        for(int s=0;s<2;s++){
+            // Same seed for both sides -> same deck order
+            chance.seed(game_seed);
+            search.seed(Random::SearchSeed(seed,game));
+            std::vector<double> values = play_side(sides[s],chance,search);
+            for(double& val: values){
+                output_str+=","+std::to_string(val);
+            }
+            metric_values[s] = sides[s].metric_idx>=0 ? values[sides[s].metric_idx] : (double) sides[s].board -> win_lose();
+        }
+        metric_a.push_back(metric_values[0]);
+        metric_b.push_back(metric_values[1]);
+        differences.push_back(metric_values[0]-metric_values[1]);
+
+        output_str+=","+std::to_string(metric_values[0])+","+std::to_string(metric_values[1])+","+std::to_string(metric_values[0]-metric_values[1])+"\r\n";
+    }
+
+    std::ofstream logfile(Experiments::OUTPUT_DIR + fileheader + ".csv",std::ios::out | std::ios::trunc);
+    logfile << output_str;
+    logfile.close();
+
+    // Paired estimate: the standard error comes from the per-game differences, so the shared card luck cancels.
+    // The unpaired standard error (what two independent experiments would give) is reported alongside for comparison.
+    double n = (double) n_games;
+    double diff_mean = mean(differences);
+    double paired_se = std::sqrt(variance(differences)/n);
+    double unpaired_se = std::sqrt((variance(metric_a)+variance(metric_b))/n);
+
+    double covariance = 0;
+    double mean_a = mean(metric_a), mean_b = mean(metric_b);
+    for(int game=0;game<n_games;game++){
+        covariance += (metric_a[game]-mean_a)*(metric_b[game]-mean_b);
+    }
+    covariance = n_games>1 ? covariance/(n-1) : 0;
+    double var_product = variance(metric_a)*variance(metric_b);
+    double correlation = var_product>0 ? covariance/std::sqrt(var_product) : 0;
+
+    time_t end_time;
+    struct tm * timeinfo;
+    char buffer[80];
+    time (&end_time);
+    timeinfo = localtime(&end_time);
+    strftime(buffer,sizeof(buffer),"%d-%m-%Y %H:%M:%S",timeinfo);
+
+    std::ofstream header(Experiments::OUTPUT_DIR + fileheader + ".header",std::ios::out | std::ios::trunc);
+    header << "Experiment Name: " << fileheader << std::endl;
+    header << "Experiment Description: Paired comparison on common random numbers (both agents dealt the same cards in each game)" << std::endl << std::endl;
+
+    header << "Scenario Name: " << (*exp_a -> scenario).name << std::endl;
+    header << "Scenario Description: " << (*exp_a -> scenario).description << std::endl << std::endl;
+
+    header << "Agent A Name: " << exp_a -> agent_name << " (from " << exp_a -> experiment_name << ")" << std::endl;
+    header << "Agent B Name: " << exp_b -> agent_name << " (from " << exp_b -> experiment_name << ")" << std::endl << std::endl;
+
+    header << "Seed: " << seed << std::endl;
+    header << "Games: " << n_games << std::endl;
+    header << "Metric: " << metric << std::endl << std::endl;
+
+    header << "==========================================" << std::endl;
+    header << "================ Results =================" << std::endl << std::endl;
+    header << "Mean A: " << mean_a << std::endl;
+    header << "Mean B: " << mean_b << std::endl;
+    header << "Paired Difference (A - B): " << diff_mean << std::endl;
+    header << "Paired Standard Error: " << paired_se << std::endl;
+    header << "Paired 95% Interval: [" << diff_mean - 1.96*paired_se << "," << diff_mean + 1.96*paired_se << "]" << std::endl;
+    header << "Unpaired Standard Error (for reference): " << unpaired_se << std::endl;
+    header << "Correlation between A and B: " << correlation << std::endl << std::endl;
+
+    header << "End Time: " << buffer << std::endl;
+    header.close();
+
+    DEBUG_MSG("[Experiments::RunPairedComparison()] " << metric << " A - B = " << diff_mean << " +/- " << paired_se << " (paired SE; unpaired would be " << unpaired_se << ")" << std::endl);
+
+    for(int s=0;s<2;s++){
+        for(Measurements::GameMeasurement* meas: sides[s].measures){
+            delete meas;
+        }
+        delete sides[s].agent;
+        // (the Game owns its board)
+        delete sides[s].game;
+    }
+}
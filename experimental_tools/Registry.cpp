@@ -0,0 +1,423 @@
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+#include "../game_files/Debug.h"
+
+#include "../agents/UniformRandomAgent.h"
+#include "../agents/ByGroupRandomAgent.h"
+#include "../agents/ListActionRandomAgent.h"
+
+#include "../agents/Rollout_Based_UCT_MCTS/KSample_Naive_UCTAgent.h"
+#include "../agents/Rollout_Based_UCT_MCTS/KSample_Precondition_UCTAgent.h"
+#include "../agents/Rollout_Based_UCT_MCTS/KSample_Subgoal_UCTAgent.h"
+#include "../agents/Rollout_Based_UCT_MCTS/KSample_Naive_UCTMaxChildAgent.h"
+#include "../agents/Rollout_Based_UCT_MCTS/KSample_Precondition_UCTMaxChildAgent.h"
+#include "../agents/Rollout_Based_UCT_MCTS/KSample_Subgoal_UCTMaxChildAgent.h"
+#include "../agents/Rollout_Based_UCT_MCTS/KSample_Precondition_UCTMaxChildAgent_SmartRollout.h"
+
+#include "../agents/HeuristicEval_Based_UCT/KSample_CompoundWL_UCTMaxChildAgent.h"
+#include "../agents/HeuristicEval_Based_UCT/KSample_LossProximity_UCTMaxChildAgent.h"
+#include "../agents/HeuristicEval_Based_UCT/KSample_CurePrecondition_UCTMaxChildAgent.h"
+#include "../agents/HeuristicEval_Based_UCT/KSample_SmartCompoundWL_UCTMaxChildAgent.h"
+#include "../agents/HeuristicEval_Based_UCT/KSample_SmartLossProximity_UCTMaxChildAgent.h"
+
+#include "../agents/ExpectimaxAgent.h"
+
+#include "Registry.h"
+
+namespace
+{
+    // Strip whitespace off both ends
+    std::string trim(std::string str){
+        size_t first = str.find_first_not_of(" \t\r\n");
+        if(first==std::string::npos){
+            return "";
+        }
+        size_t last = str.find_last_not_of(" \t\r\n");
+        return str.substr(first,last-first+1);
+    }
+
+    std::vector<std::string> split(std::string str,char delim){
+        std::vector<std::string> pieces = {};
+        std::stringstream stream(str);
+        std::string piece;
+        while(std::getline(stream,piece,delim)){
+            piece = trim(piece);
+            if(!piece.empty()){
+                pieces.push_back(piece);
+            }
+        }
+        return pieces;
+    }
+
+    // Every search agent takes the same options for its tree (see Search::TreeOptions). Which kind of tree:
+    //      open_loop       (0)         1 for an OpenLoopGameTree, which resamples the draws on every traversal (K, adaptive_k, sampling, rave, widening and macro then don't apply)
+    // a cap on its memory:
+    //      memory_cap_mb   (0, no cap) estimated megabytes the tree may hold
+    //      memory_policy   (prune)     prune | freeze (see Search::MemoryPolicy)
+    //      memory_prune_to (.75)       fraction of the cap to prune back down to
+    // and adaptive determinizations (see Search::AdaptiveDeterminizations), starting from K:
+    //      adaptive_k              (0)     1 to let each chance node add determinizations while its children disagree
+    //      adaptive_k.max          (8)     most determinizations any chance node can have
+    //      adaptive_k.threshold    (.002)  variance of the children's average rewards above which another is added
+    //      adaptive_k.min_visits   (5)     visits every child needs before the variance is judged
+    // and how the determinizations' draws are sampled:
+    //      sampling        (independent)   independent | stratified | antithetic (see Search::DeterminizationSampling)
+    // and RAVE statistics for the tree policy (see Search::RaveOptions):
+    //      rave                (0)             1 to keep AMAF statistics and select with Search::RAVEScore()
+    //      rave.schedule       (equivalence)   equivalence | mse (see Search::RaveSchedule)
+    //      rave.equivalence    (1000)          visits at which a node's own average counts as much as its AMAF average (equivalence)
+    //      rave.bias           (.1)            expected error of AMAF averages (mse)
+    // and progressive widening of decision nodes (see Search::ProgressiveWidening):
+    //      widening                (0)     1 to admit children in order of Search::action_prior() as visits grow, and select with Search::PUCTScore()
+    //      widening.coefficient    (1)     children admitted = max(1,ceil(coefficient * visits^exponent))
+    //      widening.exponent       (.5)
+    //      widening.puct           (1)     weight on the prior-weighted exploration term
+    // and whole-turn decisions (see Search::MacroGameTree and Search::MacroOptions):
+    //      macro           (0)     1 for a MacroGameTree, whose decision nodes choose between plans for the rest of the turn
+    //      macro.samples   (64)    random plans sampled per decision node
+    //      macro.width     (16)    most plans kept per node (best by heuristic)
+    //      macro.alpha     (2/3)   weight of the SmartCompoundHeuristic plans are ranked by
+    template<class SearchAgent>
+    Agents::BaseAgent* with_tree_options(SearchAgent* agent,Registry::Params& params){
+        agent -> tree_options.open_loop = params.get_bool("open_loop",false);
+
+        agent -> tree_options.memory_limit.max_bytes = (long) (params.get_double("memory_cap_mb",0)*1024.*1024.);
+        agent -> tree_options.memory_limit.policy = params.get_string("memory_policy","prune")=="freeze" ? Search::FREEZE : Search::PRUNE;
+        agent -> tree_options.memory_limit.prune_to = params.get_double("memory_prune_to",.75);
+
+        agent -> tree_options.adaptive.enabled = params.get_bool("adaptive_k",false);
+        agent -> tree_options.adaptive.max_K = params.get_int("adaptive_k.max",8);
+        agent -> tree_options.adaptive.variance_threshold = params.get_double("adaptive_k.threshold",.002);
+        agent -> tree_options.adaptive.min_visits = params.get_int("adaptive_k.min_visits",5);
+
+        std::string sampling = params.get_string("sampling","independent");
+        if(sampling=="stratified"){
+            agent -> tree_options.sampling = Search::STRATIFIED;
+        } else if(sampling=="antithetic"){
+            agent -> tree_options.sampling = Search::ANTITHETIC;
+        } else {
+            agent -> tree_options.sampling = Search::INDEPENDENT;
+        }
+
+        agent -> tree_options.rave.enabled = params.get_bool("rave",false);
+        agent -> tree_options.rave.schedule = params.get_string("rave.schedule","equivalence")=="mse" ? Search::MINIMUM_MSE : Search::EQUIVALENCE;
+        agent -> tree_options.rave.equivalence = params.get_double("rave.equivalence",1000);
+        agent -> tree_options.rave.bias = params.get_double("rave.bias",.1);
+
+        agent -> tree_options.widening.enabled = params.get_bool("widening",false);
+        agent -> tree_options.widening.coefficient = params.get_double("widening.coefficient",1);
+        agent -> tree_options.widening.exponent = params.get_double("widening.exponent",.5);
+        agent -> tree_options.widening.puct = params.get_double("widening.puct",1);
+
+        agent -> tree_options.macro.enabled = params.get_bool("macro",false);
+        agent -> tree_options.macro.samples = params.get_int("macro.samples",64);
+        agent -> tree_options.macro.width = params.get_int("macro.width",16);
+        agent -> tree_options.macro.alpha = params.get_double("macro.alpha",2./3.);
+        return agent;
+    }
+
+    // Heuristic-eval agents can take the expectation over the infect draws at chance leaves instead of sampling them:
+    //      infect_outcomes (1, sample)  heuristic evaluations to spend per chance leaf (see Search::expected_heuristic())
+    template<class HeuristicEvalAgent>
+    HeuristicEvalAgent* with_infect_outcomes(HeuristicEvalAgent* agent,Registry::Params& params){
+        agent -> infect_outcomes = std::max(params.get_int("infect_outcomes",1),1);
+        return agent;
+    }
+
+    // ... and remember the values of boards they've already evaluated in a search (see Search::HeuristicCache):
+    //      heuristic_cache             (0)     1 to look leaves up before evaluating them
+    //      heuristic_cache.log2_slots  (16)    cache size (2^log2_slots slots of 24 bytes)
+    template<class HeuristicEvalAgent>
+    HeuristicEvalAgent* with_heuristic_cache(HeuristicEvalAgent* agent,Registry::Params& params){
+        agent -> heuristic_cache.enabled = params.get_bool("heuristic_cache",false);
+        if(params.has("heuristic_cache.log2_slots")){
+            agent -> heuristic_cache.resize(std::min(std::max(params.get_int("heuristic_cache.log2_slots",16),1),30));
+        }
+        return agent;
+    }
+}
+
+// ========== Params ==========
+
+void Registry::Params::set(std::string key,std::string value){
+    values[trim(key)] = trim(value);
+}
+
+bool Registry::Params::has(std::string key){
+    return values.find(key)!=values.end();
+}
+
+std::string Registry::Params::get_string(std::string key,std::string fallback){
+    return has(key) ? values[key] : fallback;
+}
+
+int Registry::Params::get_int(std::string key,int fallback){
+    return has(key) ? std::stoi(values[key]) : fallback;
+}
+
+long Registry::Params::get_long(std::string key,long fallback){
+    return has(key) ? std::stol(values[key]) : fallback;
+}
+
+double Registry::Params::get_double(std::string key,double fallback){
+    return has(key) ? std::stod(values[key]) : fallback;
+}
+
+bool Registry::Params::get_bool(std::string key,bool fallback){
+    if(!has(key)){
+        return fallback;
+    }
+    std::string val = values[key];
+    return val=="1" || val=="true" || val=="yes" || val=="on";
+}
+
+std::vector<int> Registry::Params::get_ints(std::string key,std::vector<int> fallback){
+    if(!has(key)){
+        return fallback;
+    }
+    std::vector<int> out = {};
+    for(std::string& piece: split(values[key],',')){
+        out.push_back(std::stoi(piece));
+    }
+    return out;
+}
+
+std::vector<std::string> Registry::Params::get_strings(std::string key,std::vector<std::string> fallback){
+    return has(key) ? split(values[key],',') : fallback;
+}
+
+std::vector<std::string> Registry::Params::keys(){
+    std::vector<std::string> out = {};
+    for(auto& entry: values){
+        out.push_back(entry.first);
+    }
+    return out;
+}
+
+bool Registry::Params::read_file(std::string path){
+    std::ifstream config(path);
+    if(!config.is_open()){
+        DEBUG_MSG("[Registry::Params::read_file()] Couldn't open config file " << path << std::endl);
+        return false;
+    }
+    std::string line;
+    int line_number=0;
+    bool ok=true;
+    while(std::getline(config,line)){
+        line_number++;
+        // Drop comments
+        line = trim(line.substr(0,line.find('#')));
+        if(line.empty()){
+            continue;
+        }
+        size_t eq = line.find('=');
+        if(eq==std::string::npos){
+            DEBUG_MSG("[Registry::Params::read_file()] " << path << ":" << line_number << " has no '=': " << line << std::endl);
+            ok=false;
+            continue;
+        }
+        set(line.substr(0,eq),line.substr(eq+1));
+    }
+    return ok;
+}
+
+bool Registry::Params::read_args(int argc,char** argv){
+    bool ok=true;
+    for(int i=1;i<argc;i++){
+        std::string arg = argv[i];
+        if(arg.rfind("--",0)!=0){
+            DEBUG_MSG("[Registry::Params::read_args()] Ignoring argument without leading '--': " << arg << std::endl);
+            ok=false;
+            continue;
+        }
+        arg = arg.substr(2);
+        size_t eq = arg.find('=');
+        std::string key = eq==std::string::npos ? arg : arg.substr(0,eq);
+        std::string value = eq==std::string::npos ? "1" : arg.substr(eq+1);
+
+        if(key=="config"){
+            ok = read_file(value) && ok;
+        }
+        set(key,value);
+    }
+    return ok;
+}
+
+// ========== Registered objects ==========
+
+// Agent parameters (with the defaults each constructor would use):
+//      n_simulations   (1000)  simulations per step
+//      K               (1)     determinizations per stochasticity
+//      convergence     (100)   visits for a node to count as converged in max-child selection
+//      alpha           (.5)    weight on the first heuristic of a compound heuristic
+//      epsilon         (.1)    chance of a random action in an epsilon-greedy rollout
+//      time_budget     (1)     seconds per step (expectimax)
+//      max_depth       (20)    deepest iteration, in player decisions (expectimax)
+//      open_loop                                       open-loop search tree (see with_tree_options() above)
+//      memory_cap_mb, memory_policy, memory_prune_to   search tree memory cap (see with_tree_options() above)
+//      adaptive_k, adaptive_k.*                        adaptive determinizations per chance node (see with_tree_options() above)
+//      sampling                                        independent | stratified | antithetic determinization draws (see with_tree_options() above)
+//      rave, rave.*                                    RAVE/AMAF statistics in the tree policy (see with_tree_options() above)
+//      widening, widening.*                            progressive widening with PUCT selection (see with_tree_options() above)
+//      macro, macro.*                                  turn-plan decisions (see with_tree_options() above)
+//      infect_outcomes                                 expected evaluation of chance leaves (heuristic-eval agents, see with_infect_outcomes() above)
+//      heuristic_cache, heuristic_cache.log2_slots     cache of leaf evaluations (heuristic-eval agents, see with_heuristic_cache() above)
+const std::map<std::string,Registry::AgentMaker*>& Registry::agents(){
+    static const std::map<std::string,AgentMaker*> AGENTS = {
+        {"UniformRandom",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return new Agents::UniformRandomAgent(game);
+        }},
+        {"ByGroupRandom",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return new Agents::ByGroupRandomAgent(game);
+        }},
+        {"ListActionRandom",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return new Agents::ListActionRandomAgent(game);
+        }},
+        {"Naive_UCT",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(new Agents::KSample_Naive_UCTAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1)),params);
+        }},
+        {"Precondition_UCT",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(new Agents::KSample_Precondition_UCTAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1)),params);
+        }},
+        {"Subgoal_UCT",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(new Agents::KSample_Subgoal_UCTAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1)),params);
+        }},
+        {"Naive_UCTMaxChild",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(new Agents::KSample_Naive_UCTMaxChildAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1),params.get_int("convergence",100)),params);
+        }},
+        {"Precondition_UCTMaxChild",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(new Agents::KSample_Precondition_UCTMaxChildAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1),params.get_int("convergence",100)),params);
+        }},
+        {"Subgoal_UCTMaxChild",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(new Agents::KSample_Subgoal_UCTMaxChildAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1),params.get_int("convergence",100)),params);
+        }},
+        {"Precondition_UCTMaxChild_SmartRollout",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(new Agents::KSample_Precondition_UCTMaxChildAgent_SmartRollout(game,params.get_int("n_simulations",1000),params.get_int("K",1),params.get_double("epsilon",.1),params.get_int("convergence",100)),params);
+        }},
+        {"CompoundWL_UCTMaxChild",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(with_heuristic_cache(with_infect_outcomes(new Agents::KSample_CompoundWL_UCTMaxChildAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1),params.get_int("convergence",100)),params),params),params);
+        }},
+        {"LossProximity_UCTMaxChild",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(with_heuristic_cache(with_infect_outcomes(new Agents::KSample_LossProximity_UCTMaxChildAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1),params.get_int("convergence",100)),params),params),params);
+        }},
+        {"CurePrecondition_UCTMaxChild",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(with_heuristic_cache(with_infect_outcomes(new Agents::KSample_CurePrecondition_UCTMaxChildAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1),params.get_int("convergence",100)),params),params),params);
+        }},
+        {"SmartCompoundWL_UCTMaxChild",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(with_heuristic_cache(with_infect_outcomes(new Agents::KSample_SmartCompoundWL_UCTMaxChildAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1),params.get_double("alpha",.5),params.get_int("convergence",100)),params),params),params);
+        }},
+        {"SmartLossProximity_UCTMaxChild",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return with_tree_options(with_heuristic_cache(with_infect_outcomes(new Agents::KSample_SmartLossProximity_UCTMaxChildAgent(game,params.get_int("n_simulations",1000),params.get_int("K",1),params.get_int("convergence",100)),params),params),params);
+        }},
+        {"SmartCompoundWL_Expectimax",[](GameLogic::Game& game,Params& params) -> Agents::BaseAgent* {
+            return new Agents::ExpectimaxAgent(game,params.get_double("time_budget",1),params.get_int("max_depth",20),params.get_double("alpha",.5));
+        }},
+    };
+    return AGENTS;
+}
+
+const std::map<std::string,Registry::ScenarioMaker*>& Registry::scenarios(){
+    static const std::map<std::string,ScenarioMaker*> SCENARIOS = {
+        {"VanillaGame",[]() -> Scenarios::Scenario* {return new Scenarios::VanillaGameScenario();}},
+        {"ForcedDiscard",[]() -> Scenarios::Scenario* {return new Scenarios::ForcedDiscardScenario();}},
+        {"BusyBoard",[]() -> Scenarios::Scenario* {return new Scenarios::BusyBoardScenario();}},
+        {"CanWin",[]() -> Scenarios::Scenario* {return new Scenarios::CanWinScenario();}},
+    };
+    return SCENARIOS;
+}
+
+const std::map<std::string,Registry::MeasurementMaker*>& Registry::measurements(){
+    static const std::map<std::string,MeasurementMaker*> MEASUREMENTS = {
+        {"WinLose",[](Params& params) -> Measurements::MeasurementConstructor* {return new Measurements::WinLoseConstructor();}},
+        {"LoseStatus",[](Params& params) -> Measurements::MeasurementConstructor* {return new Measurements::LoseStatusConstructor();}},
+        {"GameTreeSize",[](Params& params) -> Measurements::MeasurementConstructor* {return new Measurements::GameTreeSizeConstructor();}},
+        {"EventCardUse",[](Params& params) -> Measurements::MeasurementConstructor* {return new Measurements::EventCardUseConstructor();}},
+        {"ActionCount",[](Params& params) -> Measurements::MeasurementConstructor* {return new Measurements::ActionCountConstructor();}},
+        {"CuredDisease",[](Params& params) -> Measurements::MeasurementConstructor* {return new Measurements::CuredDiseaseConstructor();}},
+        {"EradicatedDisease",[](Params& params) -> Measurements::MeasurementConstructor* {return new Measurements::EradicatedDiseaseConstructor();}},
+        {"EpidemicsDrawn",[](Params& params) -> Measurements::MeasurementConstructor* {return new Measurements::EpidemicsDrawnConstructor();}},
+        {"ResearchStations",[](Params& params) -> Measurements::MeasurementConstructor* {return new Measurements::ResearchStationsConstructor();}},
+        {"TimeTaken",[](Params& params) -> Measurements::MeasurementConstructor* {return new Measurements::TimeTakenConstructor();}},
+        {"DecisionLatency",[](Params& params) -> Measurements::MeasurementConstructor* {
+            return new Measurements::DecisionLatencyConstructor(params.get_double("latency.threshold",1));
+        }},
+    };
+    return MEASUREMENTS;
+}
+
+Agents::BaseAgent* Registry::make_agent(std::string name,GameLogic::Game& game,Params& params){
+    auto found = agents().find(name);
+    if(found==agents().end()){
+        DEBUG_MSG("[Registry::make_agent()] No agent registered as " << name << std::endl);
+        return nullptr;
+    }
+    return found -> second(game,params);
+}
+
+Scenarios::Scenario* Registry::make_scenario(std::string name){
+    auto found = scenarios().find(name);
+    if(found==scenarios().end()){
+        DEBUG_MSG("[Registry::make_scenario()] No scenario registered as " << name << std::endl);
+        return nullptr;
+    }
+    return found -> second();
+}
+
+Measurements::MeasurementConstructor* Registry::make_measurement(std::string name,Params& params){
+    auto found = measurements().find(name);
+    if(found==measurements().end()){
+        DEBUG_MSG("[Registry::make_measurement()] No measurement registered as " << name << std::endl);
+        return nullptr;
+    }
+    return found -> second(params);
+}
+
+StoppingRules::StoppingRule* Registry::make_stopping_rule(Params& params){
+    if(!params.has("stop.rule")){
+        return nullptr;
+    }
+    std::string rule = params.get_string("stop.rule");
+    int min_games = params.get_int("stop.min_games",20);
+    int max_games = params.get_int("stop.max_games",params.get_int("n_games",100));
+
+    if(rule=="wilson"){
+        return new StoppingRules::WilsonWidthRule(params.get_double("stop.width",.1),params.get_double("stop.z",1.96),params.get_double("stop.reference",-1),min_games,max_games);
+    }
+    if(rule=="sprt"){
+        double reference = params.get_double("stop.reference",.5);
+        double delta = params.get_double("stop.delta",.05);
+        // Keep both hypotheses strictly inside (0,1) so the log-likelihood ratio stays finite
+        double p0 = std::max(.001,std::min(.999,params.get_double("stop.p0",reference-delta)));
+        double p1 = std::max(.001,std::min(.999,params.get_double("stop.p1",reference+delta)));
+        return new StoppingRules::SPRTRule(p0,p1,params.get_double("stop.alpha",.05),params.get_double("stop.beta",.05),min_games,max_games);
+    }
+    DEBUG_MSG("[Registry::make_stopping_rule()] Unknown stopping rule " << rule << std::endl);
+    return nullptr;
+}
+
+std::vector<std::string> Registry::agent_names(){
+    std::vector<std::string> names = {};
+    for(auto& entry: agents()){
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+std::vector<std::string> Registry::scenario_names(){
+    std::vector<std::string> names = {};
+    for(auto& entry: scenarios()){
+        names.push_back(entry.first);
+    }
+    return names;
+}
+
+std::vector<std::string> Registry::measurement_names(){
+    std::vector<std::string> names = {};
+    for(auto& entry: measurements()){
+        names.push_back(entry.first);
+    }
+    return names;
+}
@@ -0,0 +1,94 @@
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../agents/Agents.h"
+
+#include "Scenarios.h"
+#include "Measurements.h"
+#include "StoppingRules.h"
+
+// Everything needed to put together an experiment from strings instead of from a hard-coded Experiment class.
+// Agents, scenarios and measurements are looked up by name, and agent parameters come out of a Params bag.
+namespace Registry
+{
+    // A bag of `key = value` strings, read from a config file and/or `--key=value` command line arguments
+    // Getters all take a fallback that's returned when the key was never set
+    class Params{
+        std::map<std::string,std::string> values;
+    public:
+        Params(){};
+
+        void set(std::string key,std::string value);
+        bool has(std::string key);
+
+        std::string get_string(std::string key,std::string fallback="");
+        int get_int(std::string key,int fallback=0);
+        long get_long(std::string key,long fallback=0);
+        double get_double(std::string key,double fallback=0);
+        bool get_bool(std::string key,bool fallback=false);
+
+        // Comma-separated lists, e.g. `roles = 1,2,3`
+        std::vector<int> get_ints(std::string key,std::vector<int> fallback={});
+        std::vector<std::string> get_strings(std::string key,std::vector<std::string> fallback={});
+
+        // All keys that have been set (sorted, since it's a std::map)
+        std::vector<std::string> keys();
+
+        // Read a config file of `key = value` lines. Blank lines and anything after a '#' are ignored.
+        // Returns false if the file couldn't be opened or a non-blank line had no '='
+        bool read_file(std::string path);
+
+        // Read `--key=value` arguments. `--config=path` is read in place, so anything after it on the command line overrides the file.
+        // A bare `--flag` is stored as `flag = 1`
+        bool read_args(int argc,char** argv);
+    };
+
+    // Measurements taken when a config doesn't list any, in the same order the hand-written experiments use
+    inline const std::vector<std::string> DEFAULT_MEASUREMENTS = {
+        "WinLose",
+        "LoseStatus",
+        "EventCardUse",
+        "ActionCount",
+        "EradicatedDisease",
+        "EpidemicsDrawn",
+        "CuredDisease",
+        "ResearchStations",
+        "GameTreeSize",
+        "TimeTaken"
+    };
+
+    // Makers for each kind of registered object
+    // (captureless lambdas in Registry.cpp convert to these)
+    typedef Agents::BaseAgent* AgentMaker(GameLogic::Game& game,Params& params);
+    typedef Scenarios::Scenario* ScenarioMaker();
+    typedef Measurements::MeasurementConstructor* MeasurementMaker(Params& params);
+
+    // Name -> maker tables. New agents/scenarios/measurements just need an entry in Registry.cpp
+    const std::map<std::string,AgentMaker*>& agents();
+    const std::map<std::string,ScenarioMaker*>& scenarios();
+    const std::map<std::string,MeasurementMaker*>& measurements();
+
+    // Construct by name. All return nullptr if the name isn't registered.
+    Agents::BaseAgent* make_agent(std::string name,GameLogic::Game& game,Params& params);
+    Scenarios::Scenario* make_scenario(std::string name);
+    Measurements::MeasurementConstructor* make_measurement(std::string name,Params& params);
+
+    // Early stopping rule from `stop.*` keys, or nullptr if there's no `stop.rule`:
+    //      stop.rule       wilson | sprt
+    //      stop.min_games  (20) / stop.max_games (n_games)
+    //      wilson: stop.width (.1), stop.z (1.96), stop.reference (none)
+    //      sprt:   stop.p0/stop.p1, or stop.reference +/- stop.delta (.05); stop.alpha (.05), stop.beta (.05)
+    StoppingRules::StoppingRule* make_stopping_rule(Params& params);
+
+    // Names of everything registered, for `--list`
+    std::vector<std::string> agent_names();
+    std::vector<std::string> scenario_names();
+    std::vector<std::string> measurement_names();
+}
+
+#endif
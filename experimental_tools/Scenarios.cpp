@@ -1,6 +1,7 @@
 #include "Scenarios.h"
 
 #include "../game_files/Board.h"
+#include "../game_files/Random.h"
 
 Scenarios::Scenario::Scenario(std::string _name,std::string desc){
     name = _name;
@@ -54,6 +55,9 @@ void Scenarios::ForcedDiscardScenario::reset_board(Board::Board* game_board,bool
     for(int& card: game_board -> active_player().event_cards){
         DEBUG_MSG(std::endl << "[Scenarios::ForcedDiscardScenario()] "<< game_board -> active_player().role.name << " has event card: " << Decks::CARD_NAME(card));
     }
+
+    // (the hands above can change what comes next)
+    game_board -> update_phase();
 }
 
 // "BusyBoard" scenario - research stations for moving around & cards for building new ones
@@ -71,7 +75,8 @@ Board::Board* Scenarios::BusyBoardScenario::make_board(std::vector<int> roles,in
 void Scenarios::BusyBoardScenario::reset_board(Board::Board* game_board,bool verbose){
     game_board -> clear();
     // Put 6 research stations more-or-less next to eachother on the board somewhere;
-    int random_city = rand() % Map::CITIES.size();
+    // (drawn from the player deck stream so that seeded experiments get the same cluster every time)
+    int random_city = Random::player_chance() % Map::CITIES.size();
 
     // This doesn't make sense, but somehow arranging it this way actually forces the compiler to stop ignoring these commands
     game_board -> AddStation(random_city);
@@ -111,6 +116,8 @@ void Scenarios::BusyBoardScenario::reset_board(Board::Board* game_board,bool ver
     }
 
     game_board -> is_setup();
+
+    game_board -> update_phase();
 }
 
 // "Can Win" scenario - put the players in a near-win scenario and see if they can win
@@ -269,4 +276,6 @@ void Scenarios::CanWinScenario::reset_board(Board::Board* game_board,bool verbos
     game_board -> updatePlayerDeck(12+36,true);
 
     game_board -> setup_player_deck();
+
+    game_board -> update_phase();
 }
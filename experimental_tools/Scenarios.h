@@ -21,6 +21,7 @@ namespace Scenarios
         // generate a new board that's already setup
         virtual Board::Board* make_board(std::vector<int> roles,int _difficulty,bool verbose=false)=0;
         // Set an existing board to a state that would otherwise be generated by make_board()
+        // (if it changes the board after setup(), it has to finish with update_phase())
         virtual void reset_board(Board::Board* game_board,bool verbose=false)=0;
     };
     
@@ -0,0 +1,121 @@
+#include <cmath>
+#include <sstream>
+
+#include "StoppingRules.h"
+
+StoppingRules::StoppingRule::StoppingRule(std::string _name,std::string desc,int _min_games,int _max_games){
+    name = _name;
+    description = desc;
+    min_games = _min_games;
+    max_games = _max_games;
+}
+
+bool StoppingRules::StoppingRule::update(int wins,int games){
+    if(games<min_games){
+        return false;
+    }
+    if(test(wins,games)){
+        return true;
+    }
+    if(games>=max_games){
+        reason = "Reached maximum of " + std::to_string(max_games) + " games";
+        return true;
+    }
+    return false;
+}
+
+void StoppingRules::StoppingRule::reset(){
+    reason = "";
+}
+
+void StoppingRules::WilsonInterval(int wins,int games,double z,double& lower,double& upper){
+    if(games==0){
+        lower = 0;
+        upper = 1;
+        return;
+    }
+    double n = (double) games;
+    double p = (double) wins/n;
+    double z2 = z*z;
+
+    double center = (p + z2/(2*n))/(1 + z2/n);
+    double half_width = (z/(1 + z2/n)) * std::sqrt(p*(1-p)/n + z2/(4*n*n));
+
+    lower = center - half_width;
+    upper = center + half_width;
+}
+
+// ===== Wilson interval width =====
+StoppingRules::WilsonWidthRule::WilsonWidthRule(double _width,double _z,double _reference,int _min_games,int _max_games):
+    StoppingRule("Wilson Interval","Stop when the Wilson score interval on win rate is narrower than a width, or excludes a reference win rate",_min_games,_max_games)
+{
+    width = _width;
+    z = _z;
+    reference = _reference;
+
+    std::stringstream desc;
+    desc << " (width " << width << ", z " << z;
+    if(reference>=0 && reference<=1){
+        desc << ", reference " << reference;
+    }
+    desc << ", " << min_games << "-" << max_games << " games)";
+    description += desc.str();
+}
+
+bool StoppingRules::WilsonWidthRule::test(int wins,int games){
+    double lower, upper;
+    WilsonInterval(wins,games,z,lower,upper);
+
+    std::stringstream interval;
+    interval << "[" << lower << "," << upper << "] after " << games << " games (" << wins << " wins)";
+
+    if(reference>=0 && reference<=1){
+        if(upper<reference){
+            reason = "Wilson interval " + interval.str() + " is below the reference win rate";
+            return true;
+        }
+        if(lower>reference){
+            reason = "Wilson interval " + interval.str() + " is above the reference win rate";
+            return true;
+        }
+    }
+    if(upper-lower<=width){
+        reason = "Wilson interval " + interval.str() + " is narrower than the target width";
+        return true;
+    }
+    return false;
+}
+
+// ===== SPRT =====
+StoppingRules::SPRTRule::SPRTRule(double _p0,double _p1,double _alpha,double _beta,int _min_games,int _max_games):
+    StoppingRule("SPRT","Sequential probability ratio test between two win rates",_min_games,_max_games)
+{
+    p0 = _p0;
+    p1 = _p1;
+    alpha = _alpha;
+    beta = _beta;
+
+    lower_bound = std::log(beta/(1-alpha));
+    upper_bound = std::log((1-beta)/alpha);
+
+    std::stringstream desc;
+    desc << " (H0: p=" << p0 << ", H1: p=" << p1 << ", alpha " << alpha << ", beta " << beta << ", " << min_games << "-" << max_games << " games)";
+    description += desc.str();
+}
+
+bool StoppingRules::SPRTRule::test(int wins,int games){
+    double llr = (double) wins * std::log(p1/p0) + (double) (games-wins) * std::log((1-p1)/(1-p0));
+
+    std::stringstream summary;
+    summary << "log-likelihood ratio " << llr << " after " << games << " games (" << wins << " wins)";
+
+    if(llr>=upper_bound){
+        reason = "SPRT accepted H1 (win rate ~" + std::to_string(p1) + "): " + summary.str();
+        return true;
+    }
+    if(llr<=lower_bound){
+        reason = "SPRT accepted H0 (win rate ~" + std::to_string(p0) + "): " + summary.str();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,71 @@
+#ifndef STOPPINGRULES_H
+#define STOPPINGRULES_H
+
+#include <string>
+
+// Rules for ending an experiment early based on the win/lose record so far.
+// RunExperiment() asks the experiment's rule after every game whether it's seen enough.
+// Most of our configurations are either hopeless (~0% wins) or clearly separated from whatever they're compared to long before 100 games.
+namespace StoppingRules
+{
+    class StoppingRule{
+    public:
+        StoppingRule(std::string _name,std::string desc,int _min_games,int _max_games);
+        virtual ~StoppingRule(){};
+
+        std::string name;
+        std::string description;
+
+        // Never stop before min_games, always stop at max_games
+        int min_games;
+        int max_games;
+
+        // Why the experiment stopped (empty until update() returns true)
+        std::string reason = "";
+
+        // Called after every game with the running totals. Returns true (and sets `reason`) when the experiment should stop.
+        bool update(int wins,int games);
+
+        // Clear `reason` to re-use the rule on another experiment
+        void reset();
+
+    protected:
+        // The rule itself, only consulted between min_games and max_games. Sets `reason` if it returns true.
+        virtual bool test(int wins,int games)=0;
+    };
+
+    // Wilson score interval for a binomial proportion (at normal quantile z)
+    void WilsonInterval(int wins,int games,double z,double& lower,double& upper);
+
+    // Stop once the Wilson interval on the win rate is narrower than `width`,
+    // or (if reference is in [0,1]) as soon as the interval no longer contains the reference win rate.
+    class WilsonWidthRule: public StoppingRule{
+        double width;
+        double z;
+        double reference;
+    public:
+        WilsonWidthRule(double _width,double _z,double _reference,int _min_games,int _max_games);
+        ~WilsonWidthRule(){};
+    protected:
+        bool test(int wins,int games);
+    };
+
+    // Wald's sequential probability ratio test of H0: p = p0 against H1: p = p1 (p0 < p1),
+    // with type I/II error rates alpha/beta. Stops as soon as the log-likelihood ratio leaves (log(beta/(1-alpha)), log((1-beta)/alpha)).
+    class SPRTRule: public StoppingRule{
+        double p0;
+        double p1;
+        double alpha;
+        double beta;
+
+        double lower_bound;
+        double upper_bound;
+    public:
+        SPRTRule(double _p0,double _p1,double _alpha,double _beta,int _min_games,int _max_games);
+        ~SPRTRule(){};
+    protected:
+        bool test(int wins,int games);
+    };
+}
+
+#endif
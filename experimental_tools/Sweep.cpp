@@ -0,0 +1,164 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../game_files/Debug.h"
+
+#include "Sweep.h"
+
+namespace
+{
+    const std::string SWEEP_PREFIX = "sweep.";
+
+    // e.g. 3725 -> "1h02m05s"
+    std::string format_seconds(double seconds){
+        long total = (long) (seconds + .5);
+        long hours = total/3600;
+        long minutes = (total % 3600)/60;
+        long secs = total % 60;
+
+        char buffer[32];
+        if(hours>0){
+            snprintf(buffer,sizeof(buffer),"%ldh%02ldm%02lds",hours,minutes,secs);
+        } else if(minutes>0){
+            snprintf(buffer,sizeof(buffer),"%ldm%02lds",minutes,secs);
+        } else {
+            snprintf(buffer,sizeof(buffer),"%lds",secs);
+        }
+        return std::string(buffer);
+    }
+}
+
+bool Experiments::IsSweep(Registry::Params& params){
+    for(std::string& key: params.keys()){
+        if(key.rfind(SWEEP_PREFIX,0)==0){
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<Experiments::SweepCell> Experiments::ExpandSweep(Registry::Params& params){
+    // Start with the single base configuration and multiply it out by each swept key
+    std::vector<SweepCell> cells = {{params,"",0}};
+
+    for(std::string& key: params.keys()){
+        if(key.rfind(SWEEP_PREFIX,0)!=0){
+            continue;
+        }
+        std::string swept_key = key.substr(SWEEP_PREFIX.size());
+
+        std::vector<SweepCell> expanded = {};
+        for(SweepCell& cell: cells){
+            for(std::string& value: params.get_strings(key)){
+                SweepCell new_cell = cell;
+                new_cell.params.set(swept_key,value);
+                new_cell.suffix += "_" + swept_key + value;
+                expanded.push_back(new_cell);
+            }
+        }
+        cells = expanded;
+    }
+
+    std::string base_name = params.get_string("name",params.get_string("agent")+"Experiment");
+    std::string base_fileheader = params.get_string("fileheader",base_name);
+    for(SweepCell& cell: cells){
+        cell.params.set("name",base_name + cell.suffix);
+        cell.params.set("fileheader",base_fileheader + cell.suffix);
+
+        // Search agents spend ~all their time in simulations, and the random agents cost ~nothing
+        cell.cost = (double) cell.params.get_int("n_games",100) * (double) cell.params.get_int("n_simulations",1);
+    }
+    return cells;
+}
+
+Experiments::SweepCellProgress::SweepCellProgress(std::mutex& _print_lock,std::string _cell_name,int _cell_number,int _n_cells,int _n_games):
+    print_lock(_print_lock)
+{
+    cell_name = _cell_name;
+    cell_number = _cell_number;
+    n_cells = _n_cells;
+    n_games = _n_games;
+
+    // Every 5% of games, same as RunExperiment()
+    log_interval = (n_games/20) > 0 ? (n_games/20) : 1;
+}
+
+void Experiments::SweepCellProgress::game_finished(Experiment* exp,int games_played,double game_seconds){
+    total_seconds += game_seconds;
+
+    if(games_played % log_interval==0 || games_played==n_games){
+        double per_game = total_seconds/(double) games_played;
+        double eta = per_game * (double) (n_games - games_played);
+
+        std::lock_guard<std::mutex> lock(print_lock);
+        DEBUG_MSG("[Experiments::RunSweep()] cell " << cell_number << "/" << n_cells << " (" << cell_name << "): "
+            << games_played << "/" << n_games << " games, " << per_game << "s/game, ETA " << format_seconds(eta) << std::endl);
+    }
+}
+
+void Experiments::RunSweep(Registry::Params& params){
+    std::vector<SweepCell> cells = ExpandSweep(params);
+
+    // Most expensive first, so the makespan isn't decided by one huge cell starting last
+    std::stable_sort(cells.begin(),cells.end(),[](const SweepCell& a,const SweepCell& b){
+        return a.cost > b.cost;
+    });
+
+    int n_threads = params.get_int("threads",(int) std::thread::hardware_concurrency());
+    if(n_threads<1){
+        n_threads=1;
+    }
+    n_threads = std::min(n_threads,(int) cells.size());
+
+    DEBUG_MSG("[Experiments::RunSweep()] Running " << cells.size() << " cells on " << n_threads << " threads" << std::endl);
+    // A seeded cell plays every game on its own random streams (see Random::SearchScope), so it comes out the same on whichever thread runs it.
+    // Unseeded cells all share rand(), and so depend on how the threads interleave.
+    if(n_threads>1 && std::any_of(cells.begin(),cells.end(),[](SweepCell& cell){return !cell.params.has("seed");})){
+        DEBUG_MSG("[Experiments::RunSweep()] Some cells have no seed: their results won't be reproducible with more than one thread" << std::endl);
+    }
+    for(int i=0;i<(int) cells.size();i++){
+        DEBUG_MSG("    " << i+1 << ": " << cells[i].params.get_string("name") << " (cost " << cells[i].cost << ")" << std::endl);
+    }
+
+    std::chrono::steady_clock::time_point sweep_start = std::chrono::steady_clock::now();
+
+    // The shared queue is just an index into the sorted cells
+    std::atomic<int> next_cell(0);
+    std::mutex print_lock;
+
+    auto worker = [&](){
+        while(true){
+            int cell_idx = next_cell++;
+            if(cell_idx >= (int) cells.size()){
+                break;
+            }
+            SweepCell& cell = cells[cell_idx];
+
+            Experiments::ConfiguredExperiment experiment(cell.params);
+            if(!experiment.valid){
+                std::lock_guard<std::mutex> lock(print_lock);
+                DEBUG_MSG("[Experiments::RunSweep()] Skipping cell " << cell.params.get_string("name") << ": configuration didn't resolve" << std::endl);
+                continue;
+            }
+
+            // (with a stopping rule the ETA is for the worst case of playing all max_games)
+            int cell_games = experiment.stopping_rule ? experiment.stopping_rule -> max_games : experiment.n_games;
+            SweepCellProgress progress(print_lock,experiment.experiment_name,cell_idx+1,(int) cells.size(),cell_games);
+            Experiments::RunExperiment(&experiment,false,&progress);
+        }
+    };
+
+    std::vector<std::thread> workers = {};
+    for(int t=0;t<n_threads;t++){
+        workers.push_back(std::thread(worker));
+    }
+    for(std::thread& thread: workers){
+        thread.join();
+    }
+
+    std::chrono::duration<double> sweep_time = std::chrono::steady_clock::now() - sweep_start;
+    DEBUG_MSG("[Experiments::RunSweep()] Finished " << cells.size() << " cells in " << format_seconds(sweep_time.count()) << std::endl);
+}
@@ -0,0 +1,60 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+#include "Experiments.h"
+#include "Registry.h"
+
+// Parameter sweeps: one process running every cell of a grid (e.g. K x n_simulations) on a shared work queue.
+//
+// A sweep is an ordinary ExperimentRunner config plus one or more `sweep.<key> = v1,v2,...` lines, e.g.
+//      sweep.K = 1,3,5
+//      sweep.n_simulations = 500,5000,20000
+// which runs 9 ConfiguredExperiments, each writing its own results/<name>_K<k>_n_simulations<n>.{header,csv}
+namespace Experiments
+{
+    // One configuration of the grid
+    struct SweepCell{
+        Registry::Params params;
+
+        // Appended to the experiment name/fileheader, e.g. "_K3_n_simulations5000"
+        std::string suffix;
+
+        // Rough relative cost (n_games * n_simulations), only used to order the queue
+        double cost;
+    };
+
+    // Expand every `sweep.<key>` entry into the cartesian product of configurations (a single cell if there are none)
+    std::vector<SweepCell> ExpandSweep(Registry::Params& params);
+
+    // Whether any `sweep.<key>` entries exist
+    bool IsSweep(Registry::Params& params);
+
+    // Per-cell progress: prints games done, average time per game and ETA for the cell every `log_interval` games.
+    // Each running cell has its own reporter, but they all print under the same lock so lines don't interleave.
+    class SweepCellProgress: public ProgressReporter{
+        std::mutex& print_lock;
+
+        std::string cell_name;
+        int cell_number;
+        int n_cells;
+
+        int n_games;
+        int log_interval;
+        double total_seconds=0;
+    public:
+        SweepCellProgress(std::mutex& _print_lock,std::string _cell_name,int _cell_number,int _n_cells,int _n_games);
+        ~SweepCellProgress(){};
+
+        void game_finished(Experiment* exp,int games_played,double game_seconds);
+    };
+
+    // Run every cell of the sweep on `threads` worker threads (default: hardware concurrency).
+    // Cells are handed out most-expensive-first from one queue so that long cells don't end up running alone at the end.
+    void RunSweep(Registry::Params& params);
+}
+
+#endif
@@ -0,0 +1,125 @@
+#include <iostream>
+#include <chrono>
+#include <ctime>
+
+#include "../experimental_tools/Experiments.h"
+#include "../experimental_tools/Registry.h"
+#include "../experimental_tools/Sweep.h"
+
+// One binary for every experiment: the agent, scenario, measurements, etc. are all read from a config file and/or the command line.
+// e.g.
+//      experiments/ExperimentRunner.out --config=experiments/configs/K3_500_SmartWeightedCompoundHeuristic_UCTMaxChild.cfg
+//      experiments/ExperimentRunner.out --agent=ByGroupRandom --n_games=1000 --name=ByGroupRandomAgentGameExperiment
+// Arguments are read left to right, so anything after --config overrides what's in the file.
+// If the config has any `sweep.<key> = a,b,c` entries the whole grid is run instead (see Sweep.h), with `threads` workers.
+// With `mode=paired` two agents are compared on the same cards (see Experiments::RunPairedComparison):
+// the base keys describe agent A, and `b.<key>` entries override them for agent B.
+// `--list` prints everything that's registered and exits.
+
+void print_usage(){
+    std::cout << "Usage: ExperimentRunner.out [--config=<file>] [--<key>=<value> ...] [--list]" << std::endl;
+    std::cout << "Keys: name, description, fileheader, agent, scenario, roles, difficulty, measurements, n_games, seed," << std::endl;
+    std::cout << "      plus any agent parameters (n_simulations, K, convergence, alpha, epsilon)" << std::endl;
+    std::cout << "Sweeps: sweep.<key>=<v1>,<v2>,... (any number of keys), threads=<n>" << std::endl;
+    std::cout << "Paired comparison: mode=paired, b.<key>=<value> (agent B's overrides), paired.metric=<measurement key>" << std::endl;
+    std::cout << "Early stopping: stop.rule=wilson|sprt, stop.min_games, stop.max_games, stop.width, stop.reference, stop.p0, stop.p1, ..." << std::endl;
+}
+
+void print_registered(){
+    std::cout << "Agents:" << std::endl;
+    for(std::string& name: Registry::agent_names()){
+        std::cout << "    " << name << std::endl;
+    }
+    std::cout << "Scenarios:" << std::endl;
+    for(std::string& name: Registry::scenario_names()){
+        std::cout << "    " << name << std::endl;
+    }
+    std::cout << "Measurements:" << std::endl;
+    for(std::string& name: Registry::measurement_names()){
+        std::cout << "    " << name << std::endl;
+    }
+}
+
+// Agent B's configuration: everything from A, with `b.<key>` entries taking precedence
+Registry::Params paired_b_params(Registry::Params& params){
+    Registry::Params b_params = params;
+    for(std::string& key: params.keys()){
+        if(key.rfind("b.",0)==0){
+            b_params.set(key.substr(2),params.get_string(key));
+        }
+    }
+    return b_params;
+}
+
+int run_paired(Registry::Params& params){
+    Registry::Params b_params = paired_b_params(params);
+
+    // Paired games need a base seed; make one up (and report it) if none was given
+    uint64_t seed;
+    if(params.has("seed")){
+        seed = (uint64_t) params.get_long("seed");
+    } else {
+        seed = (uint64_t) rand();
+        std::cout << "[ExperimentRunner] No seed given for paired comparison, using seed=" << seed << std::endl;
+    }
+
+    Experiments::ConfiguredExperiment* exp_a = new Experiments::ConfiguredExperiment(params);
+    Experiments::ConfiguredExperiment* exp_b = new Experiments::ConfiguredExperiment(b_params);
+    int status = 0;
+    if(!exp_a -> valid || !exp_b -> valid){
+        std::cout << "[ExperimentRunner] Configuration didn't resolve (see above). Use --list to see registered names." << std::endl;
+        status = 1;
+    } else {
+        std::string fileheader = params.get_string("fileheader",exp_a -> agent_name + "_vs_" + exp_b -> agent_name);
+        Experiments::RunPairedComparison(exp_a,exp_b,fileheader,params.get_string("paired.metric","GameWon"),seed,params.get_int("n_games",100),params.get_bool("log_output",true));
+    }
+    delete exp_a;
+    delete exp_b;
+    return status;
+}
+
+int main(int argc,char** argv){
+    Registry::Params params;
+    if(!params.read_args(argc,argv)){
+        print_usage();
+        return 1;
+    }
+    if(params.get_bool("list")){
+        print_registered();
+        return 0;
+    }
+    if(!params.has("agent")){
+        print_usage();
+        return 1;
+    }
+
+    // Seed rand() with the configured seed if there is one, otherwise use the clock like every other experiment
+    if(params.has("seed")){
+        srand((unsigned int) params.get_long("seed"));
+    } else {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        srand((time_t)ts.tv_nsec);
+    }
+
+    if(Experiments::IsSweep(params)){
+        Experiments::RunSweep(params);
+        return 0;
+    }
+
+    if(params.get_string("mode","single")=="paired"){
+        return run_paired(params);
+    }
+
+    Experiments::ConfiguredExperiment* experiment = new Experiments::ConfiguredExperiment(params);
+    if(!experiment -> valid){
+        std::cout << "[ExperimentRunner] Configuration didn't resolve (see above). Use --list to see registered names." << std::endl;
+        delete experiment;
+        return 1;
+    }
+
+    Experiments::RunExperiment(experiment,params.get_bool("log_output",true));
+
+    delete experiment;
+    return 0;
+}
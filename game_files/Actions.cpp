@@ -5,11 +5,13 @@
 #include <algorithm>
 #include <numeric>
 #include <array>
+#include <functional>
 
 #include "Actions.h"
 #include "Board.h"
 #include "Map.h"
 #include "Players.h"
+#include "Random.h"
 
 // ==== Pure Utility functions =====
 
@@ -32,36 +34,52 @@ void update_medic_position(Board::Board& game_board){
         // If any player is the medic
         if(p.role.medic){
             if(game_board.is_cured(Map::BLUE)){
-                std::array<int,4>& color_count = game_board.get_color_count();
-                std::array<std::array<int,48>,4>& disease_count = game_board.get_disease_count();
                 // disease count of this color on their position should be 0
-                color_count[Map::BLUE]-=disease_count[Map::BLUE][p.get_position()];
-                disease_count[Map::BLUE][p.get_position()]=0;
+                game_board.set_disease_count(p.get_position(),Map::BLUE,0);
             }
             if(game_board.is_cured(Map::YELLOW)){
-                std::array<int,4>& color_count = game_board.get_color_count();
-                std::array<std::array<int,48>,4>& disease_count = game_board.get_disease_count();
                 // disease count of this color on their position should be 0
-                color_count[Map::YELLOW]-=disease_count[Map::YELLOW][p.get_position()];
-                disease_count[Map::YELLOW][p.get_position()]=0;
+                game_board.set_disease_count(p.get_position(),Map::YELLOW,0);
             }
             if(game_board.is_cured(Map::BLACK)){
-                std::array<int,4>& color_count = game_board.get_color_count();
-                std::array<std::array<int,48>,4>& disease_count = game_board.get_disease_count();
                 // disease count of this color on their position should be 0
-                color_count[Map::BLACK]-=disease_count[Map::BLACK][p.get_position()];
-                disease_count[Map::BLACK][p.get_position()]=0;
+                game_board.set_disease_count(p.get_position(),Map::BLACK,0);
             }
             if(game_board.is_cured(Map::RED)){
-                std::array<int,4>& color_count = game_board.get_color_count();
-                std::array<std::array<int,48>,4>& disease_count = game_board.get_disease_count();
                 // disease count of this color on their position should be 0
-                color_count[Map::RED]-=disease_count[Map::RED][p.get_position()];
-                disease_count[Map::RED][p.get_position()]=0;
+                game_board.set_disease_count(p.get_position(),Map::RED,0);
             }
         }
     }
 }
+
+namespace
+{
+    // (boost-style hash_combine)
+    void combine(size_t& key,size_t value){
+        key ^= value + 0x9e3779b9 + (key << 6) + (key >> 2);
+    }
+
+    size_t args_key(std::initializer_list<int> args){
+        size_t key = 0;
+        for(int arg: args){
+            combine(key,std::hash<int>{}(arg));
+        }
+        return key;
+    }
+
+    // Which role a player has, as one number (players are copied into actions, so their role is what identifies them)
+    int role_key(Players::Player& player){
+        return player.role.quarantinespecialist | player.role.medic << 1 | player.role.scientist << 2 | player.role.researcher << 3 | player.role.operationsexpert << 4;
+    }
+}
+
+size_t Actions::action_key(Actions::Action* action,Board::Board& game_board){
+    size_t key = std::hash<std::string>{}(action -> movetype);
+    combine(key,action -> key_args(game_board));
+    combine(key,std::hash<int>{}(game_board.get_turn()));
+    return key;
+}
 // ========================
 
 // ===== MOVE =====
@@ -81,12 +99,17 @@ void Actions::Move::execute(Board::Board& new_board){
 
     // Make sure disease is cleared from medic position, if there
     update_medic_position(new_board);
+    new_board.update_phase();
 }
 
 std::string Actions::Move::repr(){
     return movetype+" to " + Map::CITY_NAME(to);
 }
 
+size_t Actions::Move::key_args(Board::Board& game_board){
+    return args_key({to});
+}
+
 Actions::MoveConstructor::MoveConstructor(){}
 
 std::string Actions::MoveConstructor::get_movetype(){
@@ -104,7 +127,7 @@ int Actions::MoveConstructor::n_actions(Board::Board& game_board){
 Actions::Action* Actions::MoveConstructor::random_action(Board::Board& game_board){
     Players::Player& active_player = game_board.active_player();
     std::vector<int> neighbors = Map::CITY_NEIGHBORS(active_player.get_position());
-    int neighbor_idx = rand() % neighbors.size();
+    int neighbor_idx = Random::search_rand() % neighbors.size();
     // randomize a neighboring city index to move to it
     return new Actions::Move(neighbors[neighbor_idx]);
 }
@@ -150,12 +173,17 @@ void Actions::DirectFlight::execute(Board::Board& new_board){
 
     // Make sure disease is cleared from medic position, if there
     update_medic_position(new_board);
+    new_board.update_phase();
 }
 
 std::string Actions::DirectFlight::repr(){
     return movetype+" to "+Decks::CARD_NAME(citycard_index);
 }
 
+size_t Actions::DirectFlight::key_args(Board::Board& game_board){
+    return args_key({citycard_index});
+}
+
 Actions::DirectFlightConstructor::DirectFlightConstructor(){}
 
 std::string Actions::DirectFlightConstructor::get_movetype(){
@@ -181,11 +209,11 @@ int Actions::DirectFlightConstructor::n_actions(Board::Board& game_board){
 Actions::Action* Actions::DirectFlightConstructor::random_action(Board::Board& game_board){
     Players::Player& active_player = game_board.active_player();
     std::vector<int> neighbors = Map::CITY_NEIGHBORS(active_player.get_position());
-    int chosen_card = rand() % active_player.hand.size();
+    int chosen_card = Random::search_rand() % active_player.hand.size();
 
     while(isneighbor(active_player.hand[chosen_card],active_player.get_position()) || active_player.hand[chosen_card]==active_player.get_position()){
         // make sure it's not a neighbor or current position
-        chosen_card = rand() % active_player.hand.size();
+        chosen_card = Random::search_rand() % active_player.hand.size();
     }
     return new Actions::DirectFlight(active_player.hand[chosen_card]);
 }
@@ -240,12 +268,17 @@ void Actions::CharterFlight::execute(Board::Board& new_board){
 
     // Make sure disease is cleared from medic position, if there
     update_medic_position(new_board);
+    new_board.update_phase();
 }
 
 std::string Actions::CharterFlight::repr(){
     return movetype+" to "+Decks::CARD_NAME(target_city);
 }
 
+size_t Actions::CharterFlight::key_args(Board::Board& game_board){
+    return args_key({target_city});
+}
+
 Actions::CharterFlightConstructor::CharterFlightConstructor(){}
 
 std::string Actions::CharterFlightConstructor::get_movetype(){
@@ -266,9 +299,9 @@ Actions::Action* Actions::CharterFlightConstructor::random_action(Board::Board&
     Players::Player& active_player = game_board.active_player();
     std::vector<int> neighbors = Map::CITY_NEIGHBORS(active_player.get_position());
 
-    int random_position = rand() % Map::CITIES.size(); // choose a random city to go to
+    int random_position = Random::search_rand() % Map::CITIES.size(); // choose a random city to go to
     while(isneighbor(random_position,active_player.get_position()) || random_position==active_player.get_position()){
-        random_position = rand() % Map::CITIES.size(); 
+        random_position = Random::search_rand() % Map::CITIES.size(); 
     }
     return new Actions::CharterFlight(random_position);
 }
@@ -315,12 +348,17 @@ void Actions::ShuttleFlight::execute(Board::Board& new_board){
 
     // Make sure disease is cleared from medic position, if there
     update_medic_position(new_board);
+    new_board.update_phase();
 }
 
 std::string Actions::ShuttleFlight::repr(){
     return movetype+" to "+Map::CITIES[target_station_city_idx].name;
 }
 
+size_t Actions::ShuttleFlight::key_args(Board::Board& game_board){
+    return args_key({target_station_city_idx});
+}
+
 Actions::ShuttleFlightConstructor::ShuttleFlightConstructor(){}
 
 std::string Actions::ShuttleFlightConstructor::get_movetype(){
@@ -343,10 +381,10 @@ int Actions::ShuttleFlightConstructor::n_actions(Board::Board& game_board){
 
 Actions::Action* Actions::ShuttleFlightConstructor::random_action(Board::Board& game_board){
     int position  = game_board.active_player().get_position();
-    int random_position = rand() % game_board.get_stations().size();
+    int random_position = Random::search_rand() % game_board.get_stations().size();
     while(game_board.get_stations()[random_position]==position){
         // Keep randomizing until you find a station that isn't your present location
-        random_position = rand() % game_board.get_stations().size(); 
+        random_position = Random::search_rand() % game_board.get_stations().size(); 
     }
     return new Actions::ShuttleFlight(game_board.get_stations()[random_position]);
 }
@@ -408,12 +446,17 @@ void Actions::OperationsExpertFlight::execute(Board::Board& new_board){
     new_board.get_turn_action()++;
 
     new_board.LastAction_OperationsExpertFlight=true;
+    new_board.update_phase();
 }
 
 std::string Actions::OperationsExpertFlight::repr(){
     return movetype+" to "+Decks::CARD_NAME(target_city)+" (discard "+Decks::CARD_NAME(discard_card_card_idx)+")";
 }
 
+size_t Actions::OperationsExpertFlight::key_args(Board::Board& game_board){
+    return args_key({target_city,discard_card_card_idx});
+}
+
 Actions::OperationsExpertFlightConstructor::OperationsExpertFlightConstructor(){}
 
 std::string Actions::OperationsExpertFlightConstructor::get_movetype(){
@@ -437,13 +480,13 @@ Actions::Action* Actions::OperationsExpertFlightConstructor::random_action(Board
     int position  = active_player.get_position();
     
     // Random destination
-    int random_position = rand() % Map::CITIES.size();
+    int random_position = Random::search_rand() % Map::CITIES.size();
     while(random_position==position || isneighbor(random_position,position)){
-        random_position = rand() % Map::CITIES.size();
+        random_position = Random::search_rand() % Map::CITIES.size();
     }
 
     // Randomly discarded city card
-    int random_discard = rand() % game_board.active_player().hand.size();
+    int random_discard = Random::search_rand() % game_board.active_player().hand.size();
 
     return new Actions::OperationsExpertFlight(random_position,game_board.active_player().hand[random_discard]);
 }
@@ -514,6 +557,7 @@ void Actions::Build::execute(Board::Board& new_board){
     new_board.get_turn_action()++;
 
     new_board.LastAction_Build=true;
+    new_board.update_phase();
 }
 
 std::string Actions::Build::repr(){
@@ -525,6 +569,10 @@ std::string Actions::Build::repr(){
     }
 }
 
+size_t Actions::Build::key_args(Board::Board& game_board){
+    return args_key({place_station,remove_station});
+}
+
 Actions::BuildConstructor::BuildConstructor(){}
 
 std::string Actions::BuildConstructor::get_movetype(){
@@ -548,7 +596,7 @@ Actions::Action* Actions::BuildConstructor::random_action(Board::Board& game_boa
     Players::Player& active_player = game_board.active_player();
 
     if(game_board.get_stations().size()>=6){
-        return new Actions::Build(active_player.get_position(),rand() % game_board.get_stations().size());
+        return new Actions::Build(active_player.get_position(),Random::search_rand() % game_board.get_stations().size());
     } else {
         return new Actions::Build(active_player.get_position(),-1);
     }
@@ -623,13 +671,10 @@ void Actions::Treat::execute(Board::Board& new_board){
     
     if(active_player.role.medic || new_board.is_cured(color)){
         n_treated = new_board.get_disease_count()[color][active_player.get_position()];
-        new_board.get_disease_count()[color][active_player.get_position()]=0;
     } else {
         n_treated=1;
-        new_board.get_disease_count()[color][active_player.get_position()]--;
     }
-
-    new_board.get_color_count()[color]-=n_treated;
+    new_board.set_disease_count(active_player.get_position(),color,new_board.get_disease_count()[color][active_player.get_position()]-n_treated);
     
     new_board.get_turn_action()++;
     // Check for eradication
@@ -639,12 +684,17 @@ void Actions::Treat::execute(Board::Board& new_board){
     }
 
     new_board.LastAction_Treat=true;
+    new_board.update_phase();
 }
 
 std::string Actions::Treat::repr(){
     return movetype+" " + std::to_string(n_treated) +" "+ Map::COLORS[color];
 }
 
+size_t Actions::Treat::key_args(Board::Board& game_board){
+    return args_key({color});
+}
+
 Actions::TreatConstructor::TreatConstructor(){}
 
 std::string Actions::TreatConstructor::get_movetype(){
@@ -689,7 +739,7 @@ Actions::Action* Actions::TreatConstructor::random_action(Board::Board& game_boa
     if(game_board.get_disease_count()[Map::RED][active_player.get_position()]>0){
         nonzero_colors.push_back(Map::RED);
     }
-    return new Actions::Treat(nonzero_colors[rand() % nonzero_colors.size()]);
+    return new Actions::Treat(nonzero_colors[Random::search_rand() % nonzero_colors.size()]);
 }
 
 std::vector<Actions::Action*> Actions::TreatConstructor::all_actions(Board::Board& game_board){
@@ -768,6 +818,7 @@ void Actions::Cure::execute(Board::Board& new_board){
                 }
                 // Make sure disease is cleared from medic position, if there
                 update_medic_position(new_board);
+                new_board.update_phase();
                 return;
             }
             if(color_count[Map::YELLOW]>=active_player.role.required_cure_cards && !new_board.is_cured(Map::YELLOW)){
@@ -785,6 +836,7 @@ void Actions::Cure::execute(Board::Board& new_board){
                 }
                 // Make sure disease is cleared from medic position, if there
                 update_medic_position(new_board);
+                new_board.update_phase();
                 return;
             }
             if(color_count[Map::BLACK]>=active_player.role.required_cure_cards && !new_board.is_cured(Map::BLACK)){
@@ -802,6 +854,7 @@ void Actions::Cure::execute(Board::Board& new_board){
                 }
                 // Make sure disease is cleared from medic position, if there
                 update_medic_position(new_board);
+                new_board.update_phase();
                 return;
             }
             if(color_count[Map::RED]>=active_player.role.required_cure_cards && !new_board.is_cured(Map::RED)){
@@ -819,18 +872,36 @@ void Actions::Cure::execute(Board::Board& new_board){
                 }
                 // Make sure disease is cleared from medic position, if there
                 update_medic_position(new_board);
+                new_board.update_phase();
                 return;
             }
         }
     }
     new_board.broken()=true;
     new_board.broken_reasons().push_back("[Cure::execute()] CURE execute() was called but there don't seem to be enough of any card to cure, or they weren't at a research station...");
+    new_board.update_phase();
 }
 
 std::string Actions::Cure::repr(){
+    // (the color is only known once it's been executed)
+    if(color_cured<0){
+        return movetype;
+    }
     return movetype + " " + Map::COLORS[color_cured];
 }
 
+size_t Actions::Cure::key_args(Board::Board& game_board){
+    // The color execute() would cure (it checks them in the same order)
+    Players::Player& active_player = game_board.active_player();
+    std::array<int,4> color_count = active_player.get_color_count();
+    for(int col=0;col<4;col++){
+        if(color_count[col]>=active_player.role.required_cure_cards && !game_board.is_cured(col)){
+            return args_key({col});
+        }
+    }
+    return args_key({-1});
+}
+
 Actions::CureConstructor::CureConstructor(){}
 
 std::string Actions::CureConstructor::get_movetype(){
@@ -901,12 +972,17 @@ void Actions::Give::execute(Board::Board& new_board){
     new_board.get_turn_action()++;
 
     new_board.LastAction_Give=true;
+    new_board.update_phase();
 }
 
 std::string Actions::Give::repr(){
     return movetype + " " + Decks::CARD_NAME(card_to_give_city_idx) + " to " + other_player.role.name;
 }
 
+size_t Actions::Give::key_args(Board::Board& game_board){
+    return args_key({role_key(other_player),card_to_give_city_idx});
+}
+
 Actions::GiveConstructor::GiveConstructor(){}
 
 std::string Actions::GiveConstructor::get_movetype(){
@@ -941,7 +1017,7 @@ Actions::Action* Actions::GiveConstructor::random_action(Board::Board& game_boar
 
     // First randomize the card that active_player will give based on their role
     if(active_player.role.researcher){
-        card_to_give = active_player.hand[rand() % active_player.hand.size()];
+        card_to_give = active_player.hand[Random::search_rand() % active_player.hand.size()];
     } else {
         card_to_give = active_player.get_position();
     }
@@ -956,7 +1032,7 @@ Actions::Action* Actions::GiveConstructor::random_action(Board::Board& game_boar
     }
 
     // Randomized value to choose which other player at this city we'll give to
-    int which_player = rand() % n_other_players_here; // 0 ... (# of other players in city - 1)
+    int which_player = Random::search_rand() % n_other_players_here; // 0 ... (# of other players in city - 1)
     // Incremented value to track which of the other players on this city we're considering
     int track=0;
     for(Players::Player _other_player: game_board.get_players()){
@@ -1048,12 +1124,17 @@ void Actions::Take::execute(Board::Board& new_board){
     new_board.get_turn_action()++;
 
     new_board.LastAction_Take=true;
+    new_board.update_phase();
 }
 
 std::string Actions::Take::repr(){
     return movetype + " " + Decks::CARD_NAME(card_to_take_city_idx) + " from " + other_player.role.name;
 }
 
+size_t Actions::Take::key_args(Board::Board& game_board){
+    return args_key({role_key(other_player),card_to_take_city_idx});
+}
+
 Actions::TakeConstructor::TakeConstructor(){}
 
 std::string Actions::TakeConstructor::get_movetype(){
@@ -1097,7 +1178,7 @@ Actions::Action* Actions::TakeConstructor::random_action(Board::Board& game_boar
     // This gives uniformity over all cards to take
     std::vector<Actions::Action*> action_list = all_actions(game_board);
 
-    int chosen_action_index = rand() % action_list.size();
+    int chosen_action_index = Random::search_rand() % action_list.size();
 
     // Have to address that this is a potential memory leak though
     for(int ind=0;ind<action_list.size();ind++){
@@ -1177,12 +1258,17 @@ void Actions::Airlift::execute(Board::Board& new_board){
     }
 
     new_board.LastAction_Airlift=true;
+    new_board.update_phase();
 }
 
 std::string Actions::Airlift::repr(){
     return movetype +" " +using_player.role.name +" airlifts " + target_player.role.name + " to " + Map::CITIES[target_city].name;
 }
 
+size_t Actions::Airlift::key_args(Board::Board& game_board){
+    return args_key({role_key(using_player),role_key(target_player),target_city});
+}
+
 Actions::AirliftConstructor::AirliftConstructor(){}
 
 std::string Actions::AirliftConstructor::get_movetype(){
@@ -1200,15 +1286,15 @@ int Actions::AirliftConstructor::n_actions(Board::Board& game_board){
 
 Actions::Action* Actions::AirliftConstructor::random_action(Board::Board& game_board){
     // copy a player that will be targeted
-    Players::Player _target_player = game_board.get_players()[rand() % game_board.get_players().size()];
+    Players::Player _target_player = game_board.get_players()[Random::search_rand() % game_board.get_players().size()];
     // Use dumb loop to find the player that's using this action.
     for(Players::Player _using_player: game_board.get_players()){
         // Look for Airlift in the player's event_cards
         for(int e: _using_player.event_cards){
             if(Decks::CARD_NAME(e)=="Airlift" && e==50){
-                int random_city = rand() % Map::CITIES.size();
+                int random_city = Random::search_rand() % Map::CITIES.size();
                 while(random_city==_target_player.get_position() || isneighbor(random_city,_target_player.get_position())){
-                    random_city = rand() % Map::CITIES.size();
+                    random_city = Random::search_rand() % Map::CITIES.size();
                 }
                 return new Actions::Airlift(_using_player,_target_player,random_city);
             }
@@ -1282,6 +1368,7 @@ void Actions::GovernmentGrant::execute(Board::Board& new_board){
     }
 
     new_board.LastAction_GovernmentGrant=true;
+    new_board.update_phase();
 }
 
 std::string Actions::GovernmentGrant::repr(){
@@ -1292,6 +1379,10 @@ std::string Actions::GovernmentGrant::repr(){
     return out_str;
 }
 
+size_t Actions::GovernmentGrant::key_args(Board::Board& game_board){
+    return args_key({role_key(using_player),target_city,remove_station});
+}
+
 Actions::GovernmentGrantConstructor::GovernmentGrantConstructor(){}
 
 std::string Actions::GovernmentGrantConstructor::get_movetype(){
@@ -1311,14 +1402,14 @@ int Actions::GovernmentGrantConstructor::n_actions(Board::Board& game_board){
 
 Actions::Action* Actions::GovernmentGrantConstructor::random_action(Board::Board& game_board){
     // I feel like I shouldn't have written anything while drinking
-    int target_city = Map::CITIES[rand() % Map::CITIES.size()].index;
+    int target_city = Map::CITIES[Random::search_rand() % Map::CITIES.size()].index;
     bool already_station = true;
     // Loop until 4 sure target_city isn't already occupied by a research station
     while(already_station){
         already_station = false; 
         for(int st: game_board.get_stations()){
             if(st==target_city){
-                target_city = Map::CITIES[rand() % Map::CITIES.size()].index;
+                target_city = Map::CITIES[Random::search_rand() % Map::CITIES.size()].index;
                 already_station=true;
                 break;
             }
@@ -1332,7 +1423,7 @@ Actions::Action* Actions::GovernmentGrantConstructor::random_action(Board::Board
             if(e==49 && Decks::CARD_NAME(e)=="Government Grant"){
                 if(game_board.get_stations().size()>=6){
                     // remove a station at random using its city index
-                    return new Actions::GovernmentGrant(this_player,target_city,game_board.get_stations()[rand() % game_board.get_stations().size()]);
+                    return new Actions::GovernmentGrant(this_player,target_city,game_board.get_stations()[Random::search_rand() % game_board.get_stations().size()]);
                 }else{
                     return new Actions::GovernmentGrant(this_player,target_city);
                 }  
@@ -1420,12 +1511,17 @@ void Actions::QuietNight::execute(Board::Board& new_board){
     new_board.quiet_night_status() = true;
 
     new_board.LastAction_QuietNight=true;
+    new_board.update_phase();
 }
 
 std::string Actions::QuietNight::repr(){
     return movetype + " used by " + using_player.role.name;
 }
 
+size_t Actions::QuietNight::key_args(Board::Board& game_board){
+    return args_key({role_key(using_player)});
+}
+
 Actions::QuietNightConstructor::QuietNightConstructor(){}
 
 std::string Actions::QuietNightConstructor::get_movetype(){
@@ -1499,6 +1595,7 @@ void Actions::DoNothing::execute(Board::Board& game_board){
     }
     // Otherwise this is being called when perhaps using an Event card outside of the turn, and shouldn't change the game state at all.
     game_board.LastAction_DoNothing=true;
+    game_board.update_phase();
 }
 
 std::string Actions::DoNothing::repr(){
@@ -1548,6 +1645,10 @@ std::string Actions::ForcedDiscardAction::repr(){
     return movetype+" " + player_to_discard.role.name + " discarded " + Decks::CARD_NAME(discard_card_index);
 }
 
+size_t Actions::ForcedDiscardAction::key_args(Board::Board& game_board){
+    return args_key({role_key(player_to_discard),discard_card_index});
+}
+
 void Actions::ForcedDiscardAction::execute(Board::Board& new_board){
     for(Players::Player& p : new_board.get_players()){
         if(p.role==player_to_discard.role){
@@ -1555,6 +1656,7 @@ void Actions::ForcedDiscardAction::execute(Board::Board& new_board){
         }
     }
     new_board.LastAction_ForcedDiscard=true;
+    new_board.update_phase();
 }
 
 Actions::ForcedDiscardConstructor::ForcedDiscardConstructor(){};
@@ -1601,7 +1703,7 @@ Actions::Action* Actions::ForcedDiscardConstructor::random_action(Board::Board&
     for(Players::Player p: game_board.get_players()){
         if(p.hand_full()){
             // pick a card at random
-            int card_to_discard_or_use = rand() % p.handsize(); 
+            int card_to_discard_or_use = Random::search_rand() % p.handsize(); 
 
             // If the random card is one of the city cards...
             if(card_to_discard_or_use<p.hand.size()){
@@ -20,12 +20,23 @@ namespace Actions
         virtual ~Action(){};
 
         // Act on the referenced active_board according to child class logic
+        // (every execute() finishes with new_board.update_phase(), so the board knows what comes next)
         virtual void execute(Board::Board& new_board)=0;
         
         // String representation for logging/debugging
         virtual std::string repr()=0;
+
+        // The arguments that tell this action apart from the others of its movetype, hashed together (for action_key()).
+        // Player actions override it with their constructor arguments (Cure, which has none, with the color the active player can cure on `game_board`)
+        virtual size_t key_args(Board::Board& game_board){return 0;};
     };
 
+    // A stable identity for a player action: the same choice by the same player gets the same key wherever it comes up
+    // (on any board, in any simulation), so e.g. search statistics can be shared between different occurrences of "the same" action.
+    // It's a hash of whose turn it is, the movetype and key_args(). It doesn't depend on whether the action has been executed,
+    // but Cure's is worked out from the active player's hand, so it has to be taken on the board the action is about to be executed on.
+    size_t action_key(Action* action,Board::Board& game_board);
+
     /* Below are all the actions, each of which has
         (1) A reference to the active game board
         (2) Attributes that help define it's exact effect
@@ -70,6 +81,7 @@ namespace Actions
         ~Move(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== DirectFlight ===== 
@@ -80,6 +92,7 @@ namespace Actions
         ~DirectFlight(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== CharterFlight =====
@@ -90,6 +103,7 @@ namespace Actions
         ~CharterFlight(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== ShuttleFlight =====
@@ -100,6 +114,7 @@ namespace Actions
         ~ShuttleFlight(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== OperationsExpertFlight =====
@@ -112,6 +127,7 @@ namespace Actions
         ~OperationsExpertFlight(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== Build =====
@@ -125,6 +141,7 @@ namespace Actions
         ~Build(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     }; 
 
     // ===== Treat ===== 
@@ -136,6 +153,7 @@ namespace Actions
         ~Treat(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== Cure ===== 
@@ -147,6 +165,7 @@ namespace Actions
         ~Cure(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== Give ===== 
@@ -158,6 +177,7 @@ namespace Actions
         ~Give(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== Take ===== 
@@ -169,6 +189,7 @@ namespace Actions
         ~Take(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== EVENT CARD ACTIONS =====
@@ -181,6 +202,7 @@ namespace Actions
         Airlift( Players::Player _using_player,Players::Player _target_player,int _target_city);
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== Government Grant ===== 
@@ -193,6 +215,7 @@ namespace Actions
         ~GovernmentGrant(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== Quiet Night ===== 
@@ -203,6 +226,7 @@ namespace Actions
         ~QuietNight(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr(); // to yield a string representation for logging
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== Forced Discard Action 
@@ -214,6 +238,7 @@ namespace Actions
         ~ForcedDiscardAction(){};
         void execute(Board::Board& new_board); // To execute on a given board
         std::string repr();
+        size_t key_args(Board::Board& game_board); // its arguments, for action_key()
     };
 
     // ===== NULL ACTION ===== 
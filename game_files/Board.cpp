@@ -130,6 +130,7 @@ void Board::Board::setup(bool verbose){
     }
     // set setup to true; won't allow setup() to be called again without breaking
     IS_SETUP = true;
+    update_phase();
 }
 
 void Board::Board::clear(){
@@ -143,6 +144,7 @@ void Board::Board::clear(){
     reset_last_action();
     
     research_stations.clear();
+    update_station_masks();
 
     player_deck = Decks::PlayerDeck(difficulty);
     infect_deck = Decks::InfectDeck();
@@ -157,6 +159,7 @@ void Board::Board::clear(){
     disease_count[Map::RED].fill(0);
 
     color_count = {0,0,0,0};
+    three_cube_cities = {0,0,0,0};
 
     // vector of 4 bools: whether or not each disease is cured
     cured= {false,false,false,false};
@@ -165,7 +168,7 @@ void Board::Board::clear(){
 
     int turn = 0; 
 
-    already_outbroken_cities.clear();
+    already_outbroken_cities = 0;
 
     int turn_actions = 0;
 
@@ -180,6 +183,7 @@ void Board::Board::clear(){
     won = false;
     BROKEN = false;
     why_it_broke.clear();
+    game_phase = PLAYER_ACTION;
 }
 
 void Board::Board::is_setup(){
@@ -212,6 +216,22 @@ void Board::Board::reset_disease_count(){
             disease_count[col][city.index]=0;
         }
     }
+    color_count = {0,0,0,0};
+    three_cube_cities = {0,0,0,0};
+}
+
+void Board::Board::set_disease_count(int city_idx,int col,int cubes){
+    color_count[col]+=cubes - disease_count[col][city_idx];
+    disease_count[col][city_idx] = cubes;
+    if(cubes==3){
+        three_cube_cities[col] |= 1ULL << city_idx;
+    } else {
+        three_cube_cities[col] &= ~(1ULL << city_idx);
+    }
+}
+
+unsigned long long Board::Board::get_3cube_cities(int col){
+    return three_cube_cities[col];
 }
 
 void Board::Board::setup_player_deck(){
@@ -252,7 +272,7 @@ std::array<int,2> Board::Board::infect_city(int city_idx, int col,int add){
                     }
                 }
                 // Or if they're in an adjacent city
-                for(int n: Map::CITY_NEIGHBORS(p.get_position())){
+                for(int n: Map::CITIES[p.get_position()].neighbors){
                     if(city_idx==n){
                         if(disease_count[col][city_idx]+add>3){
                             return {0,1};
@@ -265,25 +285,21 @@ std::array<int,2> Board::Board::infect_city(int city_idx, int col,int add){
             }
         }
     }
-    for(int c: already_outbroken_cities){
-        if(c==city_idx){
-            return {0,0};
-        }
+    if((already_outbroken_cities >> city_idx) & 1ULL){
+        return {0,0};
     }
     // To get to this point there can't have been a blocking quarantine specialist
     // This city also can't have been a previously outbroken city during the resolution of this logic
     // If adding the suggested amount would result in there being >3 cubes...
     if((disease_count[col][city_idx]+add)>3){
-        color_count[col]+=(3-disease_count[col][city_idx]);
         // set the count there to 3 whether or not it was already
-        disease_count[col][city_idx] = 3;
+        set_disease_count(city_idx,col,3);
 
         // outbreak this city and color
         return outbreak(city_idx,col);
     } else{
         // Otherwise just add "add" number of cubes to it if this city isn't outbroken
-        color_count[col]+=add;
-        disease_count[col][city_idx]+=add;
+        set_disease_count(city_idx,col,disease_count[col][city_idx]+add);
         return {0,0};
     }
 }
@@ -306,13 +322,13 @@ std::array<int,2> Board::Board::outbreak(int city_idx,int col){
     int n_outbreaks =1, n_blocked = 0;
 
     // Add this city being outbroken to the list of those outbroken on this resolution
-    already_outbroken_cities.push_back(city_idx);
+    already_outbroken_cities |= 1ULL << city_idx;
 
     for(int neighbor: Map::CITIES[city_idx].neighbors){
         std::array<int,2> infect_result= infect_city(neighbor,col,1);
         if(infect_result[0]>0 || infect_result[1]>0){
             // If an outbreak event did or would have happened at the neighbor, then it's accounted for
-            already_outbroken_cities.push_back(neighbor);
+            already_outbroken_cities |= 1ULL << neighbor;
         }
         n_outbreaks+=infect_result[0];
         n_blocked+=infect_result[1];
@@ -325,18 +341,11 @@ std::array<int,2> Board::Board::outbreak(Map::City& city, int col){
 }
 
 void Board::Board::reset_outbreak_memory(){
-    already_outbroken_cities.clear();
+    already_outbroken_cities = 0;
 }
 
 bool Board::Board::is_terminal(){
-    updatestatus();
-    if(won || lost){
-        return true;
-    } else if(BROKEN){
-        return true;
-    } else {
-        return false;
-    }
+    return phase()>=TERMINAL_WON;
 };
 
 int Board::Board::win_lose(){
@@ -357,23 +366,19 @@ void Board::Board::update_medic_position(){
         if(p.role.medic){
             if(cured[Map::BLUE]){
                 // disease count of this color on their position should be 0
-                color_count[Map::BLUE]-=disease_count[Map::BLUE][p.get_position()];
-                disease_count[Map::BLUE][p.get_position()]=0;
+                set_disease_count(p.get_position(),Map::BLUE,0);
             }
             if(cured[Map::YELLOW]){
                 // disease count of this color on their position should be 0
-                color_count[Map::YELLOW]-=disease_count[Map::YELLOW][p.get_position()];
-                disease_count[Map::YELLOW][p.get_position()]=0;
+                set_disease_count(p.get_position(),Map::YELLOW,0);
             }
             if(cured[Map::BLACK]){
                 // disease count of this color on their position should be 0
-                color_count[Map::BLACK]-=disease_count[Map::BLACK][p.get_position()];
-                disease_count[Map::BLACK][p.get_position()]=0;
+                set_disease_count(p.get_position(),Map::BLACK,0);
             }
             if(cured[Map::RED]){
                 // disease count of this color on their position should be 0
-                color_count[Map::RED]-=disease_count[Map::RED][p.get_position()];
-                disease_count[Map::RED][p.get_position()]=0;
+                set_disease_count(p.get_position(),Map::RED,0);
             }
         }
     }
@@ -383,7 +388,7 @@ void Board::Board::update_eradicated_status(){
     // if cured...
     if(cured[Map::BLUE]){
         // and there's none left...
-        if(std::accumulate(disease_count[Map::BLUE].begin(),disease_count[Map::BLUE].end(),0)==0){
+        if(color_count[Map::BLUE]==0){
             // then it's eradicated!
             eradicated[Map::BLUE]=true;
         }
@@ -391,7 +396,7 @@ void Board::Board::update_eradicated_status(){
     // if cured...
     if(cured[Map::YELLOW]){
         // and there's none left...
-        if(std::accumulate(disease_count[Map::YELLOW].begin(),disease_count[Map::YELLOW].end(),0)==0){
+        if(color_count[Map::YELLOW]==0){
             // then it's eradicated!
             eradicated[Map::YELLOW]=true;
         }
@@ -399,7 +404,7 @@ void Board::Board::update_eradicated_status(){
     // if cured...
     if(cured[Map::BLACK]){
         // and there's none left...
-        if(std::accumulate(disease_count[Map::BLACK].begin(),disease_count[Map::BLACK].end(),0)==0){
+        if(color_count[Map::BLACK]==0){
             // then it's eradicated!
             eradicated[Map::BLACK]=true;
         }
@@ -407,7 +412,7 @@ void Board::Board::update_eradicated_status(){
     // if cured...
     if(cured[Map::RED]){
         // and there's none left...
-        if(std::accumulate(disease_count[Map::RED].begin(),disease_count[Map::RED].end(),0)==0){
+        if(color_count[Map::RED]==0){
             // then it's eradicated!
             eradicated[Map::RED]=true;
         }
@@ -437,6 +442,39 @@ void Board::Board::updatestatus(){
     }
 }
 
+void Board::Board::update_phase(){
+    updatestatus();
+    // Same order as GameLogic::Game used to work it out in: the end of the game first, then forced discards, which interrupt anything else
+    if(BROKEN){
+        game_phase = TERMINAL_BROKEN;
+    } else if(lost){
+        game_phase = TERMINAL_LOST;
+    } else if(won){
+        game_phase = TERMINAL_WON;
+    } else {
+        game_phase = PLAYER_ACTION;
+        for(Players::Player& p: players){
+            if(p.hand_full()){
+                game_phase = FORCED_DISCARD;
+                return;
+            }
+        }
+        if(turn_actions==4){
+            game_phase = PLAYER_DRAW;
+        } else if(turn_actions==5 && infect_cards_drawn<get_infection_rate()){
+            game_phase = INFECT;
+        }
+    }
+}
+
+Board::GamePhase Board::Board::phase(){
+    // Anything can break a board (including legal() checks), so that one's read off the flag itself
+    if(BROKEN){
+        return TERMINAL_BROKEN;
+    }
+    return game_phase;
+}
+
 Players::Player& Board::Board::active_player(){
     return players[turn];
 }
@@ -447,6 +485,7 @@ std::vector<int>& Board::Board::get_stations(){
 
 void Board::Board::AddStation(int new_station){
     research_stations.push_back(new_station);
+    update_station_masks();
 }
 
 void Board::Board::RemoveStation(int station_city_idx){
@@ -454,11 +493,36 @@ void Board::Board::RemoveStation(int station_city_idx){
     for(int st=0; st<research_stations.size();st++){
         if(research_stations[st]==station_city_idx){
             research_stations.erase(research_stations.begin() + st);
+            update_station_masks();
             return;
         }
     }
 }
 
+void Board::Board::update_station_masks(){
+    // There are never more than 6 stations, so just redo both masks from the list whenever it changes
+    station_cities = 0;
+    next_to_station_cities = 0;
+    for(int st: research_stations){
+        station_cities |= 1ULL << st;
+        for(int neighbor: Map::CITIES[st].neighbors){
+            next_to_station_cities |= 1ULL << neighbor;
+        }
+    }
+}
+
+bool Board::Board::at_station(int city_idx){
+    return (station_cities >> city_idx) & 1ULL;
+}
+
+bool Board::Board::next_to_station(int city_idx){
+    return (next_to_station_cities >> city_idx) & 1ULL;
+}
+
+unsigned long long Board::Board::get_station_cities(){
+    return station_cities;
+}
+
 std::array<std::array<int,48>,4>& Board::Board::get_disease_count(){
     return disease_count;
 }
@@ -515,6 +579,10 @@ int Board::Board::draw_playerdeck_inplace(){
     return player_deck.draw_inplace();
 }
 
+void Board::Board::playerdeck_distribution(Decks::CardDistribution& distribution){
+    player_deck.next_draw_distribution(distribution);
+}
+
 int& Board::Board::get_player_cards_drawn(){
     return player_cards_drawn;
 }
@@ -547,6 +615,10 @@ int Board::Board::draw_infectdeck_inplace(){
     return infect_deck.draw_inplace();
 }
 
+void Board::Board::infectdeck_distribution(Decks::CardDistribution& distribution,bool bottom){
+    infect_deck.next_draw_distribution(distribution,bottom);
+}
+
 void Board::Board::updateInfectDeck(int card,bool bottom){
     infect_deck.update(card,bottom);
 }
@@ -621,6 +693,6 @@ std::vector<std::string>& Board::Board::broken_reasons(){
     return why_it_broke;
 }
 
-std::string&  Board::Board::get_lost_reason(){
+const char*& Board::Board::get_lost_reason(){
     return why_lost;
 }
\ No newline at end of file
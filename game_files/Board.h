@@ -14,6 +14,18 @@ namespace Board
     // store infection rate vector as global constant
     inline const std::vector<int> INFECTION_COUNTER = {2,2,2,3,3,4,4};
 
+    // Where a game is: what has to happen next, or how it ended.
+    // The board keeps its own (see update_phase()), so asking whether a board is terminal or stochastic is a read rather than a rescan.
+    enum GamePhase{
+        PLAYER_ACTION,   // the active player's actions (turn_actions 0-3)
+        FORCED_DISCARD,  // a player holds more than their hand limit, and discards before anything else happens
+        PLAYER_DRAW,     // drawing the two player cards (turn_actions 4)
+        INFECT,          // drawing infect cards (turn_actions 5)
+        TERMINAL_WON,
+        TERMINAL_LOST,
+        TERMINAL_BROKEN
+    };
+
     class Board{
     private:
         // only tracks whether or not setup() has already been called.
@@ -38,7 +50,16 @@ namespace Board
         // have to initialize to 0 on setup
         std::array<std::array<int,48>,4> disease_count; 
 
+        // cubes of each color on the board (kept up to date wherever disease_count changes, like the masks below)
         std::array<int,4> color_count = {0,0,0,0};
+
+        // ===== Features the heuristics read, kept up to date by the mutators instead of recounted on every evaluation =====
+        // bit c of three_cube_cities[col] is set when city c has 3 cubes of color col (see set_disease_count())
+        std::array<unsigned long long,4> three_cube_cities = {0,0,0,0};
+        // bit c is set when city c has a research station / when one of city c's neighbors does (see AddStation(), RemoveStation())
+        unsigned long long station_cities = 0;
+        unsigned long long next_to_station_cities = 0;
+        void update_station_masks();
         // vector of 4 bools: whether or not each disease is cured
         std::vector<bool> cured= {false,false,false,false};
         // vector of 4 bools: whether or not each disease is eradicated
@@ -47,8 +68,8 @@ namespace Board
         // Tracks which players turn it is
         int turn = 0; 
 
-        // This is perhaps a silly way to solve the tracking of already-outbroken cities during outbreak()
-        std::vector<int> already_outbroken_cities = {};
+        // Cities already outbroken during the current outbreak() chain (bit = city index), so that resolving one never allocates
+        unsigned long long already_outbroken_cities = 0;
 
         // Actions used on this turn so far. Also used to track game stage
         // {0,1,2,3} are player turns, incremented with each action.
@@ -64,8 +85,12 @@ namespace Board
 
         bool quiet_night = false;
 
+        // Phase as of the last update_phase(). Every Action::execute() ends with one, as do setup() and the scenarios
+        GamePhase game_phase = PLAYER_ACTION;
+
         bool lost = false;
-        std::string why_lost;
+        // (always a string literal, so that losing in the middle of a draw doesn't allocate)
+        const char* why_lost = "";
 
         bool won = false;
 
@@ -87,6 +112,8 @@ namespace Board
 
             outbreak_count = other.outbreak_count;
             epidemics_drawn = other.epidemics_drawn;
+            // (the sanity checks compare epidemics against it, so copies need it too)
+            difficulty = other.difficulty;
 
             player_cards_drawn = other.player_cards_drawn;
             infect_cards_drawn = other.infect_cards_drawn;
@@ -98,6 +125,7 @@ namespace Board
             lost = other.lost;
             won = other.won;
             BROKEN = other.BROKEN;
+            game_phase = other.game_phase;
 
             // ===== End of copy of basic attributes =====
             // I _think_ this is a silly but at least deep copy method
@@ -119,6 +147,10 @@ namespace Board
             disease_count = other.disease_count;
             color_count = other.color_count;
 
+            three_cube_cities = other.three_cube_cities;
+            station_cities = other.station_cities;
+            next_to_station_cities = other.next_to_station_cities;
+
             // Both of these require an overloaded = operator
             player_deck = other.player_deck;
             infect_deck = other.infect_deck;
@@ -175,12 +207,18 @@ namespace Board
 
         // Check all gamestate variables and set win/lose/break as appropriate, if applicable
         void updatestatus();
+        // updatestatus(), then work out the phase from scratch. Has to be called after anything that could change it (see GamePhase)
+        void update_phase();
+        // The phase as of the last update_phase() (or TERMINAL_BROKEN, if something has broken the board since)
+        GamePhase phase();
         void update_medic_position(); // Check whether there's a medic and they're on a city with a cured disease, and remove any disease of that color if so
         void update_eradicated_status(); // Update eradicated status according to cure status and disease_count
 
         // functional additions (lots of them)
         Players::Player& active_player(); // reference to active player
-        std::array<std::array<int,48>,4>& get_disease_count(); // reference to disease count to increment
+        std::array<std::array<int,48>,4>& get_disease_count(); // reference to disease count. Change it with set_disease_count() so that color_count and the 3-cube cities stay right
+        void set_disease_count(int city_idx,int col,int cubes); // set the cubes of a color on a city
+        unsigned long long get_3cube_cities(int col); // bitmask (bit = city index) of cities with 3 cubes of a color
         std::array<int,4>& get_color_count();
         int disease_sum(int col); // sum of disease cubes of a color
         void reset_disease_count();
@@ -189,6 +227,9 @@ namespace Board
         std::vector<int>& get_stations(); // reference to research stations
         void AddStation(int new_station);
         void RemoveStation(int station_list_idx);
+        bool at_station(int city_idx); // does this city have a research station?
+        bool next_to_station(int city_idx); // does any neighbor of this city have a research station?
+        unsigned long long get_station_cities(); // bitmask (bit = city index) of cities with a research station
                 
         bool is_eradicated(int col); // get eradicated status of a disease
         std::vector<bool>& get_eradicated();
@@ -216,6 +257,7 @@ namespace Board
 
         // Player deck entrypoints
         int draw_playerdeck_inplace();
+        void playerdeck_distribution(Decks::CardDistribution& distribution); // exact distribution of the next player card (see Decks::PlayerDeck::next_draw_distribution())
         int& get_player_cards_drawn(); // Entry point for access to number of player cards drawn during player draw phase
         void updatePlayerDeck(int card,bool setup = false); // update player deck to reflect a card having been drawn and used
         int remaining_player_cards(); // Entry point for asking how many player cards are left in the deck
@@ -226,6 +268,7 @@ namespace Board
         // Infect deck entrypoints
         int draw_infectdeck_bottom_inplace();// return a card that might be drawn without removing it from deck
         int draw_infectdeck_inplace();
+        void infectdeck_distribution(Decks::CardDistribution& distribution,bool bottom=false); // exact distribution of the next infect card from the top (or bottom)
         void readd_infect_discard(); // Logic to re-add discard to top of infect deck
         void updateInfectDeck(int card,bool bottom=false); // update infect deck to reflect a card having been drawn and used
         int& get_infect_cards_drawn();
@@ -237,7 +280,7 @@ namespace Board
         bool& broken();
         // reference to why_it_broke vector - insert new reasons as more things break!
         std::vector<std::string>& broken_reasons();
-        std::string& get_lost_reason();
+        const char*& get_lost_reason();
 
     };
 }
@@ -7,6 +7,7 @@
 
 #include "Map.h"
 #include "Decks.h"
+#include "Random.h"
 
 std::string Decks::CARD_NAME(int card_index){
     if(card_index<Map::CITIES.size()){
@@ -55,6 +56,32 @@ int Decks::POPULATION(int card_index){
     }
 }
 
+void Decks::CardDistribution::clear(){
+    size=0;
+}
+
+void Decks::CardDistribution::add(int card,double probability){
+    outcomes[size] = {card,probability};
+    size++;
+}
+
+double Decks::CardDistribution::probability(int card){
+    for(int outcome=0;outcome<size;outcome++){
+        if(outcomes[outcome].card==card){
+            return outcomes[outcome].probability;
+        }
+    }
+    return 0;
+}
+
+double Decks::CardDistribution::total(){
+    double sum=0;
+    for(int outcome=0;outcome<size;outcome++){
+        sum+=outcomes[outcome].probability;
+    }
+    return sum;
+}
+
 Decks::PlayerDeck::PlayerDeck(int diff){
     // Takes difficulty in 4,5,6 but you could throw whatever garbage in here you want
     // 
@@ -118,14 +145,14 @@ int Decks::PlayerDeck::draw_index(bool setup){
     int& chunk_cards_left = deck_chunk_sizes.back();
     if(epidemics_drawn==(difficulty - deck_chunk_sizes.size()) && !setup){
         // number left includes epidemic card
-        if((float) rand()<= (float) ((float) RAND_MAX/(float) chunk_cards_left)){
+        if((float) Random::player_chance()<= (float) ((float) RAND_MAX/(float) chunk_cards_left)){
             return 48+3+epidemics_drawn;
         } else {
-            return rand() % remaining_nonepi_cards.size();
+            return Random::player_chance() % remaining_nonepi_cards.size();
         }
     } else {
         // There's no remaining epidemic card
-        return rand() % remaining_nonepi_cards.size();
+        return Random::player_chance() % remaining_nonepi_cards.size();
     }
     return -1;
 }
@@ -203,6 +230,25 @@ bool Decks::PlayerDeck::epidemic_possible(){
     return epidemics_drawn==(difficulty - deck_chunk_sizes.size());
 }
 
+void Decks::PlayerDeck::next_draw_distribution(Decks::CardDistribution& distribution){
+    distribution.clear();
+    if(isempty()){
+        return;
+    }
+    // Same cases as draw_index()
+    double epidemic_probability = 0;
+    if(epidemic_possible() && !deck_chunk_sizes.empty()){
+        epidemic_probability = remaining_nonepi_cards.empty() ? 1. : 1./(double) deck_chunk_sizes.back();
+        distribution.add(48+3+epidemics_drawn,epidemic_probability);
+    }
+    if(!remaining_nonepi_cards.empty()){
+        double card_probability = (1.-epidemic_probability)/(double) remaining_nonepi_cards.size();
+        for(int card: remaining_nonepi_cards){
+            distribution.add(card,card_probability);
+        }
+    }
+}
+
 bool Decks::PlayerDeck::all_epidemics_drawn(){
     return epidemics_drawn==difficulty;
 }
@@ -230,10 +276,8 @@ Decks::InfectDeck::InfectDeck(){
 }
 
 void Decks::InfectDeck::readd_discard(){
-
-    std::vector<int> newest_group = current_discard;
-
-    deck_stack.push_back(newest_group);
+    // (one copy for the new pile: the discard keeps its room for the draws after the epidemic)
+    deck_stack.push_back(current_discard);
 
     current_discard.clear();
 }
@@ -243,7 +287,7 @@ int Decks::InfectDeck::draw(){
     std::vector<int>& current_stack = deck_stack.back();
 
     // 
-    int chosen_index = rand() % current_stack.size();
+    int chosen_index = Random::infect_chance() % current_stack.size();
 
     int chosen_card = current_stack[chosen_index];
     current_stack.erase(current_stack.begin()+chosen_index);
@@ -262,7 +306,7 @@ int Decks::InfectDeck::draw_inplace(){
     
     std::vector<int>& current_stack = deck_stack.back();
 
-    int chosen_index = rand() % current_stack.size();
+    int chosen_index = Random::infect_chance() % current_stack.size();
 
     int chosen_card = current_stack[chosen_index];
 
@@ -289,12 +333,23 @@ void Decks::InfectDeck::update(int card,bool bottom){
     current_discard.push_back(card);
 }
 
+void Decks::InfectDeck::next_draw_distribution(Decks::CardDistribution& distribution,bool bottom){
+    distribution.clear();
+    if(deck_stack.empty()){
+        return;
+    }
+    std::vector<int>& current_stack = bottom ? deck_stack[0] : deck_stack.back();
+    for(int card: current_stack){
+        distribution.add(card,1./(double) current_stack.size());
+    }
+}
+
 int Decks::InfectDeck::draw_bottom(){
     
     std::vector<int>& current_stack = deck_stack[0];
     
     // 
-    int chosen_index = rand() % current_stack.size();
+    int chosen_index = Random::infect_chance() % current_stack.size();
 
     int chosen_card = current_stack[chosen_index];
     current_stack.erase(current_stack.begin()+chosen_index);
@@ -313,7 +368,7 @@ int Decks::InfectDeck::draw_bottom_inplace(){
     
     std::vector<int>& current_stack = deck_stack[0];
     
-    int chosen_index = rand() % current_stack.size();
+    int chosen_index = Random::infect_chance() % current_stack.size();
 
     int chosen_card = current_stack[chosen_index];
 
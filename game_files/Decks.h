@@ -1,6 +1,7 @@
 #ifndef DECK_H
 #define DECK_H
 
+#include <array>
 #include <iostream>
 #include <set>
 #include <string>
@@ -21,6 +22,35 @@ namespace Decks
 	bool IS_EPIDEMIC(int card_index);
 	int POPULATION(int card_index);
 
+	// One card that the next draw could produce, and how likely it is
+	struct CardOutcome{
+		int card;
+		double probability;
+	};
+
+	// The exact distribution of one draw, as (card, probability) pairs.
+	// Fixed capacity (every player card plus one epidemic covers any single draw from either deck), so filling one in never allocates:
+	// keep one around and hand it to next_draw_distribution() again and again.
+	class CardDistribution{
+	public:
+		static const int MAX_OUTCOMES = 52;
+
+		std::array<CardOutcome,MAX_OUTCOMES> outcomes;
+		int size=0;
+
+		void clear();
+		void add(int card,double probability);
+
+		// Probability of a specific card (0 if it can't be drawn)
+		double probability(int card);
+
+		// Sum of all probabilities (1 unless the deck is empty)
+		double total();
+
+		CardOutcome* begin(){return outcomes.data();};
+		CardOutcome* end(){return outcomes.data()+size;};
+	};
+
 	class PlayerDeck{
 		std::vector<int> drawn_cards;
 		std::vector<int> remaining_nonepi_cards;
@@ -42,7 +72,13 @@ namespace Decks
 		~PlayerDeck(){};
 
 		PlayerDeck(const PlayerDeck& other){
-			drawn_cards = other.drawn_cards;
+			*this = other;
+		}
+		// Copies keep room in drawn_cards for every card still to come (the rest of the city/event cards, plus an epidemic per chunk),
+		// so that drawing on a copy never has to grow it
+		PlayerDeck& operator=(const PlayerDeck& other){
+			drawn_cards.reserve(other.drawn_cards.size()+other.remaining_nonepi_cards.size()+other.deck_chunk_sizes.size());
+			drawn_cards.assign(other.drawn_cards.begin(),other.drawn_cards.end());
 			remaining_nonepi_cards = other.remaining_nonepi_cards;
 			deck_chunk_sizes = other.deck_chunk_sizes;
 
@@ -53,6 +89,7 @@ namespace Decks
 			chunk_size = other.chunk_size;
 			remainder = other.remainder;
 			total_cards_drawn = other.total_cards_drawn;
+			return *this;
 		}
 		// These two methods in combination make a card.
 		int draw(bool setup=false); // puts two methods below together.
@@ -71,6 +108,11 @@ namespace Decks
 		// track whether it's possible for the next card to be an epidemic
 		bool epidemic_possible();
 
+		// Exact distribution of the card draw() would produce next (in play, i.e. not during setup), the same one draw_index() samples from:
+		// the current chunk's epidemic with probability 1/(cards left in the chunk) if it hasn't come up yet, and otherwise any remaining card uniformly.
+		// Empty if the deck is.
+		void next_draw_distribution(CardDistribution& distribution);
+
 		// Whether or not all epidemics have been drawn
 		bool all_epidemics_drawn();
 
@@ -96,17 +138,22 @@ namespace Decks
 		InfectDeck();
 		~InfectDeck(){}
 		InfectDeck(const InfectDeck& other){
+			*this = other;
+		}
+		// Copies keep room for the piles of a couple of epidemics, and for every city card in the discard,
+		// so that drawing on a copy only ever allocates an epidemic's re-added pile
+		InfectDeck& operator=(const InfectDeck& other){
 			// copy the deck stack
-			deck_stack = {};
-			for(std::vector<int> g: other.deck_stack){
+			deck_stack.clear();
+			deck_stack.reserve(other.deck_stack.size()+2);
+			for(const std::vector<int>& g: other.deck_stack){
 				deck_stack.push_back(g);
 			}
 
 			// Copy the current discard
-			current_discard={};
-			for(int c: other.current_discard){
-				current_discard.push_back(c);
-			}
+			current_discard.reserve(48);
+			current_discard.assign(other.current_discard.begin(),other.current_discard.end());
+			return *this;
 		}
 		int draw();// return a card that could be drawn, removing it from the deck
 		int draw_inplace(); // return a card that could be drawn, without removing it from the deck
@@ -116,6 +163,9 @@ namespace Decks
 
 		void update(int card,bool bottom=false); // for forcing an infect deck to put this on the discard and pull it from the top group (i.e for use in collaboration with draw_inplace)
 
+		// Exact distribution of the card draw() (or draw_bottom(), if `bottom`) would produce next: uniform over the top (bottom) group
+		void next_draw_distribution(CardDistribution& distribution,bool bottom=false);
+
 		int top_group_size(bool top=true); // number of infect cards in the top infect-card group
 		bool in_discard(int citycard); // whether or not a specific card is in the discard
 		
@@ -6,6 +6,7 @@
 #include "StochasticActions.h"
 #include "Actions.h"
 #include "Debug.h"
+#include "Random.h"
 
 #include "../agents/Heuristics.h"
 
@@ -76,6 +77,19 @@ Actions::Action* GameLogic::Game::get_stochastic_action(Board::Board& game_board
     return StochasticCon.get_action(game_board);
 }
 
+void GameLogic::Game::resolve_stochastic_action(Board::Board& game_board){
+    StochasticCon.resolve_random(game_board);
+}
+
+void GameLogic::Game::stochastic_outcomes(Board::Board& game_board,std::vector<StochasticActions::ChanceOutcome>& outcomes){
+    StochasticCon.all_outcomes(game_board,outcomes);
+}
+
+Actions::Action* GameLogic::Game::stochastic_action_at(Board::Board& game_board,double quantile){
+    // (walks the same distribution stochastic_outcomes() lists, making only the chosen outcome)
+    return StochasticCon.action_at(game_board,quantile);
+}
+
 void GameLogic::Game::nonplayer_actions(bool verbose){
     // Designed to go until there there's either a required discard, OR non-player board transitions are complete, OR something breaks or game is lost
     // Right now this SKIPS any use of event cards during draw phase!
@@ -88,6 +102,13 @@ void GameLogic::Game::nonplayer_actions(Board::Board& game_board,bool verbose){
     // Right now this SKIPS any use of event cards during draw phase!
 
     // Stochastic check _includes_ check for terminal status of game (stochastic transitions can't be legal if the game has ended)
+    if(!verbose){
+        // Nothing gets logged, so there's no need for the action objects: draw and play each card straight onto the board
+        while(is_stochastic(game_board)){
+            resolve_stochastic_action(game_board);
+        }
+        return;
+    }
     while(is_stochastic(game_board)){
         // Get the next required action
         Actions::Action* next_action = get_stochastic_action(game_board);
@@ -154,7 +175,7 @@ Actions::Action* GameLogic::Game::get_random_action_uniform(Board::Board& game_b
         DEBUG_MSG("[Game::get_random_action_uniform()] There are a total of " << n_available_actions() << " available actions according to n_available_actions()");
     }
     // n_available_actions) includes nonzero additions where the group is legal
-    int randomized = rand() % n_available_actions(verbose);
+    int randomized = Random::search_rand() % n_available_actions(verbose);
     if(verbose){
         DEBUG_MSG(std::endl << "[Game::get_random_action_uniform()] Chose random number: " << randomized << " to choose an action.");
     }
@@ -236,7 +257,7 @@ Actions::Action* GameLogic::Game::get_random_action_bygroup(Board::Board& game_b
     }
 
     // Generate a random action constructor index
-    int randomized = rand() % max_n_actions;
+    int randomized = Random::search_rand() % max_n_actions;
     while(true){
         if(verbose){
             DEBUG_MSG("[get_random_action_bygroup()] Inside the action generation loop! Trying random number " << randomized << " (which is ");
@@ -258,7 +279,7 @@ Actions::Action* GameLogic::Game::get_random_action_bygroup(Board::Board& game_b
             if(verbose){
                 DEBUG_MSG(PlayerConstructorList[randomized] -> get_movetype() << ", and isn't legal...)" <<std::endl);
             }
-            randomized = rand() % max_n_actions;
+            randomized = Random::search_rand() % max_n_actions;
         }
     }
 }
@@ -346,7 +367,42 @@ void GameLogic::Game::applyAction(Actions::Action* action){
 
 bool GameLogic::Game::is_stochastic(Board::Board& game_board){
     // It's a stochastic state if (1) it's a stochastic phase of the game, (2) Forced discard isn't required, and (3) game hasn't ended
-    return StochasticCon.legal(game_board) && !ForcedDiscardCon.legal(game_board) && !is_terminal(game_board);
+    // which the board's phase already says (see Board::update_phase())
+    #ifdef PHASE_CHECK
+    check_phase(game_board,"is_stochastic");
+    #endif
+    Board::GamePhase phase = game_board.phase();
+    return phase==Board::PLAYER_DRAW || phase==Board::INFECT;
+}
+
+Board::GamePhase GameLogic::Game::derive_phase(Board::Board& game_board){
+    // The way is_terminal() and is_stochastic() used to work it out on every call
+    game_board.updatestatus();
+    if(game_board.broken()){
+        return Board::TERMINAL_BROKEN;
+    } else if(game_board.has_lost()){
+        return Board::TERMINAL_LOST;
+    } else if(game_board.has_won()){
+        return Board::TERMINAL_WON;
+    } else if(ForcedDiscardCon.legal(game_board)){
+        return Board::FORCED_DISCARD;
+    } else if(StochasticCon.player_draw_con.legal(game_board)){
+        return Board::PLAYER_DRAW;
+    } else if(StochasticCon.infect_draw_con.legal(game_board)){
+        return Board::INFECT;
+    }
+    return Board::PLAYER_ACTION;
+}
+
+bool GameLogic::Game::check_phase(Board::Board& game_board,std::string caller){
+    Board::GamePhase cached = game_board.phase();
+    Board::GamePhase derived = derive_phase(game_board);
+    if(cached!=derived){
+        game_board.broken()=true;
+        game_board.broken_reasons().push_back("[Game::" + caller + "()] Board's phase is " + std::to_string(cached) + " but its state says " + std::to_string(derived) + " (something changed it without update_phase())");
+        return false;
+    }
+    return true;
 }
 
 bool GameLogic::Game::is_terminal(bool sanity_check,bool verbose){
@@ -362,21 +418,23 @@ bool GameLogic::Game::is_terminal(Board::Board& game_board, bool sanity_check,bo
         SanityCheck::CheckBoard(game_board,verbose);
     }
 
-    // Have the board update any win/lose/broken status (this is an intentional redundancy)
-    game_board.updatestatus();
+    // The board updates its win/lose status on every action (Board::update_phase()), so this is a read
+    #ifdef PHASE_CHECK
+    check_phase(game_board,"is_terminal");
+    #endif
+    Board::GamePhase phase = game_board.phase();
 
-    bool broken = game_board.broken();
+    bool broken = phase==Board::TERMINAL_BROKEN;
     if(broken && verbose){
         for(std::string reason: game_board.broken_reasons()){
             DEBUG_MSG(std::endl << "[Game::is_terminal()] Game broke! One reason: " << reason);
         }
     }
-    bool won = game_board.has_won();
     bool lost = game_board.has_lost();
     if(lost && verbose){
         DEBUG_MSG(std::endl << "[Game::is_terminal()] LOST! because " <<  game_board.get_lost_reason() << std::endl);
     }
-    return won || lost || broken;
+    return phase>=Board::TERMINAL_WON;
 }
 
 int GameLogic::Game::reward(){
@@ -395,11 +453,11 @@ int GameLogic::Game::reward(Board::Board& game_board){
     }
 }
 
-double GameLogic::Game::rollout(Board::Board* game_board,Heuristics::Heuristic heuristic){
-    return rollout(*game_board,heuristic);
+double GameLogic::Game::rollout(Board::Board* game_board,Heuristics::Heuristic heuristic,std::vector<size_t>* played_actions){
+    return rollout(*game_board,heuristic,played_actions);
 }
 
-double GameLogic::Game::rollout(Board::Board& game_board,Heuristics::Heuristic heuristic){
+double GameLogic::Game::rollout(Board::Board& game_board,Heuristics::Heuristic heuristic,std::vector<size_t>* played_actions){
     // I've made the executive decision to always use the random_action_bygroup() method!
     // This is like the original game loop in `Experiment.cpp` BUT:
     //      * NO SANITY CHECK
@@ -409,6 +467,9 @@ double GameLogic::Game::rollout(Board::Board& game_board,Heuristics::Heuristic h
         nonplayer_actions(game_board);
         if(!is_terminal(game_board)){
             Actions::Action* random_action = get_random_action_bygroup(game_board);
+            if(played_actions){
+                played_actions -> push_back(Actions::action_key(random_action,game_board));
+            }
             random_action -> execute(game_board);
             delete random_action;
         }
@@ -417,67 +478,6 @@ double GameLogic::Game::rollout(Board::Board& game_board,Heuristics::Heuristic h
     return heuristic(game_board);
 }
 
-double GameLogic::Game::epsgreedy_heuristic_rollout(Board::Board& game_board, double epsilon, Heuristics::Heuristic selection_heuristic, Heuristics::Heuristic eval_heuristic){
-    while(!is_terminal(game_board)){
-        nonplayer_actions(game_board);
-        if(!is_terminal(game_board)){
-            // get all available action options
-            std::vector<Actions::Action*> all_actions = list_actions(game_board);
-
-            // instantiate tracking objects for best action and its heuristic score
-            double best_score = -1;
-            Actions::Action* best_action = nullptr;
-
-            // For each action...
-            for(Actions::Action* act : all_actions){
-                // Explicit copy current state copy of the current board state
-                Board::Board board_copy = Board::Board(game_board);
-
-                // Apply this action to the board
-                act -> execute(board_copy);
-
-                // Use the heuristic to evaluate the result, including a check for terminality
-                double state_score;
-                if(!board_copy.is_terminal()){
-                    // use the selection heuristic to evaluate successor states
-                    double state_score = selection_heuristic(board_copy);
-                } else {
-                    // If terminal, get the reward from the game logic
-                    double state_score = reward(board_copy);
-                }
-                if(state_score>best_score){
-                    // If this score is better than the existing max, then reset the "best" score and action.
-                    best_score = state_score;
-                    best_action = act;
-                }
-            }
-
-            // If a random uniform number <= epsilon, then...
-            if((float) rand()/ (float) RAND_MAX <= epsilon){
-                // Choose a non-max action uniformly at random
-                int random_index = rand() % all_actions.size();
-                while(all_actions[random_index]==best_action && all_actions.size()>1){
-                    // make sure we didn't just choose action already defined as best
-                    // Make sure that there's at least one other non-"best" action to choose from to avoid infinite loops
-                    random_index = rand() % all_actions.size();
-                }
-                
-                // redefine the best action
-                best_action = all_actions[random_index];
-            }
-
-            // use the "best action" to advance the board
-            best_action -> execute(game_board);
-
-            // Lastly delete everything to avoid a fat memory leak
-            for(Actions::Action* act : all_actions){
-                delete act;
-            }
-        }
-    }
-    return eval_heuristic(game_board);
-}
-
 std::vector<std::string> GameLogic::Game::terminal_reasons(){
     std::vector<std::string> reasons;
     if((*active_board).has_won()){
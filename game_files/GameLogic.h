@@ -1,12 +1,14 @@
 #ifndef GAMELOGIC_H
 #define GAMELOGIC_H
 
+#include <cstdlib>
 #include <vector>
 
 #include "Board.h"
 
 #include "Actions.h"
 #include "StochasticActions.h"
+#include "Random.h"
 
 #include "SanityCheck.h"
 
@@ -90,9 +92,17 @@ namespace GameLogic
         // To advance the non-player elements of the game
         void nonplayer_actions(bool verbose = false);
         // Advance the non-player elements in a given board
+        // (unless verbose, without making an action object per draw: see StochasticActions::StochasticActionConstructor::resolve_random())
         void nonplayer_actions(Board::Board& game_board,bool verbose=false);
         // generate a stochastic action (utility for search and nonplayer_actions)
         Actions::Action* get_stochastic_action(Board::Board& game_board);
+        // make the same draw get_stochastic_action() would and play it onto the board, for when nobody needs the action afterwards
+        void resolve_stochastic_action(Board::Board& game_board);
+        // every outcome get_stochastic_action() could produce on this board, with its exact probability (caller deletes the actions)
+        void stochastic_outcomes(Board::Board& game_board,std::vector<StochasticActions::ChanceOutcome>& outcomes);
+        // the outcome at `quantile` (in [0,1)) of stochastic_outcomes(), taken in the order they're listed (so e.g. every epidemic draw is in one stretch).
+        // It walks the card distributions and only makes the chosen action, rather than listing (and deleting) the rest
+        Actions::Action* stochastic_action_at(Board::Board& game_board,double quantile);
 
         // Check for game status (true if win/loss/broken)
         // sanity check argument to include whether or not to go through all SanityCheck::CheckBoard() checks before determining terminal state.
@@ -103,6 +113,12 @@ namespace GameLogic
         // Check if the state of a game board is stochastic
         bool is_stochastic(Board::Board& game_board);
 
+        // is_terminal() and is_stochastic() just read the phase the board keeps (Board::update_phase()).
+        // derive_phase() works it out the long way, from the constructors' legal() checks, like they used to.
+        // Built with -DPHASE_CHECK, both of them compare the two on every call (check_phase()), and break the board if they disagree.
+        Board::GamePhase derive_phase(Board::Board& game_board);
+        bool check_phase(Board::Board& game_board,std::string caller);
+
         // return a vector of reasons that the game is terminal, for diagnostics.
         std::vector<std::string> terminal_reasons(); // 
 
@@ -114,14 +130,19 @@ namespace GameLogic
 
         // Get the reward from rolling out a game (w/ bygroup_random action selection), using a given heuristic to evaluate the end-state
         // By default just return the 0/1 loss/win value
-        double rollout(Board::Board* game_board,Heuristics::Heuristic heuristic = Heuristics::PureGameReward);
-        double rollout(Board::Board& game_board,Heuristics::Heuristic heuristic = Heuristics::PureGameReward);
+        // If `played_actions` is given, the Actions::action_key() of every player action taken is appended to it (for RAVE, see Search::RaveOptions)
+        double rollout(Board::Board* game_board,Heuristics::Heuristic heuristic = Heuristics::PureGameReward,std::vector<size_t>* played_actions = nullptr);
+        double rollout(Board::Board& game_board,Heuristics::Heuristic heuristic = Heuristics::PureGameReward,std::vector<size_t>* played_actions = nullptr);
 
         // Get the reward from rolling out a game with a epsilon-greedy heuristic local search (select highest value next action w.p. 1-epsilon, else uniform other action)
         // Evaluate the terminal state with a separate (or same!) heuristic
         // selection heuristic  = one that dictates what action to pick based on next boardstate value
         // eval heuristic       = one that evaluates the final terminal board state, whose value will be returned as a rollout reward
-        double epsgreedy_heuristic_rollout(Board::Board& game_board, double epsilon, Heuristics::Heuristic selection_heuristic, Heuristics::Heuristic eval_heuristic = Heuristics::PureGameReward);
+        // Either can be a plain heuristic function or anything callable on a board (see HeuristicCombinators.h) - it's a template so the selection
+        // heuristic, called on every successor of every step, can be inlined here rather than called through a pointer.
+        // `played_actions` as for rollout()
+        template<class SelectionHeuristic,class EvalHeuristic = Heuristics::Heuristic*>
+        double epsgreedy_heuristic_rollout(Board::Board& game_board, double epsilon, SelectionHeuristic selection_heuristic, EvalHeuristic eval_heuristic = Heuristics::PureGameReward,std::vector<size_t>* played_actions = nullptr);
 
         // Board pointer for affixing to actions as necessary
         Board::Board* get_board_ptr();
@@ -130,4 +151,71 @@ namespace GameLogic
     };
 }
 
+template<class SelectionHeuristic,class EvalHeuristic>
+double GameLogic::Game::epsgreedy_heuristic_rollout(Board::Board& game_board, double epsilon, SelectionHeuristic selection_heuristic, EvalHeuristic eval_heuristic,std::vector<size_t>* played_actions){
+    while(!is_terminal(game_board)){
+        nonplayer_actions(game_board);
+        if(!is_terminal(game_board)){
+            // get all available action options
+            std::vector<Actions::Action*> all_actions = list_actions(game_board);
+
+            // instantiate tracking objects for best action and its heuristic score
+            double best_score = -1;
+            Actions::Action* best_action = nullptr;
+
+            // For each action...
+            for(Actions::Action* act : all_actions){
+                // Explicit copy current state copy of the current board state
+                Board::Board board_copy = Board::Board(game_board);
+
+                // Apply this action to the board
+                act -> execute(board_copy);
+
+                // Use the heuristic to evaluate the result, including a check for terminality
+                // (these used to declare their own state_score inside each branch, so the score compared below was never set)
+                double state_score;
+                if(!board_copy.is_terminal()){
+                    // use the selection heuristic to evaluate successor states
+                    state_score = selection_heuristic(board_copy);
+                } else {
+                    // If terminal, get the reward from the game logic
+                    state_score = reward(board_copy);
+                }
+                if(state_score>best_score){
+                    // If this score is better than the existing max, then reset the "best" score and action.
+                    best_score = state_score;
+                    best_action = act;
+                }
+            }
+
+            // If a random uniform number <= epsilon, then...
+            if((float) Random::search_rand()/ (float) RAND_MAX <= epsilon){
+                // Choose a non-max action uniformly at random
+                int random_index = Random::search_rand() % all_actions.size();
+                while(all_actions[random_index]==best_action && all_actions.size()>1){
+                    // make sure we didn't just choose action already defined as best
+                    // Make sure that there's at least one other non-"best" action to choose from to avoid infinite loops
+                    random_index = Random::search_rand() % all_actions.size();
+                }
+                
+                // redefine the best action
+                best_action = all_actions[random_index];
+            }
+
+            if(played_actions){
+                played_actions -> push_back(Actions::action_key(best_action,game_board));
+            }
+
+            // use the "best action" to advance the board
+            best_action -> execute(game_board);
+
+            // Lastly delete everything to avoid a fat memory leak
+            for(Actions::Action* act : all_actions){
+                delete act;
+            }
+        }
+    }
+    return eval_heuristic(game_board);
+}
+
 #endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <string>
 #include <cassert>
 #include <array>
+#include <algorithm>
 
 #include "Players.h"
 #include "Map.h"
@@ -48,6 +49,7 @@ void Players::Player::reset(){
     position = 3;
     hand.clear();
     event_cards.clear();
+    color_counts = {0,0,0,0};
     used_OperationsExpertFlight=false;
 }
 
@@ -59,6 +61,7 @@ bool Players::Player::hand_full(){
 void Players::Player::UpdateHand(int drawn_card){
     if(!Decks::IS_EVENT(drawn_card) && !Decks::IS_EPIDEMIC(drawn_card)){
         hand.push_back(drawn_card);
+        color_counts[Decks::CARD_COLOR(drawn_card)]++;
     } else if(Decks::IS_EVENT(drawn_card)){
         event_cards.push_back(drawn_card);
     } else {
@@ -81,27 +84,7 @@ int Players::Player::handsize(){
 }
 
 std::array<int,4> Players::Player::get_color_count(){
-    int BLUE_count=0,YELLOW_count=0,BLACK_count=0,RED_count=0;
-    for(int& card: hand){
-        switch(Decks::CARD_COLOR(card)){
-            case Map::BLUE:
-                BLUE_count++;
-                break;
-            case Map::YELLOW:
-                YELLOW_count++;
-                break;
-            case Map::BLACK:
-                BLACK_count++;
-                break;
-            case Map::RED:
-                RED_count++;
-                break;
-            default:
-                DEBUG_MSG("[Player::get_color_count()] Encountered a card in " << role.name << " hand with no color! (color: " << Decks::CARD_COLOR(card) << ", name: " << Decks::CARD_NAME(card) << ")" <<std::endl);
-                break;
-        }
-    }
-    return {BLUE_count,YELLOW_count,BLACK_count,RED_count};
+    return color_counts;
 }
 
 void Players::Player::set_position(Map::City& new_city){
@@ -117,6 +100,7 @@ void Players::Player::removeCard(int card_to_remove){
     int hand_idx=0;
     for(int& card:hand){
         if(card==card_to_remove){
+            color_counts[Decks::CARD_COLOR(card_to_remove)]--;
             hand.erase(hand.begin()+hand_idx);
             return;
         }
@@ -139,6 +123,7 @@ void Players::Player::removeCureCardColor(int col){
         // Erase card indices from 
         if(Decks::CARD_COLOR(hand[checkpoint])==col){
             hand.erase(hand.begin()+checkpoint);
+            color_counts[col]--;
             num_erased++;
         } else{
             checkpoint++;
@@ -51,6 +51,9 @@ namespace Players
 
         // player position by city index
         int position; 
+
+        // How many cards of each color are in `hand`, kept up to date by the hand mutators below (see get_color_count())
+        std::array<int,4> color_counts = {0,0,0,0};
     public:
         Player(int role_id);
         Player();
@@ -65,15 +68,14 @@ namespace Players
 
             position = other.position;
 
-            hand.clear();
-            for(int c: other.hand){
-                hand.push_back(c);
-            }
+            // (with room for the two cards of the next player draw, so drawing on a copy never has to grow the hand)
+            hand.reserve(other.hand.size()+2);
+            hand.assign(other.hand.begin(),other.hand.end());
 
-            event_cards.clear();
-            for(int e: other.event_cards){
-                event_cards.push_back(e);
-            }
+            event_cards.reserve(other.event_cards.size()+2);
+            event_cards.assign(other.event_cards.begin(),other.event_cards.end());
+
+            color_counts = other.color_counts;
 
             role = other.role;
             used_OperationsExpertFlight = other.used_OperationsExpertFlight;
@@ -102,7 +104,7 @@ namespace Players
         void removeCard(int card);
         // Get rid of the last required_cure_cards cards of color col in player hand (called during Cure::execute())
         void removeCureCardColor(int col);
-        // Check number of each color of card they have
+        // Check number of each color of card they have (kept as cards come and go, so this doesn't look through the hand)
         std::array<int,4> get_color_count();
 
         // Return the city representing current position
@@ -0,0 +1,78 @@
+#include <cstdlib>
+
+#include "Random.h"
+
+namespace
+{
+    // Streams in use by this thread's real game (nullptr -> fall back to rand())
+    thread_local Random::ChanceStreams* active_streams = nullptr;
+    // Stream for everything else on this thread (nullptr -> rand())
+    thread_local Random::Stream* active_search = nullptr;
+
+    // splitmix64 finalizer
+    uint64_t mix(uint64_t x){
+        x += 0x9e3779b97f4a7c15ull;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return x ^ (x >> 31);
+    }
+}
+
+Random::Stream::Stream(uint64_t seed):
+    engine((std::mt19937::result_type) seed)
+{}
+
+void Random::Stream::seed(uint64_t seed){
+    engine.seed((std::mt19937::result_type) (seed ^ (seed >> 32)));
+}
+
+int Random::Stream::next(){
+    return (int) (engine() % ((unsigned long) RAND_MAX + 1ul));
+}
+
+void Random::ChanceStreams::seed(uint64_t seed){
+    player_deck.seed(mix(seed));
+    infect_deck.seed(mix(seed ^ 0x5bd1e995ull));
+}
+
+Random::ChanceScope::ChanceScope(ChanceStreams* streams){
+    previous = active_streams;
+    if(streams){
+        active_streams = streams;
+    }
+}
+
+Random::ChanceScope::~ChanceScope(){
+    active_streams = previous;
+}
+
+Random::SearchScope::SearchScope(Stream* stream){
+    previous = active_search;
+    if(stream){
+        active_search = stream;
+    }
+}
+
+Random::SearchScope::~SearchScope(){
+    active_search = previous;
+}
+
+int Random::player_chance(){
+    return active_streams ? active_streams -> player_deck.next() : search_rand();
+}
+
+int Random::infect_chance(){
+    return active_streams ? active_streams -> infect_deck.next() : search_rand();
+}
+
+int Random::search_rand(){
+    return active_search ? active_search -> next() : rand();
+}
+
+uint64_t Random::GameSeed(uint64_t base_seed,int game){
+    return mix(base_seed + mix((uint64_t) game));
+}
+
+uint64_t Random::SearchSeed(uint64_t base_seed,int game){
+    return mix(GameSeed(base_seed,game) ^ 0xc2b2ae3d27d4eb4full);
+}
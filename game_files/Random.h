@@ -0,0 +1,71 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <random>
+
+// Random number streams for the *real* game's chance events (card draws), kept apart from everything else.
+//
+// Everything else (agents' choices, search, random actions in rollouts) draws from search_rand(), which is the global rand() unless a
+// SearchScope is active. If the decks drew from it too, the deck order of a game would depend on how many random numbers the agent burned
+// while thinking, so two agents could never be shown the same cards.
+// Deck draws go through player_chance()/infect_chance() instead, which:
+//      - with no ChanceScope active (the default), just return search_rand()
+//      - inside a ChanceScope, pull from that scope's seeded streams
+// Experiments wrap the real board's setup and nonplayer_actions() in a ChanceScope; draws made during search (determinizations, rollouts)
+// happen outside of it and so never touch the game's streams.
+//
+// Seeded experiments also open a SearchScope for each game, so that the game plays out the same whichever thread it runs on
+// (rand() is shared by every thread of a sweep).
+namespace Random
+{
+    // One seeded generator returning ints in [0,RAND_MAX], so it can stand in for rand() at any call site
+    class Stream{
+        std::mt19937 engine;
+    public:
+        Stream(uint64_t seed=5489u);
+
+        void seed(uint64_t seed);
+        int next();
+    };
+
+    // The player deck and infect deck get their own streams so that e.g. a quiet night (which skips infect draws)
+    // doesn't shift every later player card too.
+    struct ChanceStreams{
+        Stream player_deck;
+        Stream infect_deck;
+
+        void seed(uint64_t seed);
+    };
+
+    // Point deck draws on this thread at `streams` for the lifetime of the scope (nullptr = leave things as they are)
+    class ChanceScope{
+        ChanceStreams* previous;
+    public:
+        ChanceScope(ChanceStreams* streams);
+        ~ChanceScope();
+    };
+
+    // Point search_rand() on this thread at `stream` for the lifetime of the scope (nullptr = leave things as they are)
+    class SearchScope{
+        Stream* previous;
+    public:
+        SearchScope(Stream* stream);
+        ~SearchScope();
+    };
+
+    // rand()-equivalents for deck draws
+    int player_chance();
+    int infect_chance();
+
+    // rand()-equivalent for everything that isn't a real deck draw
+    int search_rand();
+
+    // Seed for game `game` of a run seeded with `base_seed` (mixed so that neighbouring games are unrelated)
+    uint64_t GameSeed(uint64_t base_seed,int game);
+
+    // Seed for the search stream of game `game` (unrelated to its deck streams, so that searching never tells an agent about the deck)
+    uint64_t SearchSeed(uint64_t base_seed,int game);
+}
+
+#endif
@@ -9,11 +9,63 @@
 #include <algorithm>
 #include <string>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+namespace
+{
+    // Every tier reports the same way CheckBoard() does
+    void mark_broken(Board::Board& active_board,std::string reason,bool verbose){
+        if(verbose){
+            DEBUG_MSG("[SANITYCHECK] ... " << reason << std::endl);
+        }
+        active_board.broken()=true;
+        active_board.broken_reasons().push_back("[SANITYCHECK] " + reason);
+    }
+
+    // Player cards run 0-47 (cities), 48-50 (events) and 51+ (epidemics, which never stay anywhere)
+    const int PLAYER_CARDS = 51;
+}
+
+void SanityCheck::QuickCheck(Board::Board& active_board,bool verbose){
+    int turn_action = active_board.get_turn_action();
+    if(turn_action<0 || turn_action>5){
+        mark_broken(active_board,"turn_action is ill defined: it's currently " + std::to_string(turn_action),verbose);
+    }
+    if(turn_action<=4 && active_board.get_infect_cards_drawn()>0){
+        mark_broken(active_board,"infect_cards_drawn is "+std::to_string(active_board.get_infect_cards_drawn())+" but should be 0 since its stage " + std::to_string(turn_action),verbose);
+    }
+    if((turn_action<=3 || turn_action==5) && active_board.get_player_cards_drawn()>0){
+        mark_broken(active_board,"player_cards_drawn is "+std::to_string(active_board.get_player_cards_drawn())+" but should be 0 since its stage " + std::to_string(turn_action),verbose);
+    }
+    if(active_board.get_epidemic_count()<0 || active_board.get_epidemic_count()>active_board.get_difficulty()){
+        mark_broken(active_board,"Difficulty is " + std::to_string(active_board.get_difficulty()) + " and "+ std::to_string(active_board.get_epidemic_count())+" epidemics have been drawn",verbose);
+    }
+    for(int col=0;col<4;col++){
+        // (more than 24 is a loss, not a broken board, so only the bottom end is checked)
+        if(active_board.get_color_count()[col]<0){
+            mark_broken(active_board,Map::COLORS[col] + " has " + std::to_string(active_board.get_color_count()[col]) + " cubes on the board",verbose);
+        }
+    }
+    for(Players::Player& p: active_board.get_players()){
+        if(p.handsize()>8){
+            mark_broken(active_board,p.role.name+" has " +std::to_string(p.handsize()) + " cards! ("+std::to_string(p.hand.size())+" city cards and " +std::to_string(p.event_cards.size()) + " event cards)",verbose);
+        }
+        if(p.get_position()<0 || p.get_position()>48){
+            mark_broken(active_board,p.role.name + " has position listed as " + std::to_string(p.get_position()) + "!",verbose);
+        }
+    }
+}
 
 void SanityCheck::CheckBoard(Board::Board& active_board,bool verbose){
 
     // Designed to collect ALL badness instead of breaking and failing fast.
 
+    // Everything QuickCheck() looks at (turn_action, the draw counters, hand sizes, epidemics, positions, cube totals)
+    QuickCheck(active_board,verbose);
+
     // make sure all disease counts are >=0 and <=3
     if(verbose){
         DEBUG_MSG(std::endl << "[SANITYCHECK] Checking disease counts on each city..." << std::endl);
@@ -33,55 +85,6 @@ void SanityCheck::CheckBoard(Board::Board& active_board,bool verbose){
         DEBUG_MSG("[SANITYCHECK] done!" << std::endl);
     }
 
-    // make sure turn action is >=0 and <=5
-    if(verbose){
-        DEBUG_MSG(std::endl << "[SANITYCHECK] Checking that turn_action on board is well defined..." << std::endl);
-    }
-    if(active_board.get_turn_action()<0 || active_board.get_turn_action()>5){
-        if(verbose){
-            DEBUG_MSG(std::endl << "[SANITYCHECK] turn_action is ill defined: it's currently " << active_board.get_turn_action() << std::endl);
-        }
-        active_board.broken()=true;
-        active_board.broken_reasons().push_back("[SANITYCHECK] turn_action is ill defined: it's currently " + std::to_string(active_board.get_turn_action()));
-    }
-    if(verbose){
-        DEBUG_MSG("[SANITYCHECK] done!" << std::endl);
-    }
-
-    // make sure infect card drawn counters are 0 when it's not infect stage of the game
-    if(verbose){
-        DEBUG_MSG(std::endl << "[SANITYCHECK] Checking infection card drawn counter is 0 when not infect step..." << std::endl);
-    }
-    if(active_board.get_turn_action()<=4){
-        if(active_board.get_infect_cards_drawn()>0){
-            if(verbose){
-                DEBUG_MSG("[SANITYCHECK] ... but on turn-action " << active_board.get_turn_action() << " the counter is >0!" << std::endl);
-            }
-            active_board.broken()=true;
-            active_board.broken_reasons().push_back("[SANITYCHECK] infect_cards_drawn is "+std::to_string(active_board.get_infect_cards_drawn())+" but should be 0 since its stage + " + std::to_string(active_board.get_turn_action()) );
-        }
-    }
-    if(verbose){
-        DEBUG_MSG("[SANITYCHECK] done!" << std::endl);
-    }
-
-    // make sure player card draw is 0 outside of that stage
-    if(verbose){
-        DEBUG_MSG(std::endl << "[SANITYCHECK] Checking player cards drawn counter is 0 when not player draw step..." << std::endl);
-    }
-    if(active_board.get_turn_action()<=3 || active_board.get_turn_action()==5){
-        if(active_board.get_player_cards_drawn()>0){
-            if(verbose){
-                DEBUG_MSG("[SANITYCHECK] ... but on turn-action " << active_board.get_turn_action() << " the counter is >0!" << std::endl);
-            }
-            active_board.broken()=true;
-            active_board.broken_reasons().push_back("[SANITYCHECK] player_cards_drawn is "+std::to_string(active_board.get_player_cards_drawn())+" but should be 0 since its stage + " + std::to_string(active_board.get_turn_action()) );
-        }
-    }
-    if(verbose){
-        DEBUG_MSG("[SANITYCHECK] done!" << std::endl);
-    }
-
     // make sure no player has duplicate cards (city or event)
     // The most costly part 4 sure
     if(verbose){
@@ -119,39 +122,6 @@ void SanityCheck::CheckBoard(Board::Board& active_board,bool verbose){
         DEBUG_MSG("[SANITYCHECK] done!" << std::endl);
     }
 
-    // Check that all player hands are at most size 8
-    // Size 8 is allowed given that ForcedDiscard is _supposed_ to be called whenever this is the case
-    if(verbose){
-        DEBUG_MSG(std::endl <<  "[SANITYCHECK] Checking all players have <=8 cards..." << std::endl);
-    }
-    for(Players::Player& p: active_board.get_players()){
-        if(p.handsize()>8){
-            if(verbose){
-                DEBUG_MSG("... but " << p.role.name << " has " << p.handsize() << " cards!" << std::endl);
-            }
-            active_board.broken()=true;
-            active_board.broken_reasons().push_back("[SANITYCHECK] " + p.role.name+" has " +std::to_string(p.handsize()) + " cards! ("+std::to_string(p.hand.size())+" city cards and " +std::to_string(p.event_cards.size()) + " event cards)");
-        }
-    }
-    if(verbose){
-        DEBUG_MSG("[SANITYCHECK] done!" << std::endl);
-    }
-
-    // Epidemics drawn should be 0<=epidemics <= difficulty
-    if(verbose){
-        DEBUG_MSG(std::endl <<  "[SANITYCHECK] Checking that there are <=difficulty epidemic cards drawn" << std::endl);
-    }
-    if(active_board.get_epidemic_count()<0 || active_board.get_epidemic_count()>active_board.get_difficulty()){
-        if(verbose){
-            DEBUG_MSG("[SANITYCHECK] ... but there are " << active_board.get_epidemic_count() << " epidemics, even though difficulty is " << active_board.get_difficulty() << std::endl);
-        }
-        active_board.broken()=true;
-        active_board.broken_reasons().push_back("[SANITYCHECK] Difficulty is " + std::to_string(active_board.get_difficulty()) + " and "+ std::to_string(active_board.get_epidemic_count())+" epidemics have been drawn");
-    }
-    if(verbose){
-        DEBUG_MSG("[SANITYCHECK] done!" << std::endl);
-    }
-
     // Make sure disease_sum is returning same value as the actual disease tracking array disease_count
     // (this is a very suboptimal sanity check, but my experiments show that even with it, keeping a separate integer tracker reaps small rewards)
     if(verbose){
@@ -189,18 +159,186 @@ void SanityCheck::CheckBoard(Board::Board& active_board,bool verbose){
         DEBUG_MSG("[SANITYCHECK] done!" << std::endl);
     }
 
-    // Make sure disease_sum is returning same value as the actual disease tracking array disease_count
-    // (this is a very suboptimal sanity check, but my experiments show that even with it, keeping a separate integer tracker reaps small rewards)
+    // And the other things the board and players keep up to date instead of recounting (the 3-cube and station masks, and each hand's colors)
     if(verbose){
-        DEBUG_MSG(std::endl <<  "[SANITYCHECK] Checking that every player position is 0<= position <= 48" << std::endl);
+        DEBUG_MSG(std::endl << "[SANITYCHECK] Recounting the 3-cube cities, research stations and colors in hand..." << std::endl);
     }
+    for(int col=0;col<4;col++){
+        unsigned long long three_cube = 0;
+        for(int city=0;city<Map::CITIES.size();city++){
+            if(active_board.get_disease_count()[col][city]==3){
+                three_cube |= 1ULL << city;
+            }
+        }
+        if(three_cube!=active_board.get_3cube_cities(col)){
+            mark_broken(active_board,"the 3-cube " + Map::COLORS[col] + " cities kept don't match the disease counts",verbose);
+        }
+    }
+    unsigned long long stations = 0;
+    unsigned long long next_to_stations = 0;
+    for(int st: active_board.get_stations()){
+        if(st<0 || st>=Map::CITIES.size()){
+            mark_broken(active_board,"there's a research station on city " + std::to_string(st),verbose);
+            continue;
+        }
+        if((stations >> st) & 1ULL){
+            mark_broken(active_board,"there are two research stations on " + Map::CITIES[st].name,verbose);
+        }
+        stations |= 1ULL << st;
+        for(int neighbor: Map::CITIES[st].neighbors){
+            next_to_stations |= 1ULL << neighbor;
+        }
+    }
+    if(stations!=active_board.get_station_cities()){
+        mark_broken(active_board,"the research station cities kept don't match the list of stations",verbose);
+    }
+    for(int city=0;city<(int) Map::CITIES.size();city++){
+        if(active_board.next_to_station(city)!=(bool) ((next_to_stations >> city) & 1ULL)){
+            mark_broken(active_board,"the cities kept as next to a research station don't match the list of stations",verbose);
+            break;
+        }
+    }
+
     for(Players::Player& p: active_board.get_players()){
-        if(p.get_position()<0 || p.get_position()>48){
-            active_board.broken()=true;
-            active_board.broken_reasons().push_back("[SANITYCHECK] "+ p.role.name + " has position listed as " + std::to_string(p.get_position()) + "!");
+        std::array<int,4> hand_colors = {0,0,0,0};
+        for(int card: p.hand){
+            // (cards that aren't city cards are ParanoidCheck()'s)
+            if(card>=0 && card<48){
+                hand_colors[Decks::CARD_COLOR(card)]++;
+            }
+        }
+        if(hand_colors!=p.get_color_count()){
+            mark_broken(active_board,"the cards per color kept for " + p.role.name + " don't match their hand",verbose);
+        }
+    }
+    if(verbose){
+        DEBUG_MSG("[SANITYCHECK] done!" << std::endl);
+    }
+}
+
+void SanityCheck::ParanoidCheck(Board::Board& active_board,bool verbose){
+    CheckBoard(active_board,verbose);
+
+    if(verbose){
+        DEBUG_MSG(std::endl << "[SANITYCHECK] Checking no card is in two places at once..." << std::endl);
+    }
+    // Where each player card is (-1 = the player deck, p = player p's hand, -2 = nowhere we can see)
+    std::array<int,PLAYER_CARDS> card_place;
+    card_place.fill(-2);
+    for(int card: active_board.get_playerdeck_remaining_cards()){
+        if(card<0 || card>=PLAYER_CARDS || card_place[card]!=-2){
+            mark_broken(active_board,"the player deck has " + std::to_string(card) + " in it more than once (or it isn't a card)",verbose);
+            continue;
+        }
+        card_place[card] = -1;
+    }
+    for(int p=0;p<active_board.get_players().size();p++){
+        Players::Player& player = active_board.get_players()[p];
+        for(std::vector<int>* cards: {&player.hand,&player.event_cards}){
+            for(int card: *cards){
+                if(card<0 || card>=PLAYER_CARDS){
+                    mark_broken(active_board,player.role.name + " is holding " + std::to_string(card) + ", which isn't a card",verbose);
+                } else if(card_place[card]==-1){
+                    mark_broken(active_board,player.role.name + " is holding " + Decks::CARD_NAME(card) + ", which is still in the player deck",verbose);
+                } else if(card_place[card]>=0 && card_place[card]!=p){
+                    // (a player holding it twice is CheckBoard()'s)
+                    mark_broken(active_board,player.role.name + " and " + active_board.get_players()[card_place[card]].role.name + " are both holding " + Decks::CARD_NAME(card),verbose);
+                } else {
+                    card_place[card] = p;
+                }
+            }
+        }
+    }
+    std::array<bool,48> in_infect_deck;
+    in_infect_deck.fill(false);
+    for(std::vector<int>& group: active_board.get_infectdeck_stack()){
+        for(int card: group){
+            if(card<0 || card>=48 || in_infect_deck[card]){
+                mark_broken(active_board,"the infect deck has " + std::to_string(card) + " in it more than once (or it isn't a card)",verbose);
+                continue;
+            }
+            in_infect_deck[card] = true;
+            if(active_board.in_infect_discard(card)){
+                mark_broken(active_board,Decks::CARD_NAME(card) + " is in both the infect deck and its discard",verbose);
+            }
+        }
+    }
+
+    if(verbose){
+        DEBUG_MSG(std::endl << "[SANITYCHECK] Checking the kept phase is still the right one..." << std::endl);
+    }
+    if(!active_board.broken()){
+        Board::Board rederived = active_board;
+        rederived.update_phase();
+        if(rederived.phase()!=active_board.phase()){
+            mark_broken(active_board,"the board's phase is " + std::to_string(active_board.phase()) + " but update_phase() makes it " + std::to_string(rederived.phase()),verbose);
         }
     }
     if(verbose){
         DEBUG_MSG("[SANITYCHECK] done!" << std::endl);
     }
-}
\ No newline at end of file
+}
+
+SanityCheck::Checker::Checker(SanityCheck::Schedule _schedule){
+    schedule = _schedule;
+}
+
+void SanityCheck::Checker::start_game(int game_num){
+    // Game game_num is one of the fully checked games when the running count of them, game_fraction*games, ticks over on it
+    full_game = std::floor((game_num+1)*schedule.game_fraction) > std::floor(game_num*schedule.game_fraction);
+    steps = 0;
+    games++;
+}
+
+void SanityCheck::Checker::step(Board::Board& active_board,bool verbose){
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    steps++;
+    // (CheckBoard() and ParanoidCheck() start with QuickCheck(), so a step never needs two of them)
+    if(full_game || (schedule.full_every>0 && steps % schedule.full_every==0)){
+        if(schedule.paranoid){
+            ParanoidCheck(active_board,verbose);
+            checks[PARANOID]++;
+        } else {
+            CheckBoard(active_board,verbose);
+            checks[FULL]++;
+        }
+    } else {
+        QuickCheck(active_board,verbose);
+        checks[QUICK]++;
+    }
+    check_seconds+= std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SanityCheck::Checker::end_game(Board::Board& active_board,bool verbose){
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if(schedule.paranoid){
+        ParanoidCheck(active_board,verbose);
+        checks[PARANOID]++;
+    } else {
+        CheckBoard(active_board,verbose);
+        checks[FULL]++;
+    }
+    check_seconds+= std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double SanityCheck::Checker::seconds_per_game(){
+    return games>0 ? check_seconds/(double) games : 0;
+}
+
+double SanityCheck::Checker::overhead(double play_seconds){
+    return play_seconds>0 ? check_seconds/play_seconds : 0;
+}
+
+std::string SanityCheck::Checker::describe(){
+    std::string full = schedule.paranoid ? "paranoid" : "full";
+    std::string description = "quick every step, " + full + " on the final board";
+    if(schedule.full_every>0){
+        description+= " and every " + std::to_string(schedule.full_every) + " steps";
+    }
+    if(schedule.game_fraction>0){
+        std::ostringstream percent;
+        percent << schedule.game_fraction*100.;
+        description+= " and every step of " + percent.str() + "% of games";
+    }
+    return description;
+}
@@ -1,12 +1,70 @@
 #ifndef SANITY_CHECK_H
 #define SANITY_CHECK_H
 
+#include <array>
+#include <string>
+
 #include "Board.h"
 
 namespace SanityCheck{
+    // Three tiers of checks, cheapest first. Each one runs the tier below it first, so one call is all a board needs.
+    // They only ever set BROKEN (and push their reasons), so they can be mixed freely.
+
+    // The checks that only look at a handful of integers per player (turn_action, the draw counters, hand sizes, epidemics, positions, cube totals).
+    // Cheap enough to run after every step of every game.
+    void QuickCheck(Board::Board& active_board,bool verbose=false);
+
     // Goal of this function is just to update BROKEN status of board if the board is broke
     // Want to concentrate as many logical checks here as possible
+    // QuickCheck(), plus each city's cubes, duplicate cards in a hand, and what the board and players keep up to date instead of recounting
+    // (cube totals, the 3-cube and station masks, each hand's cards per color)
     void CheckBoard(Board::Board& active_board,bool verbose=false);
+
+    // CheckBoard(), plus the checks that look across the whole board: no card in two places at once (hands, player deck, infect deck and discard),
+    // and the kept phase against Board::update_phase() on a copy.
+    // For tests and playtesting.
+    void ParanoidCheck(Board::Board& active_board,bool verbose=false);
+
+    enum Tier{QUICK, FULL, PARANOID};
+
+    // When a Checker runs which tier. Every step gets exactly one: QuickCheck(), unless the schedule makes it a full one:
+    struct Schedule{
+        // CheckBoard() every this many steps of every game (0 = only on the board each game ends on)
+        int full_every = 0;
+        // Fraction of games (spread evenly over the run) that get CheckBoard() after every step
+        double game_fraction = 0;
+        // ParanoidCheck() instead of CheckBoard() wherever that would run
+        bool paranoid = false;
+    };
+
+    // Runs a Schedule over the steps of a run of games (see Experiments::PlayGame()), and keeps count of what the checks cost
+    class Checker{
+        bool full_game = false;
+        int steps = 0;
+    public:
+        Checker(Schedule _schedule=Schedule());
+
+        Schedule schedule;
+
+        // Checks run of each Tier, and the seconds spent in all of them, over every game so far
+        std::array<long,3> checks = {0,0,0};
+        double check_seconds = 0;
+        int games = 0;
+
+        // Game `game_num` of the run is about to start (decides whether it's one of the game_fraction fully checked games)
+        void start_game(int game_num);
+        // After every step: the full tier if it's due, QuickCheck() otherwise (the full tier includes it)
+        void step(Board::Board& active_board,bool verbose=false);
+        // The full tier on the board the game ended on
+        void end_game(Board::Board& active_board,bool verbose=false);
+
+        // Average seconds per game spent checking, or as a fraction of `play_seconds` (the total time of the games)
+        double seconds_per_game();
+        double overhead(double play_seconds);
+
+        // e.g. "quick every step, full every 100 steps and on 10% of games" for experiment headers
+        std::string describe();
+    };
 }
 
-#endif
\ No newline at end of file
+#endif
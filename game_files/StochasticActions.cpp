@@ -15,6 +15,10 @@ StochasticActions::PlayerCardDrawAction::PlayerCardDrawAction(int card):
     }
 
 void StochasticActions::PlayerCardDrawAction::execute(Board::Board& game_board){
+    resolve(game_board,card_drawn);
+}
+
+void StochasticActions::PlayerCardDrawAction::resolve(Board::Board& game_board,int card_drawn){
 
     game_board.updatePlayerDeck(card_drawn);
 
@@ -39,12 +43,22 @@ void StochasticActions::PlayerCardDrawAction::execute(Board::Board& game_board){
         // otherwise just increment and continue
         game_board.get_player_cards_drawn()++;
     }
+    game_board.update_phase();
 }
 
 std::string StochasticActions::PlayerCardDrawAction::repr(){
     return movetype + " drew " + Decks::CARD_NAME(card_drawn);
 }
 
+bool StochasticActions::PlayerCardDrawAction::possible(Board::Board& game_board){
+    if(game_board.get_turn_action()!=4 || game_board.get_player_cards_drawn()>1 || !game_board.player_deck_nonempty()){
+        return false;
+    }
+    Decks::CardDistribution player_cards;
+    game_board.playerdeck_distribution(player_cards);
+    return player_cards.probability(card_drawn)>0;
+}
+
 bool StochasticActions::PlayerCardDrawAction::legal(Board::Board& game_board){
     // Legal if it's the player's draw turn...
     if(game_board.get_turn_action()==4){
@@ -71,10 +85,20 @@ StochasticActions::EpidemicDrawAction::EpidemicDrawAction(int _epidemic_card,int
     }
 
 void StochasticActions::EpidemicDrawAction::execute(Board::Board& game_board){
-    
-    strrep = "";
-    
     bool quarantine_adjacent = false;
+    std::array<int,2> outbreak_status = resolve(game_board,epidemic_card,infect_card_drawn,quarantine_adjacent);
+
+    // Assigned rather than appended, so that it's impossible to end up double-concatenating outbreak strings when the action is replayed
+    if(!quarantine_adjacent){
+        strrep =" (caused " + std::to_string(outbreak_status[0]) + " total outbreak(s) - "+std::to_string(outbreak_status[1])+" blocked)";
+    } else {
+        strrep =" (blocked by quarantine specialist!)";
+    }
+}
+
+std::array<int,2> StochasticActions::EpidemicDrawAction::resolve(Board::Board& game_board,int epidemic_card,int infect_card_drawn,bool& quarantine_adjacent){
+    quarantine_adjacent = false;
+    std::array<int,2> outbreak_status = {0,0};
 
     // update this infect deck to reflect this card having been drawn from the bottom and used
     game_board.updateInfectDeck(infect_card_drawn,true);
@@ -88,7 +112,7 @@ void StochasticActions::EpidemicDrawAction::execute(Board::Board& game_board){
             if(p.get_position()==infect_card_drawn){
                 quarantine_adjacent=true;
             }
-            for(int n: Map::CITY_NEIGHBORS(p.get_position())){
+            for(int n: Map::CITIES[p.get_position()].neighbors){
                 if(infect_card_drawn==n){
                     quarantine_adjacent=true;
                 }
@@ -98,13 +122,7 @@ void StochasticActions::EpidemicDrawAction::execute(Board::Board& game_board){
     }
     // If there's either no player or there is but they're not adjacent, infect
     if(!quarantine_adjacent){
-        std::array<int,2> outbreak_status = game_board.infect(infect_card_drawn,Decks::CARD_COLOR(infect_card_drawn),3);
-
-        // Unlike with execute() want to make sure it's impossible to end up double-concatenating outbreak strings
-        // Not sure if that could even happen but just in case.
-        strrep +=" (caused " + std::to_string(outbreak_status[0]) + " total outbreak(s) - "+std::to_string(outbreak_status[1])+" blocked)";
-    } else {
-        strrep +=" (blocked by quarantine specialist!)";
+        outbreak_status = game_board.infect(infect_card_drawn,Decks::CARD_COLOR(infect_card_drawn),3);
     }
 
     game_board.readd_infect_discard();
@@ -117,11 +135,27 @@ void StochasticActions::EpidemicDrawAction::execute(Board::Board& game_board){
         // otherwise just increment and continue
         game_board.get_player_cards_drawn()++;
     }
+    game_board.update_phase();
+    return outbreak_status;
 }
 
 std::string StochasticActions::EpidemicDrawAction::repr(){
     return movetype + " (drew " + Decks::CARD_NAME(infect_card_drawn) + " from bottom of infect deck)" + strrep;
 }
+
+bool StochasticActions::EpidemicDrawAction::possible(Board::Board& game_board){
+    if(game_board.get_turn_action()!=4 || game_board.get_player_cards_drawn()>1 || !game_board.player_deck_nonempty()){
+        return false;
+    }
+    // (it has to be the next epidemic card, and the city has to still be at the bottom of the infect deck)
+    Decks::CardDistribution cards;
+    game_board.playerdeck_distribution(cards);
+    if(cards.probability(epidemic_card)<=0){
+        return false;
+    }
+    game_board.infectdeck_distribution(cards,true);
+    return cards.probability(infect_card_drawn)>0;
+}
 // =========================
 
 // ===== PLAYERDECK EMPTY ACTION ===== (GAME LOGIC ONLY)
@@ -131,13 +165,22 @@ StochasticActions::PlayerDeckEmptyAction::PlayerDeckEmptyAction()
     }
 
 void StochasticActions::PlayerDeckEmptyAction::execute(Board::Board& game_board){
+    resolve(game_board);
+}
+
+void StochasticActions::PlayerDeckEmptyAction::resolve(Board::Board& game_board){
     game_board.has_lost()=true;
     game_board.get_lost_reason()="Ran out of player cards!";
+    game_board.update_phase();
 }
 
 std::string StochasticActions::PlayerDeckEmptyAction::repr(){
     return movetype;
 }
+
+bool StochasticActions::PlayerDeckEmptyAction::possible(Board::Board& game_board){
+    return game_board.get_turn_action()==4 && !game_board.player_deck_nonempty();
+}
 // =========================
 
 // ===== Player Card draw constructor =====
@@ -176,9 +219,92 @@ Actions::Action* StochasticActions::PlayerDeckDrawActionConstructor::random_acti
     }
 }
 
+void StochasticActions::PlayerDeckDrawActionConstructor::resolve_random(Board::Board& game_board){
+    // (the same draws, in the same order, as random_action())
+    if(game_board.player_deck_nonempty()){
+        int card = game_board.draw_playerdeck_inplace();
+        if(Decks::IS_EPIDEMIC(card)){
+            int infected_city = game_board.draw_infectdeck_bottom_inplace();
+            bool quarantine_adjacent;
+            EpidemicDrawAction::resolve(game_board,card,infected_city,quarantine_adjacent);
+        } else {
+            PlayerCardDrawAction::resolve(game_board,card);
+        }
+    }  else {
+        PlayerDeckEmptyAction::resolve(game_board);
+    }
+}
+
 std::vector<Actions::Action*> StochasticActions::PlayerDeckDrawActionConstructor::all_actions(Board::Board& game_board){
-    // Unimplemented. Hypothetically just requires more board entrypoints to the deck
-    return {}; 
+    std::vector<ChanceOutcome> outcomes = {};
+    all_outcomes(game_board,outcomes);
+
+    std::vector<Actions::Action*> actions = {};
+    for(ChanceOutcome& outcome: outcomes){
+        actions.push_back(outcome.action);
+    }
+    return actions;
+}
+
+void StochasticActions::PlayerDeckDrawActionConstructor::all_outcomes(Board::Board& game_board,std::vector<ChanceOutcome>& outcomes){
+    if(!game_board.player_deck_nonempty()){
+        outcomes.push_back({new PlayerDeckEmptyAction(),1.});
+        return;
+    }
+    Decks::CardDistribution player_cards;
+    game_board.playerdeck_distribution(player_cards);
+    for(Decks::CardOutcome& player_card: player_cards){
+        if(Decks::IS_EPIDEMIC(player_card.card)){
+            // The epidemic then pulls (uniformly) one of the cards at the bottom of the infect deck
+            Decks::CardDistribution bottom_cards;
+            game_board.infectdeck_distribution(bottom_cards,true);
+            for(Decks::CardOutcome& bottom_card: bottom_cards){
+                outcomes.push_back({new EpidemicDrawAction(player_card.card,bottom_card.card),player_card.probability*bottom_card.probability});
+            }
+        } else {
+            outcomes.push_back({new PlayerCardDrawAction(player_card.card),player_card.probability});
+        }
+    }
+}
+
+Actions::Action* StochasticActions::PlayerDeckDrawActionConstructor::action_at(Board::Board& game_board,double quantile){
+    if(!game_board.player_deck_nonempty()){
+        return new PlayerDeckEmptyAction();
+    }
+    // Walk the outcomes in all_outcomes() order, remembering the last one (where rounding leaves a quantile a hair short of the total)
+    Decks::CardDistribution player_cards;
+    game_board.playerdeck_distribution(player_cards);
+    Decks::CardDistribution bottom_cards;
+    int last_card = -1;
+    int last_bottom_card = -1;
+    double cumulative = 0;
+    for(Decks::CardOutcome& player_card: player_cards){
+        if(Decks::IS_EPIDEMIC(player_card.card)){
+            game_board.infectdeck_distribution(bottom_cards,true);
+            for(Decks::CardOutcome& bottom_card: bottom_cards){
+                cumulative+=player_card.probability*bottom_card.probability;
+                if(quantile<cumulative){
+                    return new EpidemicDrawAction(player_card.card,bottom_card.card);
+                }
+                last_card = player_card.card;
+                last_bottom_card = bottom_card.card;
+            }
+        } else {
+            cumulative+=player_card.probability;
+            if(quantile<cumulative){
+                return new PlayerCardDrawAction(player_card.card);
+            }
+            last_card = player_card.card;
+            last_bottom_card = -1;
+        }
+    }
+    if(last_card<0){
+        return nullptr;
+    }
+    if(last_bottom_card>=0){
+        return new EpidemicDrawAction(last_card,last_bottom_card);
+    }
+    return new PlayerCardDrawAction(last_card);
 }
 
 bool StochasticActions::PlayerDeckDrawActionConstructor::legal(Board::Board& game_board){
@@ -206,6 +332,13 @@ StochasticActions::InfectDeckDrawAction::InfectDeckDrawAction(int card):
     }
 
 void StochasticActions::InfectDeckDrawAction::execute(Board::Board& game_board){
+    resolve(game_board,card_drawn,QuarantineSpecialistBlocked,outbreak_track);
+}
+
+void StochasticActions::InfectDeckDrawAction::resolve(Board::Board& game_board,int card_drawn,bool& QuarantineSpecialistBlocked,std::array<int,2>& outbreak_track){
+    // (this draw may be replayed on more than one board, so don't keep the last one's quarantine status)
+    QuarantineSpecialistBlocked=false;
+
     // If it's not quiet night
     if(!game_board.quiet_night_status()){
 
@@ -222,7 +355,7 @@ void StochasticActions::InfectDeckDrawAction::execute(Board::Board& game_board){
                         QuarantineSpecialistBlocked=true;
                         break;
                     }
-                    for(int n: Map::CITY_NEIGHBORS(p.get_position())){
+                    for(int n: Map::CITIES[p.get_position()].neighbors){
                         if(card_drawn==n){
                             QuarantineSpecialistBlocked=true;
                         }
@@ -282,6 +415,7 @@ void StochasticActions::InfectDeckDrawAction::execute(Board::Board& game_board){
         // reset quiet_night status
         game_board.quiet_night_status()=false;
     }
+    game_board.update_phase();
 }
 
 std::string StochasticActions::InfectDeckDrawAction::repr(){
@@ -292,6 +426,19 @@ std::string StochasticActions::InfectDeckDrawAction::repr(){
         return movetype + " blocked by quarantine specialist";
     }
 }
+
+bool StochasticActions::InfectDeckDrawAction::possible(Board::Board& game_board){
+    if(game_board.get_turn_action()!=5 || game_board.get_infect_cards_drawn()>=game_board.get_infection_rate()){
+        return false;
+    }
+    if(game_board.quiet_night_status()){
+        // No card is drawn at all
+        return true;
+    }
+    Decks::CardDistribution infect_cards;
+    game_board.infectdeck_distribution(infect_cards);
+    return infect_cards.probability(card_drawn)>0;
+}
 // =========================
 
 // ===== INFECT draw action constructor =====
@@ -312,9 +459,57 @@ Actions::Action* StochasticActions::InfectDeckDrawActionConstructor::random_acti
     return new InfectDeckDrawAction(card);
 }
 
+void StochasticActions::InfectDeckDrawActionConstructor::resolve_random(Board::Board& game_board){
+    int card = game_board.draw_infectdeck_inplace();
+    bool quarantine_blocked;
+    std::array<int,2> outbreak_track = {0,0};
+    InfectDeckDrawAction::resolve(game_board,card,quarantine_blocked,outbreak_track);
+}
+
 std::vector<Actions::Action*> StochasticActions::InfectDeckDrawActionConstructor::all_actions(Board::Board& game_board){
-    // Unimplemented. Hypothetically just requires more board entrypoints to the deck
-    return {}; 
+    std::vector<ChanceOutcome> outcomes = {};
+    all_outcomes(game_board,outcomes);
+
+    std::vector<Actions::Action*> actions = {};
+    for(ChanceOutcome& outcome: outcomes){
+        actions.push_back(outcome.action);
+    }
+    return actions;
+}
+
+void StochasticActions::InfectDeckDrawActionConstructor::all_outcomes(Board::Board& game_board,std::vector<ChanceOutcome>& outcomes){
+    Decks::CardDistribution infect_cards;
+    game_board.infectdeck_distribution(infect_cards);
+    if(game_board.quiet_night_status()){
+        // execute() skips the whole infect step without looking at the card, so every card is the same outcome
+        if(infect_cards.size>0){
+            outcomes.push_back({new InfectDeckDrawAction(infect_cards.outcomes[0].card),1.});
+        }
+        return;
+    }
+    for(Decks::CardOutcome& infect_card: infect_cards){
+        outcomes.push_back({new InfectDeckDrawAction(infect_card.card),infect_card.probability});
+    }
+}
+
+Actions::Action* StochasticActions::InfectDeckDrawActionConstructor::action_at(Board::Board& game_board,double quantile){
+    Decks::CardDistribution infect_cards;
+    game_board.infectdeck_distribution(infect_cards);
+    if(infect_cards.size==0){
+        return nullptr;
+    }
+    if(game_board.quiet_night_status()){
+        // (one outcome, as in all_outcomes())
+        return new InfectDeckDrawAction(infect_cards.outcomes[0].card);
+    }
+    double cumulative = 0;
+    for(Decks::CardOutcome& infect_card: infect_cards){
+        cumulative+=infect_card.probability;
+        if(quantile<cumulative){
+            return new InfectDeckDrawAction(infect_card.card);
+        }
+    }
+    return new InfectDeckDrawAction(infect_cards.outcomes[infect_cards.size-1].card);
 }
 
 bool StochasticActions::InfectDeckDrawActionConstructor::legal(Board::Board& game_board){
@@ -355,4 +550,38 @@ Actions::Action* StochasticActions::StochasticActionConstructor::get_action(Boar
     }
 }
 
-// =========================
\ No newline at end of file
+void StochasticActions::StochasticActionConstructor::resolve_random(Board::Board& game_board){
+    if(player_draw_con.legal(game_board)){
+        player_draw_con.resolve_random(game_board);
+    } else if(infect_draw_con.legal(game_board)){
+        infect_draw_con.resolve_random(game_board);
+    } else {
+        game_board.broken()=true;
+        game_board.broken_reasons().push_back("[StochasticActions::StochasticActionConstructor::resolve_random()] Stochastic constructor was asked to resolve a draw when InfectDraw and PlayerDeckDraw were both illegal!");
+    }
+}
+
+void StochasticActions::StochasticActionConstructor::all_outcomes(Board::Board& game_board,std::vector<ChanceOutcome>& outcomes){
+    if(player_draw_con.legal(game_board)){
+        player_draw_con.all_outcomes(game_board,outcomes);
+    } else if(infect_draw_con.legal(game_board)){
+        infect_draw_con.all_outcomes(game_board,outcomes);
+    } else {
+        game_board.broken()=true;
+        game_board.broken_reasons().push_back("[StochasticActions::StochasticActionConstructor::all_outcomes()] Stochastic constructor was asked for outcomes when InfectDraw and PlayerDeckDraw were both illegal!");
+    }
+}
+
+Actions::Action* StochasticActions::StochasticActionConstructor::action_at(Board::Board& game_board,double quantile){
+    if(player_draw_con.legal(game_board)){
+        return player_draw_con.action_at(game_board,quantile);
+    } else if(infect_draw_con.legal(game_board)){
+        return infect_draw_con.action_at(game_board,quantile);
+    } else {
+        game_board.broken()=true;
+        game_board.broken_reasons().push_back("[StochasticActions::StochasticActionConstructor::action_at()] Stochastic constructor was asked for an outcome when InfectDraw and PlayerDeckDraw were both illegal!");
+        return nullptr;
+    }
+}
+
+// =========================
@@ -11,8 +11,15 @@
 // Some of these represent the stochasticity inherent to the non-player moves, but at other times are deterministic but just not controlled by the player
 namespace StochasticActions
 {
+    // A card draw, which was made for one board but might be replayed on another (e.g. a determinization shared between branches of a search tree)
+    class DrawAction: public Actions::Action{
+    public:
+        // Whether this exact draw could come next on `game_board`: it's the right phase for it, and its card(s) are still there to be drawn
+        virtual bool possible(Board::Board& game_board)=0;
+    };
+
     // Executes the effect of drawing a player card
-    class PlayerCardDrawAction: public Actions::Action{
+    class PlayerCardDrawAction: public DrawAction{
         // Which card is drawn
         int card_drawn=-1;
         // extra info added to repr() output
@@ -21,13 +28,16 @@ namespace StochasticActions
         PlayerCardDrawAction(int card);
         
         void execute(Board::Board& game_board);
+        // What execute() does, without the action object (see GameLogic::Game::nonplayer_actions())
+        static void resolve(Board::Board& game_board,int card_drawn);
 
         std::string repr();
+        bool possible(Board::Board& game_board);
         bool legal(Board::Board& board);
     };
 
     // Executes the effect of drawing an epidemic card
-    class EpidemicDrawAction: public Actions::Action{
+    class EpidemicDrawAction: public DrawAction{
         // which city is drawn from bottom of infect deck
         int infect_card_drawn=-1;
         // The epidemic card drawn (for updating the player deck)
@@ -38,22 +48,27 @@ namespace StochasticActions
         EpidemicDrawAction(int _epidemic_card,int _infect_card_drawn);
 
         void execute(Board::Board& game_board);
+        // What execute() does, without the action object or the repr() string. Returns {# cities outbroken, # prevented}
+        static std::array<int,2> resolve(Board::Board& game_board,int epidemic_card,int infect_card_drawn,bool& quarantine_adjacent);
 
         std::string repr();
+        bool possible(Board::Board& game_board);
     };
 
     // Utility action used to force the game to lose when the player deck is empty and a card is to be drawn
-    class PlayerDeckEmptyAction: public Actions::Action{
+    class PlayerDeckEmptyAction: public DrawAction{
     public:
         PlayerDeckEmptyAction();
 
         void execute(Board::Board& game_board);
+        static void resolve(Board::Board& game_board);
 
         std::string repr();
+        bool possible(Board::Board& game_board);
     };
 
     // Executes effects of drawing an infect card. Will stop if game is lost after setting game status to lost
-    class InfectDeckDrawAction: public Actions::Action{
+    class InfectDeckDrawAction: public DrawAction{
         // infect card drawn
         int card_drawn=-1;
         // extra info that can be added to repr()
@@ -68,8 +83,17 @@ namespace StochasticActions
         InfectDeckDrawAction(int card);
 
         void execute(Board::Board& game_board);
+        // What execute() does, without the action object (`outbreak_track` is only written when the city gets infected)
+        static void resolve(Board::Board& game_board,int card_drawn,bool& QuarantineSpecialistBlocked,std::array<int,2>& outbreak_track);
 
         std::string repr();
+        bool possible(Board::Board& game_board);
+    };
+
+    // One way a stochastic step can resolve, and how likely it is. Whoever asks for these owns (and deletes) the actions.
+    struct ChanceOutcome{
+        Actions::Action* action;
+        double probability;
     };
 
     class PlayerDeckDrawActionConstructor: public Actions::ActionConstructor{
@@ -83,8 +107,14 @@ namespace StochasticActions
         // how many legal actions there are
         int n_actions(Board::Board& game_board); 
         Actions::Action* random_action(Board::Board& game_board); // return a random action of thie movetype with legal arguments
-        std::vector<Actions::Action*> all_actions(Board::Board& game_board); // NOT USED FOR STOCHASTIC ACTIONS
+        void resolve_random(Board::Board& game_board); // draw the same card random_action() would, and play it straight onto the board (no action object)
+        std::vector<Actions::Action*> all_actions(Board::Board& game_board); // every outcome of all_outcomes(), without the probabilities
         bool legal(Board::Board& game_board); // whether there is any legal use of this type of action
+
+        // Every way the next player card draw can go, with its exact probability (an epidemic is split over the bottom infect cards it might pull)
+        void all_outcomes(Board::Board& game_board,std::vector<ChanceOutcome>& outcomes);
+        // The outcome of all_outcomes() at `quantile` (in [0,1)) of their cumulative distribution, in the same order, made without making the others
+        Actions::Action* action_at(Board::Board& game_board,double quantile);
     };
 
     class InfectDeckDrawActionConstructor: public Actions::ActionConstructor{
@@ -98,8 +128,14 @@ namespace StochasticActions
         // how many legal actions there are
         int n_actions(Board::Board& game_board); 
         Actions::Action* random_action(Board::Board& game_board); // return a random action of thie movetype with legal arguments
-        std::vector<Actions::Action*> all_actions(Board::Board& game_board); // NOT USED FOR STOCHASTIC ACTIONS
+        void resolve_random(Board::Board& game_board); // draw the same card random_action() would, and play it straight onto the board (no action object)
+        std::vector<Actions::Action*> all_actions(Board::Board& game_board); // every outcome of all_outcomes(), without the probabilities
         bool legal(Board::Board& game_board); // whether there is any legal use of this type of action
+
+        // Every way the next infect card draw can go, with its exact probability (just one outcome during a quiet night)
+        void all_outcomes(Board::Board& game_board,std::vector<ChanceOutcome>& outcomes);
+        // The outcome of all_outcomes() at `quantile` (in [0,1)) of their cumulative distribution, in the same order, made without making the others
+        Actions::Action* action_at(Board::Board& game_board,double quantile);
     };
 
     class StochasticActionConstructor{
@@ -111,6 +147,13 @@ namespace StochasticActions
 
         // We do still want the constructor to give either an InfectDraw or PlayerDraw action to GameLogic
         Actions::Action* get_action(Board::Board& game_board);
+        // Or, when nothing needs to keep the outcome, draw and play it in one go: the same draw get_action() would make, with no allocation
+        void resolve_random(Board::Board& game_board);
+
+        // The full distribution that get_action() samples from (appended to `outcomes`)
+        void all_outcomes(Board::Board& game_board,std::vector<ChanceOutcome>& outcomes);
+        // The outcome at `quantile` of that distribution (see GameLogic::Game::stochastic_action_at())
+        Actions::Action* action_at(Board::Board& game_board,double quantile);
 
         // Whether or not it's time to apply stochasticity.
         bool legal(Board::Board& board);
@@ -0,0 +1,205 @@
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+#include "../game_files/StochasticActions.h"
+
+#include "../experimental_tools/Scenarios.h"
+
+#include "../agents/search_tools/Search.h"
+
+// build & run with: make test_determinization_sampling
+
+using namespace std;
+
+// Play random actions (and draws) until the active player has one action left, and the player deck could turn up an epidemic next
+bool advance_to_last_action(GameLogic::Game& game,Board::Board& board){
+    while(!game.is_terminal(board)){
+        if(!game.is_stochastic(board) && board.get_turn_action()==3 && board.player_deck_nonempty()){
+            return true;
+        }
+        Actions::Action* action = game.is_stochastic(board) ? game.get_stochastic_action(board) : game.get_random_action_bygroup(board);
+        action -> execute(board);
+        delete action;
+    }
+    return false;
+}
+
+// P(the next player card is an epidemic), from the exact outcome list
+double epidemic_probability(GameLogic::Game& game,Board::Board board){
+    // (go to the draw phase with any action)
+    Actions::Action* action = game.get_random_action_bygroup(board);
+    action -> execute(board);
+    delete action;
+
+    std::vector<StochasticActions::ChanceOutcome> outcomes = {};
+    game.stochastic_outcomes(board,outcomes);
+    double p = 0;
+    for(StochasticActions::ChanceOutcome& outcome: outcomes){
+        if(dynamic_cast<StochasticActions::EpidemicDrawAction*>(outcome.action)){
+            p+=outcome.probability;
+        }
+        delete outcome.action;
+    }
+    return p;
+}
+
+// repr() of the outcome at `quantile`, picked the long way: list every outcome and walk their cumulative probability
+std::string listed_outcome_at(GameLogic::Game& game,Board::Board& board,double quantile){
+    std::vector<StochasticActions::ChanceOutcome> outcomes = {};
+    game.stochastic_outcomes(board,outcomes);
+    std::string chosen = outcomes.empty() ? "" : outcomes.back().action -> repr();
+    double cumulative = 0;
+    bool found = false;
+    for(StochasticActions::ChanceOutcome& outcome: outcomes){
+        cumulative+=outcome.probability;
+        if(!found && quantile<cumulative){
+            chosen = outcome.action -> repr();
+            found = true;
+        }
+        delete outcome.action;
+    }
+    return chosen;
+}
+
+// Grow a K-determinized tree from `board` and count how many of its K determinizations draw an epidemic first.
+// (Every chance node below the root shares the determinizations' first draws, so any one that's fully branched will do.)
+int epidemics_in_first_draws(GameLogic::Game& game,Board::Board& board,int K,Search::DeterminizationSampling sampling){
+    game.reset_board(new Board::Board(board));
+    Search::KDeterminizedGameTree tree(game,K,{},sampling);
+    for(int sim=0;sim<30*K;sim++){
+        Board::Board copy = game.board_copy();
+        Search::Node* leaf = tree.getBestLeaf(copy,Search::UCB1Score);
+        leaf -> backprop(.5);
+    }
+    for(int child_num=0;child_num<tree.root -> n_children();child_num++){
+        Search::Node* chance_node = tree.root -> getChild(child_num);
+        if(!chance_node || !chance_node -> stochastic || chance_node -> n_children()!=K){
+            continue;
+        }
+        int epidemics = 0;
+        bool complete = true;
+        for(int det=0;det<K;det++){
+            Search::Node* drawn = chance_node -> getChild(det);
+            if(!drawn){
+                complete = false;
+                break;
+            }
+            epidemics+= dynamic_cast<StochasticActions::EpidemicDrawAction*>(drawn -> get_action()) ? 1 : 0;
+        }
+        if(complete){
+            return epidemics;
+        }
+    }
+    return -1;
+}
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    Scenarios::VanillaGameScenario scenario;
+    GameLogic::Game game;
+    bool all_passed = true;
+
+    // ===== Quantiles =====
+    cout << "Checking GameLogic::Game::stochastic_action_at() over a grid of quantiles matches the exact epidemic probability...\n";
+    game.reset_board(scenario.make_board({1,2,3},4));
+    Board::Board board = game.board_copy();
+    if(advance_to_last_action(game,board)){
+        double p = epidemic_probability(game,board);
+        Board::Board draw_board = board;
+        Actions::Action* action = game.get_random_action_bygroup(draw_board);
+        action -> execute(draw_board);
+        delete action;
+
+        const int GRID = 10000;
+        int epidemics = 0;
+        for(int i=0;i<GRID;i++){
+            Actions::Action* draw = game.stochastic_action_at(draw_board,((double) i+.5)/(double) GRID);
+            epidemics+= dynamic_cast<StochasticActions::EpidemicDrawAction*>(draw) ? 1 : 0;
+            delete draw;
+        }
+        double gap = std::abs((double) epidemics/(double) GRID - p);
+        cout << "\tP(epidemic) = " << p << ", fraction of the grid on an epidemic = " << (double) epidemics/(double) GRID << (gap<=2./GRID ? " (PASSED)" : " (FAILED)") << "\n\n";
+        all_passed = all_passed && gap<=2./GRID;
+
+        // It makes only the chosen outcome now, so check it still picks the one the full list would have (for player and infect draws)
+        cout << "Checking stochastic_action_at() picks the outcome stochastic_outcomes() has at each quantile...\n";
+        const int COARSE_GRID = 500;
+        int mismatches = 0;
+        int draws_checked = 0;
+        Board::Board walk_board = draw_board;
+        while(draws_checked<4 && !game.is_terminal(walk_board) && game.is_stochastic(walk_board)){
+            for(int i=0;i<=COARSE_GRID;i++){
+                // (including the very ends of [0,1), where rounding in the cumulative sum matters)
+                double quantile = i==COARSE_GRID ? std::nextafter(1.,0.) : ((double) i+.5)/(double) COARSE_GRID;
+                Actions::Action* draw = game.stochastic_action_at(walk_board,quantile);
+                mismatches+= !draw || draw -> repr()!=listed_outcome_at(game,walk_board,quantile);
+                delete draw;
+            }
+            Actions::Action* draw = game.stochastic_action_at(walk_board,(double) rand()/((double) RAND_MAX+1.));
+            draw -> execute(walk_board);
+            delete draw;
+            draws_checked++;
+        }
+        cout << "\t" << draws_checked << " draws, " << mismatches << " quantiles with a different outcome" << (mismatches==0 && draws_checked>0 ? " (PASSED)" : " (FAILED)") << "\n\n";
+        all_passed = all_passed && mismatches==0 && draws_checked>0;
+    }
+
+    // ===== Determinizations in a tree =====
+    const int TREES = 150;
+    const int K = 5;
+    cout << "Growing " << TREES << " " << K << "-determinized trees per sampling mode at a player's last action, counting the epidemics among the first draws...\n";
+    std::vector<std::string> mode_names = {"independent","stratified","antithetic"};
+    std::vector<Search::DeterminizationSampling> modes = {Search::INDEPENDENT,Search::STRATIFIED,Search::ANTITHETIC};
+    std::vector<double> sum(3,0.),sum_sq(3,0.),sum_expected(3,0.);
+    std::vector<int> trees_counted(3,0);
+    bool stratified_in_bounds = true;
+    bool antithetic_pairs_ok = true;
+    for(int tree_num=0;tree_num<TREES;tree_num++){
+        game.reset_board(scenario.make_board({1,2,3},4));
+        board = game.board_copy();
+        if(!advance_to_last_action(game,board)){
+            continue;
+        }
+        double p = epidemic_probability(game,board);
+        for(int mode=0;mode<3;mode++){
+            int epidemics = epidemics_in_first_draws(game,board,K,modes[mode]);
+            if(epidemics<0){
+                continue;
+            }
+            trees_counted[mode]++;
+            double excess = (double) epidemics - K*p;
+            sum[mode]+=excess;
+            sum_sq[mode]+=excess*excess;
+            if(modes[mode]==Search::STRATIFIED && (epidemics<std::floor(K*p-1e-9) || epidemics>std::ceil(K*p+1e-9))){
+                cout << "\tStratified: " << epidemics << " epidemics out of " << K << " with P(epidemic) = " << p << endl;
+                stratified_in_bounds = false;
+            }
+            // (epidemics sit together at one end of the outcome order, so at most one of u and 1-u lands on them while they're under half)
+            if(modes[mode]==Search::ANTITHETIC && p<.5 && epidemics>(K+1)/2){
+                cout << "\tAntithetic: " << epidemics << " epidemics out of " << K << " with P(epidemic) = " << p << endl;
+                antithetic_pairs_ok = false;
+            }
+        }
+    }
+    for(int mode=0;mode<3;mode++){
+        double mean = sum[mode]/std::max(1,trees_counted[mode]);
+        double mse = sum_sq[mode]/std::max(1,trees_counted[mode]);
+        cout << "\t" << mode_names[mode] << ": " << trees_counted[mode] << " trees, mean (epidemics - K*p) = " << mean << ", mean squared = " << mse << endl;
+    }
+    double independent_mse = sum_sq[0]/std::max(1,trees_counted[0]);
+    double stratified_mse = sum_sq[1]/std::max(1,trees_counted[1]);
+    bool lower_error = stratified_mse<independent_mse;
+    cout << "Stratified counts within floor/ceil of K*p: " << (stratified_in_bounds ? "PASSED" : "FAILED")
+        << "\nAntithetic pairs never both epidemics: " << (antithetic_pairs_ok ? "PASSED" : "FAILED")
+        << "\nStratified squared error below independent: " << (lower_error ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && stratified_in_bounds && antithetic_pairs_ok && lower_error && trees_counted[1]>0;
+
+    cout << (all_passed ? "All determinization sampling checks PASSED" : "Some determinization sampling checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <map>
+
+#include "../game_files/Map.h"
+#include "../game_files/Decks.h"
+
+using namespace std;
+
+// Draw `samples` cards in place and return the largest gap between how often a card came up and the probability next_draw_distribution() gave it
+template<class Deck>
+double max_frequency_gap(Deck& deck,Decks::CardDistribution& distribution,int samples){
+    std::map<int,int> counts = {};
+    for(int s=0;s<samples;s++){
+        counts[deck.draw_inplace()]++;
+    }
+    double gap = 0;
+    for(Decks::CardOutcome& outcome: distribution){
+        gap = std::max(gap,std::abs((double) counts[outcome.card]/(double) samples - outcome.probability));
+    }
+    // Anything drawn that the distribution says is impossible is a gap of its whole frequency
+    for(auto& count: counts){
+        if(distribution.probability(count.first)==0){
+            gap = std::max(gap,(double) count.second/(double) samples);
+        }
+    }
+    return gap;
+}
+
+int main(){
+    std::srand(time(NULL));
+    int junk = rand();
+
+    const int SAMPLES = 200000;
+    const double TOLERANCE = .01; // generous for 200k samples of probabilities no larger than ~1/8
+    bool all_passed = true;
+
+    // ===== Player deck =====
+    cout << "Setting up a difficulty-4 player deck with 3 hands of 3 cards...\n";
+    Decks::PlayerDeck player_deck(4);
+    for(int card=0;card<9;card++){
+        player_deck.draw(true);
+    }
+    player_deck.setup_shuffle_deck();
+    cout << "... " << player_deck.remaining_cards() << " cards left (Should be 46)\n\n";
+
+    Decks::CardDistribution distribution;
+
+    cout << "Drawing through the whole deck, checking each next-draw distribution sums to 1 and covers the card that's drawn...\n";
+    int draws = 0;
+    bool sums_ok = true;
+    bool covers_ok = true;
+    while(!player_deck.isempty()){
+        player_deck.next_draw_distribution(distribution);
+        if(std::abs(distribution.total()-1)>1e-9){
+            cout << "\tDraw " << draws+1 << ": probabilities sum to " << distribution.total() << endl;
+            sums_ok = false;
+        }
+        // A few spot checks against sampling: at the start of a chunk, and just before its last card
+        if(draws==0 || draws==10 || draws==25){
+            double gap = max_frequency_gap(player_deck,distribution,SAMPLES);
+            cout << "\tDraw " << draws+1 << ": P(epidemic) = " << distribution.probability(51+player_deck._epidemics_drawn())
+                << ", largest gap to sampled frequencies = " << gap << (gap<TOLERANCE ? " (ok)" : " (TOO LARGE)") << endl;
+            all_passed = all_passed && gap<TOLERANCE;
+        }
+        int card = player_deck.draw();
+        if(distribution.probability(card)<=0){
+            cout << "\tDraw " << draws+1 << ": drew " << Decks::CARD_NAME(card) << " which had probability 0!" << endl;
+            covers_ok = false;
+        }
+        draws++;
+    }
+    player_deck.next_draw_distribution(distribution);
+    cout << "... " << draws << " draws. Sums: " << (sums_ok ? "PASSED" : "FAILED") << ", covers drawn cards: " << (covers_ok ? "PASSED" : "FAILED")
+        << ", empty deck has " << distribution.size << " outcomes (Should be 0)\n\n";
+    all_passed = all_passed && sums_ok && covers_ok && distribution.size==0;
+
+    // ===== Infect deck =====
+    cout << "Drawing 9 infect cards, then 1 from the bottom (an epidemic), then putting the discard back on top...\n";
+    Decks::InfectDeck infect_deck;
+    for(int card=0;card<9;card++){
+        infect_deck.draw();
+    }
+    infect_deck.next_draw_distribution(distribution,true);
+    cout << "Bottom card distribution has " << distribution.size << " outcomes (Should be 39)\n";
+    all_passed = all_passed && distribution.size==39;
+    infect_deck.draw_bottom();
+    infect_deck.readd_discard();
+
+    infect_deck.next_draw_distribution(distribution);
+    double gap = max_frequency_gap(infect_deck,distribution,SAMPLES);
+    cout << "Top card distribution has " << distribution.size << " outcomes (Should be 10), each with probability " << distribution.outcomes[0].probability
+        << ", largest gap to sampled frequencies = " << gap << (gap<TOLERANCE ? " (ok)" : " (TOO LARGE)") << "\n\n";
+    all_passed = all_passed && distribution.size==10 && gap<TOLERANCE && std::abs(distribution.total()-1)<1e-9;
+
+    cout << (all_passed ? "All distribution checks PASSED" : "Some distribution checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+
+#include "../experimental_tools/Scenarios.h"
+
+#include "../agents/Heuristics.h"
+#include "../agents/search_tools/ExpectedHeuristic.h"
+
+// build & run with: make test_expected_heuristic
+
+using namespace std;
+
+// Play random actions (and draws) until the infect draws are about to start, with nothing decided yet
+bool advance_to_infect_draws(GameLogic::Game& game,Board::Board& board){
+    while(!game.is_terminal(board)){
+        if(game.is_stochastic(board)){
+            if(board.get_turn_action()==5 && board.get_infect_cards_drawn()==0 && !board.quiet_night_status()){
+                return true;
+            }
+            Actions::Action* draw = game.get_stochastic_action(board);
+            draw -> execute(board);
+            delete draw;
+        } else {
+            Actions::Action* action = game.get_random_action_bygroup(board);
+            action -> execute(board);
+            delete action;
+        }
+    }
+    return false;
+}
+
+// mean, variance and spread (max - min) of `n` estimates with a given outcome budget
+void estimate(GameLogic::Game& game,Board::Board& board,int budget,int n,double& mean,double& variance,double& spread){
+    std::vector<double> values = {};
+    mean=0;
+    for(int i=0;i<n;i++){
+        Board::Board copy = board;
+        values.push_back(Search::expected_heuristic(copy,game,Heuristics::SmartLossProximity,budget));
+        mean+=values.back()/(double) n;
+    }
+    variance=0;
+    double lowest=values[0];
+    double highest=values[0];
+    for(double& value: values){
+        variance+=(value-mean)*(value-mean)/(double) n;
+        lowest = std::min(lowest,value);
+        highest = std::max(highest,value);
+    }
+    spread = highest-lowest;
+}
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    Scenarios::VanillaGameScenario scenario;
+    GameLogic::Game game;
+    game.reset_board(scenario.make_board({1,2,3},4));
+    bool all_passed = true;
+
+    int boards_checked=0;
+    for(int attempt=0;attempt<20 && boards_checked<3;attempt++){
+        Board::Board board = game.board_copy();
+        // Get some way into the game so the infect deck has some shape to it
+        for(int turn=0;turn<3*boards_checked;turn++){
+            if(!advance_to_infect_draws(game,board)){
+                break;
+            }
+            Actions::Action* draw = game.get_stochastic_action(board);
+            draw -> execute(board);
+            delete draw;
+        }
+        if(!advance_to_infect_draws(game,board)){
+            continue;
+        }
+        boards_checked++;
+
+        Decks::CardDistribution top_group;
+        board.infectdeck_distribution(top_group);
+        int infection_rate = board.get_infection_rate();
+        int all_outcomes = 1;
+        for(int draw=0;draw<infection_rate;draw++){
+            all_outcomes*= std::max(top_group.size-draw,1);
+        }
+        cout << "Board " << boards_checked << ": " << top_group.size << " cards in the top infect group, infection rate " << infection_rate << " (" << all_outcomes << " outcomes)" << endl;
+
+        // Exact (enough budget for every outcome): the same value every time
+        double exact_mean,exact_variance,exact_spread;
+        estimate(game,board,all_outcomes,3,exact_mean,exact_variance,exact_spread);
+        bool exact_ok = exact_spread < 1e-12;
+        cout << "\tExact expectation: " << exact_mean << (exact_ok ? " (repeatable)" : " (NOT repeatable!)") << endl;
+
+        // One sample: unbiased, but noisy
+        double sampled_mean,sampled_variance,sampled_spread;
+        int n = 4000;
+        estimate(game,board,1,n,sampled_mean,sampled_variance,sampled_spread);
+        double standard_error = std::sqrt(sampled_variance/(double) n);
+        // (with a small floor, for boards where only a rare outcome or two changes the heuristic and the samples may never see them)
+        bool unbiased_ok = std::abs(sampled_mean - exact_mean) <= 4*standard_error + .002;
+        cout << "\tMean of " << n << " single samples: " << sampled_mean << " +/- " << standard_error << (unbiased_ok ? " (ok)" : " (TOO FAR from exact)") << endl;
+
+        // A budget of 8: still unbiased, and less variance per estimate
+        double budget_mean,budget_variance,budget_spread;
+        estimate(game,board,8,1000,budget_mean,budget_variance,budget_spread);
+        bool variance_ok = budget_variance <= sampled_variance + 1e-12;
+        cout << "\tVariance per estimate: " << sampled_variance << " (1 sample) vs " << budget_variance << " (budget of 8)" << (variance_ok ? " (ok)" : " (NOT LOWER)") << endl;
+
+        all_passed = all_passed && exact_ok && unbiased_ok && variance_ok;
+    }
+
+    cout << endl << (all_passed ? "All expected heuristic checks PASSED" : "Some expected heuristic checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}
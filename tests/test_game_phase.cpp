@@ -0,0 +1,116 @@
+#include <array>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+
+#include "../experimental_tools/Scenarios.h"
+
+#include "../agents/Heuristics.h"
+
+// build & run with: make test_game_phase
+// (built with -DPHASE_CHECK, so every is_terminal()/is_stochastic() in here and in the rollouts also checks the phase against derive_phase())
+
+using namespace std;
+
+const std::array<std::string,7> PHASE_NAMES = {"PLAYER_ACTION","FORCED_DISCARD","PLAYER_DRAW","INFECT","TERMINAL_WON","TERMINAL_LOST","TERMINAL_BROKEN"};
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    std::vector<std::pair<std::string,Scenarios::Scenario*>> scenarios = {
+        {"VanillaGame",new Scenarios::VanillaGameScenario()},
+        {"ForcedDiscard",new Scenarios::ForcedDiscardScenario()},
+        {"BusyBoard",new Scenarios::BusyBoardScenario()},
+        {"CanWin",new Scenarios::CanWinScenario()}
+    };
+    GameLogic::Game game;
+    bool all_passed = true;
+
+    // ===== Random games =====
+    const int GAMES = 50;
+    cout << "Comparing the board's phase with derive_phase() after every action of " << GAMES << " random games per scenario...\n";
+    long states = 0;
+    long mismatches = 0;
+    long bad_copies = 0;
+    std::array<long,7> seen = {0,0,0,0,0,0,0};
+    for(auto& scenario: scenarios){
+        for(int game_num=0;game_num<GAMES;game_num++){
+            game.reset_board(scenario.second -> make_board({1,2,3},4));
+            Board::Board board = game.board_copy();
+            while(true){
+                // (derive_phase() updates the board's status as it goes, so it gets a copy)
+                Board::Board derived_board = board;
+                Board::GamePhase derived = game.derive_phase(derived_board);
+                states++;
+                seen[board.phase()]++;
+                if(board.phase()!=derived){
+                    mismatches++;
+                    cout << "\t" << scenario.first << ": phase " << PHASE_NAMES[board.phase()] << " but derived " << PHASE_NAMES[derived] << "\n";
+                }
+                Board::Board copy = board;
+                bad_copies+= copy.phase()!=board.phase();
+
+                if(game.is_terminal(board)){
+                    break;
+                }
+                Actions::Action* action = game.is_stochastic(board) ? game.get_stochastic_action(board) : game.get_random_action_bygroup(board);
+                action -> execute(board);
+                delete action;
+            }
+        }
+    }
+    cout << "\t" << states << " states: " << mismatches << " where the phase disagreed with derive_phase(), " << bad_copies << " copies with a different phase\n\t";
+    for(int phase=0;phase<PHASE_NAMES.size();phase++){
+        cout << PHASE_NAMES[phase] << ": " << seen[phase] << (phase+1<PHASE_NAMES.size() ? ", " : "\n");
+    }
+    // Random play wins too rarely to count on seeing TERMINAL_WON
+    bool every_phase = seen[Board::PLAYER_ACTION]>0 && seen[Board::FORCED_DISCARD]>0 && seen[Board::PLAYER_DRAW]>0 && seen[Board::INFECT]>0 && seen[Board::TERMINAL_LOST]>0;
+    bool games_ok = mismatches==0 && bad_copies==0 && every_phase && seen[Board::TERMINAL_BROKEN]==0;
+    cout << "Kept phase matches the derived phase: " << (games_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && games_ok;
+
+    // ===== Rollouts =====
+    const int ROLLOUTS = 200;
+    cout << "Running " << ROLLOUTS << " rollouts per scenario (any phase mismatch breaks the board)...\n";
+    long broken_rollouts = 0;
+    for(auto& scenario: scenarios){
+        game.reset_board(scenario.second -> make_board({1,2,3},4));
+        for(int rollout=0;rollout<ROLLOUTS;rollout++){
+            Board::Board board = game.board_copy();
+            game.rollout(board,Heuristics::CureGoalConditions);
+            broken_rollouts+= board.broken();
+        }
+    }
+    cout << "\t" << broken_rollouts << " broken rollouts\n";
+    bool rollouts_ok = broken_rollouts==0;
+    cout << "Rollouts never disagree with the derived phase: " << (rollouts_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && rollouts_ok;
+
+    // ===== A change the phase doesn't know about =====
+    cout << "Filling a hand behind the board's back...\n";
+    game.reset_board(scenarios[0].second -> make_board({1,2,3},4));
+    Board::Board board = game.board_copy();
+    Board::GamePhase before = board.phase();
+    for(int card=0;card<8;card++){
+        board.active_player().UpdateHand(card);
+    }
+    Board::Board stale = board;
+    bool caught = !game.check_phase(stale,"test") && stale.broken();
+    board.update_phase();
+    cout << "\tphase " << PHASE_NAMES[before] << " before, check_phase() " << (caught ? "caught" : "missed") << " the stale phase, " << PHASE_NAMES[board.phase()] << " after update_phase()\n";
+    bool stale_ok = before==Board::PLAYER_ACTION && caught && board.phase()==Board::FORCED_DISCARD && game.check_phase(board,"test");
+    cout << "check_phase() catches a stale phase: " << (stale_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && stale_ok;
+
+    for(auto& scenario: scenarios){
+        delete scenario.second;
+    }
+
+    cout << (all_passed ? "All game phase checks PASSED" : "Some game phase checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}
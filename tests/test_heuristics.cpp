@@ -0,0 +1,264 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+
+#include "../experimental_tools/Scenarios.h"
+
+#include "../agents/Heuristics.h"
+#include "../agents/HeuristicCombinators.h"
+#include "../agents/search_tools/HeuristicCache.h"
+
+// build & run with: make test_heuristics
+
+using namespace std;
+
+// Same double, bit for bit
+bool identical(double a,double b){
+    return std::memcmp(&a,&b,sizeof(double))==0;
+}
+
+// CureGoalConditionswStation() as it was before it read the board's kept features: scans the stations around whoever holds the most cards of each color
+double scanned_CureGoalConditionswStation(Board::Board& game_board){
+    double value = 0;
+    std::array<double,4> closeness = {0,0,0,0};
+    std::array<int,4> closest_position = {-1,-1,-1,-1};
+    for(Players::Player& p: game_board.get_players()){
+        std::array<int,4> color_count = {0,0,0,0};
+        for(int card: p.hand){
+            color_count[Decks::CARD_COLOR(card)]++;
+        }
+        for(int color=0;color<4;color++){
+            if(!game_board.is_cured(color)){
+                double p_closeness = std::min((double) color_count[color]/(double) p.role.required_cure_cards,1.);
+                if(p_closeness > closeness[color]){
+                    closeness[color] = p_closeness;
+                    closest_position[color] = p.get_position();
+                }
+            }
+        }
+    }
+    for(int color=0;color<4;color++){
+        if(closeness[color]==1){
+            bool reward_claimed=false;
+            for(int st: game_board.get_stations()){
+                if(closest_position[color]==st){
+                    value+=.05;
+                    reward_claimed=true;
+                    break;
+                }
+            }
+            for(int neighbor: Map::CITY_NEIGHBORS(closest_position[color])){
+                for(int st: game_board.get_stations()){
+                    if(st==neighbor && !reward_claimed){
+                        value+=.025;
+                        reward_claimed=true;
+                    }
+                }
+            }
+        }
+    }
+    for(int color=0;color<4;color++){
+        if(!game_board.is_cured(color)){
+            value+=.15*closeness[color];
+        } else {
+            value+=.25;
+        }
+    }
+    return value;
+}
+
+// SmartLossProximity() as it was before it read the board's kept features: every city of every color, with int counts
+double scanned_SmartLossProximity(Board::Board& game_board){
+    std::array<std::array<int,48>,4> disease_count = game_board.get_disease_count();
+    std::array<int,4> count = {0,0,0,0};
+    for(int city=0;city<48;city++){
+        for(int color=0;color<4;color++){
+            if(disease_count[color][city]==3){
+                if(!(game_board.in_infect_discard(city) && game_board.all_epidemics_drawn())){
+                    count[color]+=1;
+                    for(int neighbor: Map::CITY_NEIGHBORS(city)){
+                        if(disease_count[color][neighbor]==3){
+                            count[color]+=.5;
+                        }
+                    }
+                } else {
+                    count[color]+=.5;
+                }
+            } else {
+                count[color]+= .25 * disease_count[color][city];
+            }
+        }
+    }
+    double BLUE_3cube_badness = count[Map::BLUE]/6.;
+    double YELLOW_3cube_badness = count[Map::YELLOW]/6.;
+    double BLACK_3cube_badness = count[Map::BLACK]/6.;
+    double RED_3cube_badness = count[Map::RED]/6.;
+    return std::max(1. - (BLUE_3cube_badness + YELLOW_3cube_badness + BLACK_3cube_badness + RED_3cube_badness)/2.,0.);
+}
+
+// Recount everything the board and players keep up to date for the heuristics, and check it matches
+bool features_consistent(Board::Board& board){
+    std::array<std::array<int,48>,4>& disease_count = board.get_disease_count();
+    for(int color=0;color<4;color++){
+        int cubes = 0;
+        unsigned long long three_cube_cities = 0;
+        for(int city=0;city<48;city++){
+            cubes+=disease_count[color][city];
+            if(disease_count[color][city]==3){
+                three_cube_cities |= 1ULL << city;
+            }
+        }
+        if(cubes!=board.get_color_count()[color] || three_cube_cities!=board.get_3cube_cities(color)){
+            return false;
+        }
+    }
+    for(Players::Player& p: board.get_players()){
+        std::array<int,4> color_count = {0,0,0,0};
+        for(int card: p.hand){
+            color_count[Decks::CARD_COLOR(card)]++;
+        }
+        if(color_count!=p.get_color_count()){
+            return false;
+        }
+    }
+    for(int city=0;city<48;city++){
+        bool at_station = false;
+        bool next_to_station = false;
+        for(int st: board.get_stations()){
+            at_station = at_station || st==city;
+            for(int neighbor: Map::CITIES[st].neighbors){
+                next_to_station = next_to_station || neighbor==city;
+            }
+        }
+        if(at_station!=board.at_station(city) || next_to_station!=board.next_to_station(city)){
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    std::vector<std::pair<std::string,Scenarios::Scenario*>> scenarios = {
+        {"VanillaGame",new Scenarios::VanillaGameScenario()},
+        {"ForcedDiscard",new Scenarios::ForcedDiscardScenario()},
+        {"BusyBoard",new Scenarios::BusyBoardScenario()},
+        {"CanWin",new Scenarios::CanWinScenario()}
+    };
+    std::vector<double> alphas = {0.,.5,2./3.,1.};
+
+    // Check every board a by-group random player passes through, in a few games per scenario
+    const int GAMES = 40;
+    long boards = 0;
+    long mismatches = 0;
+    long stale_features = 0;
+    long cache_mismatches = 0;
+    long with_3cubes = 0;
+    long with_station_bonus = 0;
+    long with_all_epidemics = 0;
+    GameLogic::Game game;
+    for(auto& scenario: scenarios){
+        cout << "Playing " << GAMES << " random " << scenario.first << " games, comparing the heuristics (and SmartCompoundHeuristic()) to the city and station scans they replaced and recounting the board's kept features at every step...\n";
+        for(int game_num=0;game_num<GAMES;game_num++){
+            game.reset_board(scenario.second -> make_board({1,2,3},4));
+            Board::Board board = game.board_copy();
+
+            // A cache per heuristic, kept for the whole game: if Hashes::heuristicHash() missed anything a heuristic reads,
+            // some later board would come back with an earlier board's value
+            std::vector<Heuristics::Heuristic*> cached_heuristics = {Heuristics::PureGameReward,Heuristics::CureGoalConditions,Heuristics::CureGoalConditionswStation,Heuristics::LossProximity,Heuristics::SmartLossProximity};
+            std::vector<Search::HeuristicCache> caches(cached_heuristics.size());
+            for(Search::HeuristicCache& cache: caches){
+                cache.enabled = true;
+                cache.new_search();
+            }
+            while(!game.is_terminal(board)){
+                Heuristics::BoardFeatures features;
+                Heuristics::GetBoardFeatures(board,features);
+                for(int color=0;color<4;color++){
+                    with_3cubes+= features.live_3cube_cities[color]>0;
+                    with_station_bonus+= features.station_bonus[color]>0;
+                }
+                with_all_epidemics+= board.all_epidemics_drawn();
+
+                // The heuristics against the scans they replaced
+                double scanned_cure = scanned_CureGoalConditionswStation(board);
+                double scanned_loss = scanned_SmartLossProximity(board);
+                if(!identical(Heuristics::CureGoalConditionswStation(board),scanned_cure) || !identical(Heuristics::SmartLossProximity(board),scanned_loss)){
+                    if(mismatches<10){
+                        cout.precision(17);
+                        cout << "\tCureGoalConditionswStation = " << Heuristics::CureGoalConditionswStation(board) << " (scanned: " << scanned_cure
+                            << "), SmartLossProximity = " << Heuristics::SmartLossProximity(board) << " (scanned: " << scanned_loss << ")" << endl;
+                    }
+                    mismatches++;
+                }
+                for(double alpha: alphas){
+                    double reference = alpha * scanned_cure + (1.-alpha) * scanned_loss;
+                    double fused = Heuristics::SmartCompoundHeuristic(board,alpha);
+                    if(!identical(reference,fused) || !identical(Heuristics::CompoundHeuristic(board,Heuristics::CureGoalConditionswStation,Heuristics::SmartLossProximity,alpha),fused)){
+                        if(mismatches<10){
+                            cout.precision(17);
+                            cout << "\talpha = " << alpha << ": from scans = " << reference << ", SmartCompoundHeuristic = " << fused << endl;
+                        }
+                        mismatches++;
+                    }
+                }
+                // Combinator types against the function-pointer versions
+                for(double alpha: alphas){
+                    auto weighted = Heuristics::weighted_sum(Heuristics::Fn<Heuristics::CureGoalConditionswStation>(),Heuristics::Fn<Heuristics::LossProximity>(),alpha);
+                    Heuristics::SmartCompound smart{alpha};
+                    if(!identical(weighted(board),Heuristics::CompoundHeuristic(board,Heuristics::CureGoalConditionswStation,Heuristics::LossProximity,alpha))
+                        || !identical(smart(board),Heuristics::SmartCompoundHeuristic(board,alpha))){
+                        mismatches++;
+                    }
+                }
+                double clamped_max = Heuristics::clamp(Heuristics::max_of(Heuristics::Fn<Heuristics::CureGoalConditions>(),Heuristics::Fn<Heuristics::SmartLossProximity>()),.25,.75)(board);
+                if(!identical(clamped_max,std::min(std::max(std::max(Heuristics::CureGoalConditions(board),Heuristics::SmartLossProximity(board)),.25),.75))
+                    || !identical(Heuristics::terminal_override(Heuristics::Fn<Heuristics::LossProximity>())(board),Heuristics::LossProximity(board))){
+                    mismatches++;
+                }
+
+                if(!identical(Heuristics::CureGoalConditionswStation(board),Heuristics::FeatureCureGoalConditionswStation(features))
+                    || !identical(Heuristics::SmartLossProximity(board),Heuristics::FeatureSmartLossProximity(features))){
+                    mismatches++;
+                }
+                for(int h=0;h<cached_heuristics.size();h++){
+                    if(!identical(caches[h].evaluate(board,cached_heuristics[h]),cached_heuristics[h](board))){
+                        cache_mismatches++;
+                    }
+                }
+
+                if(!features_consistent(board)){
+                    if(stale_features<10){
+                        cout << "\tBoard features kept by the board don't match a recount" << endl;
+                    }
+                    stale_features++;
+                }
+                boards++;
+
+                Actions::Action* action = game.is_stochastic(board) ? game.get_stochastic_action(board) : game.get_random_action_bygroup(board);
+                action -> execute(board);
+                delete action;
+            }
+        }
+    }
+    cout << "... " << boards << " boards (" << with_3cubes << " disease/board pairs with live 3-cube cities, " << with_station_bonus << " with a station bonus, "
+        << with_all_epidemics << " boards with every epidemic drawn)\n\n";
+
+    for(auto& scenario: scenarios){
+        delete scenario.second;
+    }
+
+    cout << (stale_features==0 ? "Kept board features match a recount: PASSED" : "Kept board features are stale: FAILED (" + std::to_string(stale_features) + " boards)") << endl;
+    cout << (mismatches==0 ? "Heuristics, fused heuristic and combinators are bitwise identical to the scans: PASSED" : "Heuristics, fused heuristic or combinators differ: FAILED (" + std::to_string(mismatches) + " mismatches)") << endl;
+    cout << (cache_mismatches==0 ? "Cached heuristic values match: PASSED" : "Cached heuristic values differ: FAILED (" + std::to_string(cache_mismatches) + " lookups)") << endl;
+    bool passed = mismatches==0 && stale_features==0 && cache_mismatches==0 && boards>0;
+    return passed ? 0 : 1;
+}
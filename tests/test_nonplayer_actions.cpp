@@ -0,0 +1,130 @@
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+
+#include "../experimental_tools/Scenarios.h"
+
+#include "../agents/search_tools/SearchStats.h"
+
+// build & run with: make test_nonplayer_actions
+// (built with -DSEARCH_PROFILING, so Search::bytes_allocated() counts every heap allocation)
+
+using namespace std;
+
+// Everything a draw can change
+bool same_state(Board::Board& a,Board::Board& b){
+    bool same = a.get_disease_count()==b.get_disease_count() && a.get_outbreak_count()==b.get_outbreak_count()
+        && a.get_turn()==b.get_turn() && a.get_turn_action()==b.get_turn_action()
+        && a.get_player_cards_drawn()==b.get_player_cards_drawn() && a.get_infect_cards_drawn()==b.get_infect_cards_drawn()
+        && a.get_epidemic_count()==b.get_epidemic_count() && a.get_playerdeck_remaining_cards()==b.get_playerdeck_remaining_cards()
+        && a.get_infectdeck_stack()==b.get_infectdeck_stack() && a.get_eradicated()==b.get_eradicated()
+        && a.quiet_night_status()==b.quiet_night_status() && a.has_won()==b.has_won() && a.has_lost()==b.has_lost()
+        && a.broken()==b.broken() && a.phase()==b.phase();
+    for(int p=0;p<a.get_players().size();p++){
+        same = same && a.get_players()[p].hand==b.get_players()[p].hand && a.get_players()[p].event_cards==b.get_players()[p].event_cards;
+    }
+    return same;
+}
+
+// The way nonplayer_actions() used to resolve the draws: an action object per draw
+void nonplayer_actions_with_objects(GameLogic::Game& game,Board::Board& board){
+    while(game.is_stochastic(board)){
+        Actions::Action* draw = game.get_stochastic_action(board);
+        draw -> execute(board);
+        delete draw;
+    }
+}
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    std::vector<std::pair<std::string,Scenarios::Scenario*>> scenarios = {
+        {"VanillaGame",new Scenarios::VanillaGameScenario()},
+        {"ForcedDiscard",new Scenarios::ForcedDiscardScenario()},
+        {"BusyBoard",new Scenarios::BusyBoardScenario()},
+        {"CanWin",new Scenarios::CanWinScenario()}
+    };
+    GameLogic::Game game;
+
+    const int GAMES = 50;
+    cout << "Resolving every draw phase of " << GAMES << " random games per scenario both ways, from the same random seed...\n";
+    long phases = 0;
+    long different = 0;
+    long epidemics = 0;
+    long object_bytes = 0;
+    long direct_bytes = 0;
+    // Direct draws on a copied board (whose decks and hands come with room for the draws) shouldn't allocate at all,
+    // except for the pile an epidemic puts back on top of the infect deck
+    long quiet_phases = 0;
+    long quiet_bytes = 0;
+    long epidemic_bytes = 0;
+    long pile_bytes = 0;
+    for(auto& scenario: scenarios){
+        for(int game_num=0;game_num<GAMES;game_num++){
+            game.reset_board(scenario.second -> make_board({1,2,3},4));
+            Board::Board board = game.board_copy();
+            while(!game.is_terminal(board)){
+                if(game.is_stochastic(board)){
+                    unsigned int seed = (unsigned int) rand();
+                    Board::Board with_objects = board;
+                    Board::Board direct = board;
+                    // (the copies are made before counting, and come with room for the draws: see the deck and player copy constructors)
+                    int epidemics_before = board.get_epidemic_count();
+
+                    srand(seed);
+                    long bytes_before = Search::bytes_allocated();
+                    nonplayer_actions_with_objects(game,with_objects);
+                    object_bytes+= Search::bytes_allocated() - bytes_before;
+
+                    srand(seed);
+                    bytes_before = Search::bytes_allocated();
+                    game.nonplayer_actions(direct);
+                    long phase_bytes = Search::bytes_allocated() - bytes_before;
+                    direct_bytes+= phase_bytes;
+
+                    phases++;
+                    int phase_epidemics = direct.get_epidemic_count() - epidemics_before;
+                    epidemics+= phase_epidemics;
+                    if(phase_epidemics==0){
+                        quiet_phases++;
+                        quiet_bytes+= phase_bytes;
+                    } else {
+                        epidemic_bytes+= phase_bytes;
+                        // (a pile is at most every city card)
+                        pile_bytes+= phase_epidemics*48*(long) sizeof(int);
+                    }
+                    if(!same_state(with_objects,direct)){
+                        different++;
+                    }
+                    // (carry on from the same point the next rand() would have)
+                    board = direct;
+                    continue;
+                }
+                Actions::Action* action = game.get_random_action_bygroup(board);
+                action -> execute(board);
+                delete action;
+            }
+        }
+    }
+    cout << "\t" << phases << " draw phases (" << epidemics << " epidemics): " << different << " ending on a different board\n";
+    cout << "\tbytes allocated per draw phase: " << (double) object_bytes/(double) phases << " with action objects, " << (double) direct_bytes/(double) phases << " without\n";
+    cout << "\twithout: " << quiet_bytes << " bytes over " << quiet_phases << " phases without an epidemic, " << epidemic_bytes << " over the rest (re-added piles: at most " << pile_bytes << ")\n";
+
+    bool same_ok = different==0 && phases>0 && epidemics>0;
+    bool bytes_ok = quiet_bytes==0 && quiet_phases>0 && epidemic_bytes<=pile_bytes && direct_bytes<object_bytes;
+    cout << "Direct draws end where action objects do: " << (same_ok ? "PASSED" : "FAILED") << "\n";
+    cout << "Direct draws allocate nothing but epidemic piles: " << (bytes_ok ? "PASSED" : "FAILED") << "\n\n";
+
+    for(auto& scenario: scenarios){
+        delete scenario.second;
+    }
+
+    bool all_passed = same_ok && bytes_ok;
+    cout << (all_passed ? "All nonplayer action checks PASSED" : "Some nonplayer action checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}
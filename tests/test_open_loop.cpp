@@ -0,0 +1,91 @@
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+
+#include "../experimental_tools/Scenarios.h"
+
+#include "../agents/Heuristics.h"
+#include "../agents/search_tools/Search.h"
+
+// build & run with: make test_open_loop
+
+using namespace std;
+
+// Check every node below `node`: no two children share a key (each choice is stored once, however many traversals find it legal),
+// and its visits are the simulations that ended on it plus its children's visits
+void check_open_loop_tree(Search::OpenLoopNode* node,std::map<Search::Node*,int>& ended,long& nodes,long& repeated_keys,long& miscounted,int& widest){
+    nodes++;
+    std::set<size_t> keys = {};
+    int child_visits = 0;
+    for(int child_num=0;child_num<node -> n_children();child_num++){
+        repeated_keys+= !keys.insert(node -> getChildKey(child_num)).second;
+        Search::Node* child = node -> getChild(child_num);
+        child_visits+= child -> N_visits;
+        check_open_loop_tree(static_cast<Search::OpenLoopNode*>(child),ended,nodes,repeated_keys,miscounted,widest);
+    }
+    widest = std::max(widest,node -> n_children());
+    miscounted+= node -> N_visits != ended[node] + child_visits;
+}
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    std::vector<std::pair<std::string,Scenarios::Scenario*>> scenarios = {
+        {"VanillaGame",new Scenarios::VanillaGameScenario()},
+        {"ForcedDiscard",new Scenarios::ForcedDiscardScenario()},
+        {"BusyBoard",new Scenarios::BusyBoardScenario()},
+        {"CanWin",new Scenarios::CanWinScenario()}
+    };
+    GameLogic::Game game;
+    Search::TreeOptions options;
+    options.open_loop = true;
+    bool all_passed = true;
+
+    const int TREES = 10;
+    const int SIMULATIONS = 500;
+    cout << "Growing " << TREES << " open-loop trees of " << SIMULATIONS << " simulations per scenario...\n";
+    long nodes = 0;
+    long repeated_keys = 0;
+    long miscounted = 0;
+    long bad_roots = 0;
+    int widest = 0;
+    for(auto& scenario: scenarios){
+        for(int tree_num=0;tree_num<TREES;tree_num++){
+            game.reset_board(scenario.second -> make_board({1,2,3},4));
+            Search::GameTree* tree = Search::make_tree(game,1,options);
+            std::map<Search::Node*,int> ended = {};
+            for(int sim=0;sim<SIMULATIONS;sim++){
+                Board::Board board = game.board_copy();
+                Search::Node* leaf = tree -> getBestLeaf(board,Search::tree_policy(options));
+                ended[leaf]++;
+                leaf -> backprop(game.is_terminal(board) ? (double) game.reward(board) : Heuristics::SmartCompoundHeuristic(board,2./3.));
+            }
+            bad_roots+= tree -> root -> N_visits!=SIMULATIONS;
+            check_open_loop_tree(static_cast<Search::OpenLoopNode*>(tree -> root),ended,nodes,repeated_keys,miscounted,widest);
+            delete tree;
+        }
+    }
+    cout << "\t" << nodes << " nodes (at most " << widest << " children): " << repeated_keys << " children with a key a sibling already has\n";
+    bool keys_ok = repeated_keys==0 && nodes>0;
+    cout << "Each choice is one child: " << (keys_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && keys_ok;
+
+    cout << "\t" << miscounted << " nodes whose visits aren't the simulations ending there plus their children's, " << bad_roots << " roots without every simulation\n";
+    bool visits_ok = miscounted==0 && bad_roots==0;
+    cout << "Open-loop visit counts add up: " << (visits_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && visits_ok;
+
+    for(auto& scenario: scenarios){
+        delete scenario.second;
+    }
+
+    cout << (all_passed ? "All open-loop tree checks PASSED" : "Some open-loop tree checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+
+#include "../experimental_tools/Scenarios.h"
+
+#include "../agents/search_tools/Search.h"
+
+// build & run with: make test_rave
+
+using namespace std;
+
+// One simulation of a tree search: where it ended, what its rollout played, the value it backed up,
+// and how many children each node on its path had at the time (nodes added later can't have been credited)
+struct Simulation{
+    Search::Node* leaf;
+    std::vector<size_t> rollout_actions;
+    double value;
+    std::map<Search::Node*,int> children_then;
+};
+
+// Keys of every action listed on `board` (and, if given, their repr()s once they've been executed on a copy of it,
+// which is when Treat and Cure know what they did)
+std::vector<size_t> listed_keys(GameLogic::Game& game,Board::Board& board,std::vector<std::string>* reprs=nullptr){
+    std::vector<size_t> keys = {};
+    for(Actions::Action* action: game.list_actions(board)){
+        keys.push_back(Actions::action_key(action,board));
+        if(reprs){
+            Board::Board after = board;
+            action -> execute(after);
+            reprs -> push_back(action -> repr());
+        }
+        delete action;
+    }
+    return keys;
+}
+
+// Replay the tree from `node` (reached with `board`) and check that the children of every fully expanded decision node
+// have the same keys as the actions listed afresh on that board. Returns how many nodes didn't.
+int check_child_keys(GameLogic::Game& game,Search::Node* node,Board::Board& board,int& checked){
+    int wrong = 0;
+    if(!node -> stochastic && !node -> terminal && node -> n_children()>0){
+        std::vector<size_t> listed = listed_keys(game,board);
+        if(listed.size()==node -> n_children()){
+            std::vector<size_t> children = {};
+            for(int child_num=0;child_num<node -> n_children();child_num++){
+                children.push_back(node -> getChild(child_num) -> action_key);
+            }
+            std::sort(listed.begin(),listed.end());
+            std::sort(children.begin(),children.end());
+            wrong+= listed!=children;
+            checked++;
+        }
+    }
+    for(int child_num=0;child_num<node -> n_children();child_num++){
+        Search::Node* child = node -> getChild(child_num);
+        if(child){
+            Board::Board child_board = board;
+            child -> get_action() -> execute(child_board);
+            wrong+=check_child_keys(game,child,child_board,checked);
+        }
+    }
+    return wrong;
+}
+
+// Recount every node's AMAF statistics from the simulations, top-down: a child of a decision node on a simulation's path
+// gets credit if its action was chosen anywhere below that decision node on the path, or played in the rollout
+void recount_amaf(std::vector<Simulation>& simulations,std::map<Search::Node*,std::pair<int,double>>& amaf){
+    for(Simulation& sim: simulations){
+        std::vector<Search::Node*> path = {};
+        for(Search::Node* node=sim.leaf;node;node=node -> parent){
+            path.insert(path.begin(),node);
+        }
+        for(int depth=0;depth+1<path.size();depth++){
+            Search::Node* decision = path[depth];
+            if(decision -> stochastic){
+                continue;
+            }
+            std::vector<size_t> later = sim.rollout_actions;
+            for(int below=depth+1;below<path.size();below++){
+                if(!path[below] -> parent -> stochastic){
+                    later.push_back(path[below] -> action_key);
+                }
+            }
+            for(int child_num=0;child_num<sim.children_then[decision];child_num++){
+                Search::Node* child = decision -> getChild(child_num);
+                if(std::find(later.begin(),later.end(),child -> action_key)!=later.end()){
+                    amaf[child].first++;
+                    amaf[child].second+=sim.value;
+                }
+            }
+        }
+    }
+}
+
+// Compare every node's kept AMAF statistics to the recount, and check that a child's AMAF visits include all of its own visits.
+void compare_amaf(Search::Node* node,std::map<Search::Node*,std::pair<int,double>>& amaf,long& nodes,long& mismatches,long& fewer_than_visits){
+    for(int child_num=0;child_num<node -> n_children();child_num++){
+        Search::Node* child = node -> getChild(child_num);
+        if(!child){
+            continue;
+        }
+        if(!node -> stochastic){
+            nodes++;
+            std::pair<int,double> recount = amaf.count(child) ? amaf[child] : std::pair<int,double>(0,0.);
+            if(recount.first!=child -> AMAF_visits || std::abs(recount.second - child -> AMAF_reward)>1e-9){
+                mismatches++;
+            }
+            fewer_than_visits+= child -> AMAF_visits<child -> N_visits;
+        }
+        compare_amaf(child,amaf,nodes,mismatches,fewer_than_visits);
+    }
+}
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    std::vector<std::pair<std::string,Scenarios::Scenario*>> scenarios = {
+        {"VanillaGame",new Scenarios::VanillaGameScenario()},
+        {"BusyBoard",new Scenarios::BusyBoardScenario()},
+        {"CanWin",new Scenarios::CanWinScenario()}
+    };
+    GameLogic::Game game;
+    bool all_passed = true;
+
+    // ===== Action keys =====
+    // The same action listed twice on the same board gets the same key, and different actions on one board get different keys
+    // (taken before they're executed, and compared with what they turn out to do)
+    // (a hand can hold two copies of a card, so there can be two of the same action on a board)
+    cout << "Checking Actions::action_key() on every board of random games...\n";
+    long boards = 0;
+    long unstable = 0;
+    long duplicates = 0;
+    std::map<size_t,std::string> cure_of_key = {};
+    long cures = 0;
+    long mixed_cures = 0;
+    for(auto& scenario: scenarios){
+        for(int game_num=0;game_num<20;game_num++){
+            game.reset_board(scenario.second -> make_board({1,2,3},4));
+            Board::Board board = game.board_copy();
+            while(!game.is_terminal(board)){
+                if(!game.is_stochastic(board)){
+                    std::vector<std::string> reprs = {};
+                    std::vector<size_t> first = listed_keys(game,board,&reprs);
+                    Board::Board copy = board;
+                    std::vector<size_t> second = listed_keys(game,copy);
+                    unstable+= first!=second;
+                    // Two actions share a key exactly when they share an executed repr()
+                    std::map<size_t,std::string> repr_of_key = {};
+                    std::map<std::string,size_t> key_of_repr = {};
+                    for(int action_num=0;action_num<first.size();action_num++){
+                        bool known_key = repr_of_key.count(first[action_num])>0;
+                        bool known_repr = key_of_repr.count(reprs[action_num])>0;
+                        if(known_key!=known_repr || (known_key && repr_of_key[first[action_num]]!=reprs[action_num])){
+                            duplicates++;
+                        }
+                        repr_of_key[first[action_num]] = reprs[action_num];
+                        key_of_repr[reprs[action_num]] = first[action_num];
+                        // A Cure's key has to say which color it cures before it's executed, so no key is ever two colors' cure
+                        if(reprs[action_num].rfind("CURE",0)==0){
+                            bool known_cure = cure_of_key.count(first[action_num])>0;
+                            mixed_cures+= known_cure && cure_of_key[first[action_num]]!=reprs[action_num];
+                            cure_of_key[first[action_num]] = reprs[action_num];
+                            cures+= !known_cure;
+                        }
+                    }
+                    boards++;
+                }
+                Actions::Action* action = game.is_stochastic(board) ? game.get_stochastic_action(board) : game.get_random_action_bygroup(board);
+                action -> execute(board);
+                delete action;
+            }
+        }
+    }
+    cout << "\t" << boards << " boards: " << unstable << " listed different keys twice, " << duplicates << " listed two different actions with the same key (or the same action with two)\n";
+    cout << "\t" << cures << " distinct cure keys, " << mixed_cures << " cures of a different color under a key already seen\n";
+    bool keys_ok = unstable==0 && duplicates==0 && mixed_cures==0 && cures>0 && boards>0;
+    cout << "Action keys stable and distinct: " << (keys_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && keys_ok;
+
+    // ===== AMAF statistics in a tree =====
+    const int TREES = 10;
+    const int SIMULATIONS = 400;
+    Search::TreeOptions options;
+    options.rave.enabled = true;
+    cout << "Growing " << TREES << " 2-determinized RAVE trees of " << SIMULATIONS << " random-rollout simulations per scenario, recounting AMAF statistics...\n";
+    long nodes = 0;
+    long mismatches = 0;
+    long fewer_than_visits = 0;
+    long key_nodes = 0;
+    long wrong_keys = 0;
+    for(auto& scenario: scenarios){
+        for(int tree_num=0;tree_num<TREES;tree_num++){
+            game.reset_board(scenario.second -> make_board({1,2,3},4));
+            Search::GameTree* tree = Search::make_tree(game,2,options);
+            std::vector<Simulation> simulations = {};
+            for(int sim=0;sim<SIMULATIONS;sim++){
+                Board::Board board = game.board_copy();
+                Search::Node* leaf = tree -> getBestLeaf(board,Search::RAVEScore);
+                double reward = game.rollout(board,Heuristics::CureGoalConditions,tree -> rollout_record());
+                simulations.push_back({leaf,tree -> rollout_actions,leaf -> terminal ? leaf -> score : reward,{}});
+                for(Search::Node* node=leaf;node;node=node -> parent){
+                    simulations.back().children_then[node] = node -> n_children();
+                }
+                leaf -> backprop(reward);
+                tree -> backprop_amaf(leaf,reward);
+            }
+            std::map<Search::Node*,std::pair<int,double>> amaf = {};
+            recount_amaf(simulations,amaf);
+            compare_amaf(tree -> root,amaf,nodes,mismatches,fewer_than_visits);
+
+            int checked = 0;
+            Board::Board root_board = game.board_copy();
+            wrong_keys+=check_child_keys(game,tree -> root,root_board,checked);
+            key_nodes+=checked;
+            delete tree;
+        }
+    }
+    cout << "\t" << nodes << " nodes: " << mismatches << " differ from the recount, " << fewer_than_visits << " with fewer AMAF visits than visits\n";
+    cout << "\t" << key_nodes << " fully expanded decision nodes: " << wrong_keys << " whose children's keys differ from the actions listed on their board\n";
+    bool amaf_ok = mismatches==0 && fewer_than_visits==0 && nodes>0;
+    bool tree_keys_ok = wrong_keys==0 && key_nodes>0;
+    cout << "AMAF statistics match a recount: " << (amaf_ok ? "PASSED" : "FAILED") << "\n";
+    cout << "Tree action keys match listed actions: " << (tree_keys_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && amaf_ok && tree_keys_ok;
+
+    for(auto& scenario: scenarios){
+        delete scenario.second;
+    }
+
+    cout << (all_passed ? "All RAVE checks PASSED" : "Some RAVE checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}
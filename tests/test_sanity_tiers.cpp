@@ -0,0 +1,207 @@
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+#include "../game_files/SanityCheck.h"
+
+#include "../experimental_tools/Scenarios.h"
+
+// build & run with: make test_sanity_tiers
+
+using namespace std;
+
+// Which tiers break a copy of `board` (quick, full, paranoid)
+std::vector<bool> caught_by(Board::Board& board){
+    Board::Board quick = board;
+    Board::Board full = board;
+    Board::Board paranoid = board;
+    SanityCheck::QuickCheck(quick);
+    SanityCheck::CheckBoard(full);
+    SanityCheck::ParanoidCheck(paranoid);
+    return {quick.broken(),full.broken(),paranoid.broken()};
+}
+
+// Play a random game on a checker, the way Experiments::PlayGame() does. Returns the number of steps.
+int play_checked(GameLogic::Game& game,Scenarios::Scenario* scenario,SanityCheck::Checker& checker,int game_num){
+    game.reset_board(scenario -> make_board({1,2,3},4));
+    Board::Board& board = *game.get_board_ptr();
+    checker.start_game(game_num);
+    checker.step(board);
+    int steps = 0;
+    while(!game.is_terminal(board)){
+        game.nonplayer_actions(board);
+        if(!game.is_terminal(board)){
+            Actions::Action* action = game.get_random_action_bygroup(board);
+            action -> execute(board);
+            delete action;
+        }
+        checker.step(board);
+        steps++;
+    }
+    checker.end_game(board);
+    return steps;
+}
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    std::vector<std::pair<std::string,Scenarios::Scenario*>> scenarios = {
+        {"VanillaGame",new Scenarios::VanillaGameScenario()},
+        {"ForcedDiscard",new Scenarios::ForcedDiscardScenario()},
+        {"BusyBoard",new Scenarios::BusyBoardScenario()},
+        {"CanWin",new Scenarios::CanWinScenario()}
+    };
+    GameLogic::Game game;
+    bool all_passed = true;
+
+    // ===== Legal play =====
+    // (only from a real setup: the other scenarios hand out cards that are still in the deck, seven Airlifts, a station on every city...)
+    const int GAMES = 50;
+    const int LEGAL_GAMES = 200;
+    cout << "Paranoid-checking every step of " << LEGAL_GAMES << " random games...\n";
+    SanityCheck::Schedule everything;
+    everything.game_fraction = 1;
+    everything.paranoid = true;
+    SanityCheck::Checker paranoid_checker(everything);
+    long broken_games = 0;
+    for(int game_num=0;game_num<LEGAL_GAMES;game_num++){
+        play_checked(game,scenarios[0].second,paranoid_checker,game_num);
+        if(game.get_board_ptr() -> broken()){
+            broken_games++;
+            for(std::string& reason: game.get_board_ptr() -> broken_reasons()){
+                cout << "\t" << reason << "\n";
+            }
+        }
+    }
+    cout << "\t" << paranoid_checker.checks[SanityCheck::PARANOID] << " paranoid checks, " << broken_games << " games broken\n";
+    bool legal_ok = broken_games==0 && paranoid_checker.checks[SanityCheck::QUICK]==0;
+    cout << "Legal play passes every tier: " << (legal_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && legal_ok;
+
+    // ===== Broken boards =====
+    // Each tier catches what the ones below it do, and something they don't
+    cout << "Breaking boards behind their back...\n";
+    game.reset_board(scenarios[0].second -> make_board({1,2,3},4));
+    Board::Board fresh = game.board_copy();
+    bool tiers_ok = true;
+
+    Board::Board bad_turn = fresh;
+    bad_turn.get_turn_action() = 7;
+    std::vector<bool> caught = caught_by(bad_turn);
+    cout << "\tturn_action of 7: quick " << caught[0] << ", full " << caught[1] << ", paranoid " << caught[2] << "\n";
+    tiers_ok = tiers_ok && caught[0] && caught[1] && caught[2];
+
+    Board::Board duplicate = fresh;
+    duplicate.active_player().hand.push_back(duplicate.active_player().hand.front());
+    caught = caught_by(duplicate);
+    cout << "\ta card held twice: quick " << caught[0] << ", full " << caught[1] << ", paranoid " << caught[2] << "\n";
+    tiers_ok = tiers_ok && !caught[0] && caught[1] && caught[2];
+
+    Board::Board two_places = fresh;
+    two_places.active_player().UpdateHand(two_places.get_playerdeck_remaining_cards().front());
+    caught = caught_by(two_places);
+    cout << "\ta card in a hand and the deck: quick " << caught[0] << ", full " << caught[1] << ", paranoid " << caught[2] << "\n";
+    tiers_ok = tiers_ok && !caught[0] && !caught[1] && caught[2];
+
+    Board::Board untracked = fresh;
+    untracked.active_player().hand.push_back(untracked.get_playerdeck_remaining_cards().front());
+    caught = caught_by(untracked);
+    cout << "\ta card slipped into a hand behind its color counts: quick " << caught[0] << ", full " << caught[1] << ", paranoid " << caught[2] << "\n";
+    tiers_ok = tiers_ok && !caught[0] && caught[1] && caught[2];
+
+    Board::Board stale = fresh;
+    std::vector<int>& deck = stale.get_playerdeck_remaining_cards();
+    while(stale.active_player().handsize()<8){
+        int card = deck.back();
+        stale.active_player().UpdateHand(card);
+        stale.updatePlayerDeck(card);
+    }
+    caught = caught_by(stale);
+    cout << "\ta full hand the phase doesn't know about: quick " << caught[0] << ", full " << caught[1] << ", paranoid " << caught[2] << "\n";
+    tiers_ok = tiers_ok && !caught[0] && !caught[1] && caught[2];
+    cout << "Each tier catches more: " << (tiers_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && tiers_ok;
+
+    // ===== Schedules =====
+    cout << "Counting the checks a few schedules run over " << GAMES << " games...\n";
+    SanityCheck::Checker by_default;
+    SanityCheck::Schedule every_ten;
+    every_ten.full_every = 10;
+    SanityCheck::Checker every_ten_steps(every_ten);
+    SanityCheck::Schedule quarter;
+    quarter.game_fraction = 0.25;
+    SanityCheck::Checker quarter_of_games(quarter);
+    // (step() is called once before the first action, so a game of n actions has n+1 of them)
+    long steps = 0;
+    for(int game_num=0;game_num<GAMES;game_num++){
+        steps+= play_checked(game,scenarios[0].second,by_default,game_num)+1;
+    }
+    long ten_steps = 0;
+    long ten_tenths = 0;
+    for(int game_num=0;game_num<GAMES;game_num++){
+        int game_steps = play_checked(game,scenarios[0].second,every_ten_steps,game_num);
+        ten_steps+= game_steps+1;
+        ten_tenths+= (game_steps+1)/10;
+    }
+    long quarter_steps = 0;
+    long quarter_full_games = 0;
+    for(int game_num=0;game_num<GAMES;game_num++){
+        long full_before = quarter_of_games.checks[SanityCheck::FULL];
+        int game_steps = play_checked(game,scenarios[0].second,quarter_of_games,game_num);
+        quarter_steps+= game_steps+1;
+        // (a fully checked game has one per step, plus the final board)
+        quarter_full_games+= quarter_of_games.checks[SanityCheck::FULL]-full_before==game_steps+2;
+    }
+    cout << "\tdefault: " << by_default.checks[SanityCheck::QUICK] << " quick, " << by_default.checks[SanityCheck::FULL] << " full (" << steps << " steps)\n";
+    cout << "\tfull every 10 steps: " << every_ten_steps.checks[SanityCheck::QUICK] << " quick, " << every_ten_steps.checks[SanityCheck::FULL] << " full (" << ten_steps << " steps)\n";
+    cout << "\tfull on a quarter of games: " << quarter_full_games << " games fully checked\n";
+    bool schedules_ok = by_default.checks[SanityCheck::QUICK]==steps && by_default.checks[SanityCheck::FULL]==GAMES
+        && every_ten_steps.checks[SanityCheck::FULL]==ten_tenths+GAMES && every_ten_steps.checks[SanityCheck::QUICK]==ten_steps-ten_tenths
+        && quarter_full_games==GAMES/4 && by_default.checks[SanityCheck::PARANOID]==0 && by_default.games==GAMES;
+    cout << "Checkers run what their schedule says: " << (schedules_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && schedules_ok;
+
+    // ===== Cost =====
+    const int REPEATS = 20000;
+    cout << "Timing each tier " << REPEATS << " times on a board from the middle of a game...\n";
+    game.reset_board(scenarios[0].second -> make_board({1,2,3},4));
+    Board::Board midgame = game.board_copy();
+    for(int step=0;step<40 && !game.is_terminal(midgame);step++){
+        game.nonplayer_actions(midgame);
+        if(!game.is_terminal(midgame)){
+            Actions::Action* action = game.get_random_action_bygroup(midgame);
+            action -> execute(midgame);
+            delete action;
+        }
+    }
+    std::vector<double> nanos = {};
+    for(int tier=0;tier<3;tier++){
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for(int repeat=0;repeat<REPEATS;repeat++){
+            if(tier==SanityCheck::QUICK){
+                SanityCheck::QuickCheck(midgame);
+            } else if(tier==SanityCheck::FULL){
+                SanityCheck::CheckBoard(midgame);
+            } else {
+                SanityCheck::ParanoidCheck(midgame);
+            }
+        }
+        nanos.push_back(std::chrono::duration<double,std::nano>(std::chrono::steady_clock::now() - start).count()/(double) REPEATS);
+    }
+    cout << "\tns per check: quick " << nanos[0] << ", full " << nanos[1] << ", paranoid " << nanos[2] << "\n";
+    bool cost_ok = nanos[0]<nanos[1] && nanos[1]<nanos[2] && !midgame.broken();
+    cout << "Cheaper tiers are cheaper: " << (cost_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && cost_ok;
+
+    for(auto& scenario: scenarios){
+        delete scenario.second;
+    }
+
+    cout << (all_passed ? "All sanity tier checks PASSED" : "Some sanity tier checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include <atomic>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Random.h"
+
+#include "../experimental_tools/Experiments.h"
+#include "../experimental_tools/Registry.h"
+
+// build & run with: make test_threaded_seeds
+
+using namespace std;
+
+// Play game `game_num` of a seeded experiment the way Experiments::RunExperiment() does (its own deck and search streams),
+// and return its measurements as one string.
+std::string play_seeded_game(Experiments::ConfiguredExperiment& experiment,int game_num){
+    Random::ChanceStreams chance;
+    Random::Stream search;
+    chance.seed(Random::GameSeed(experiment.seed,game_num));
+    search.seed(Random::SearchSeed(experiment.seed,game_num));
+    Random::SearchScope search_scope(&search);
+
+    Board::Board* board;
+    {
+        Random::ChanceScope scope(&chance);
+        board = experiment.get_board();
+    }
+    GameLogic::Game game;
+    game.reset_board(board);
+    Agents::BaseAgent* agent = experiment.get_agent(&game);
+    std::vector<Measurements::GameMeasurement*> measures = experiment.get_game_measures(board);
+    Experiments::PlayGame(&game,agent,measures,&chance);
+
+    std::string values = "";
+    for(Measurements::GameMeasurement* meas: measures){
+        for(double& val: meas -> get_values()){
+            values+=std::to_string(val)+",";
+        }
+        delete meas;
+    }
+    delete agent;
+    return values;
+}
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    std::vector<std::pair<std::string,std::string>> agents = {
+        {"ByGroupRandom","1"},
+        {"Naive_UCT","1"},
+        {"SmartCompoundWL_UCTMaxChild","3"}
+    };
+    const int GAMES = 8;
+    const int THREADS = 4;
+    bool all_passed = true;
+
+    for(auto& agent: agents){
+        Registry::Params params;
+        params.set("agent",agent.first);
+        params.set("K",agent.second);
+        params.set("n_simulations","50");
+        params.set("measurements","WinLose,LoseStatus,ActionCount");
+        params.set("seed",std::to_string(rand()));
+        Experiments::ConfiguredExperiment experiment(params);
+        if(!experiment.valid){
+            cout << agent.first << ": configuration didn't resolve (FAILED)\n";
+            all_passed = false;
+            continue;
+        }
+
+        cout << "Playing " << GAMES << " seeded " << agent.first << " games on one thread, then again shared out over " << THREADS << "...\n";
+        std::vector<std::string> alone = {};
+        for(int game_num=0;game_num<GAMES;game_num++){
+            alone.push_back(play_seeded_game(experiment,game_num));
+        }
+
+        // (in the opposite order, next to a thread that keeps pulling from rand() to shift anything that still uses it)
+        std::vector<std::string> shared(GAMES,"");
+        std::atomic<int> next_game(0);
+        std::atomic<bool> done(false);
+        std::thread noise([&](){
+            while(!done){
+                rand();
+            }
+        });
+        std::vector<std::thread> workers = {};
+        for(int t=0;t<THREADS;t++){
+            workers.push_back(std::thread([&](){
+                int game_num;
+                while((game_num = GAMES-1-next_game++)>=0){
+                    shared[game_num] = play_seeded_game(experiment,game_num);
+                }
+            }));
+        }
+        for(std::thread& worker: workers){
+            worker.join();
+        }
+        done = true;
+        noise.join();
+
+        int different = 0;
+        for(int game_num=0;game_num<GAMES;game_num++){
+            different+= alone[game_num]!=shared[game_num];
+        }
+        cout << "\t" << different << " of " << GAMES << " games came out differently" << (different==0 ? " (PASSED)" : " (FAILED)") << "\n\n";
+        all_passed = all_passed && different==0;
+    }
+
+    cout << (all_passed ? "All threaded seed checks PASSED" : "Some threaded seed checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}
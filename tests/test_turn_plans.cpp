@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+
+#include "../experimental_tools/Scenarios.h"
+
+#include "../agents/Heuristics.h"
+#include "../agents/search_tools/Hashes.h"
+#include "../agents/search_tools/Search.h"
+#include "../agents/search_tools/TurnPlans.h"
+
+// build & run with: make test_turn_plans
+
+using namespace std;
+
+// The same board, as far as a plan can tell (see list_turn_plans())
+size_t end_key(Board::Board& board){
+    return Hashes::boardHash(board)*31 + Hashes::VecHash(board.get_cure_status())*7 + board.quiet_night_status();
+}
+
+// Whether `action` is one of the actions listed on `board`: one of them, of the same kind, does the same thing to it
+// (repr() can't tell, since Treat and Cure change theirs when they're executed)
+bool is_listed(GameLogic::Game& game,Board::Board& board,Actions::Action* action){
+    Board::Board after = board;
+    action -> execute(after);
+    bool listed = false;
+    for(Actions::Action* legal: game.list_actions(board)){
+        if(!listed && legal -> movetype==action -> movetype){
+            Board::Board legal_after = board;
+            legal -> execute(legal_after);
+            listed = end_key(legal_after)==end_key(after);
+        }
+        delete legal;
+    }
+    return listed;
+}
+
+// Replay `plan` on a copy of `board`, checking every action is legal when it's played and that the plan stops exactly at the next draw (or the end of the game).
+// Leaves the final board in `end`.
+bool plan_ok(GameLogic::Game& game,Board::Board& board,Search::TurnPlan* plan,Board::Board& end){
+    end = board;
+    if(plan -> actions.empty()){
+        return false;
+    }
+    for(int action_num=0;action_num<plan -> actions.size();action_num++){
+        if(game.is_terminal(end) || game.is_stochastic(end) || !is_listed(game,end,plan -> actions[action_num])){
+            return false;
+        }
+        plan -> actions[action_num] -> execute(end);
+    }
+    return game.is_terminal(end) || game.is_stochastic(end);
+}
+
+// Check every decision node of a MacroGameTree: each child's action is a plan, and the child is reached at a draw (or the end of the game)
+void check_macro_tree(Search::Node* node,long& nodes,long& wrong_edges){
+    for(int child_num=0;child_num<node -> n_children();child_num++){
+        Search::Node* child = node -> getChild(child_num);
+        if(!child){
+            continue;
+        }
+        if(!node -> stochastic){
+            nodes++;
+            wrong_edges+= child -> get_action() -> movetype!="PLAN" || !(child -> stochastic || child -> terminal);
+        }
+        check_macro_tree(child,nodes,wrong_edges);
+    }
+}
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    std::vector<std::pair<std::string,Scenarios::Scenario*>> scenarios = {
+        {"VanillaGame",new Scenarios::VanillaGameScenario()},
+        {"ForcedDiscard",new Scenarios::ForcedDiscardScenario()},
+        {"BusyBoard",new Scenarios::BusyBoardScenario()},
+        {"CanWin",new Scenarios::CanWinScenario()}
+    };
+    GameLogic::Game game;
+    Search::MacroOptions options;
+    options.enabled = true;
+    bool all_passed = true;
+
+    // ===== Turn plans =====
+    const int GAMES = 5;
+    cout << "Listing turn plans on every decision board of " << GAMES << " random games per scenario...\n";
+    long boards = 0;
+    long plans = 0;
+    long bad_plans = 0;
+    long repeated_boards = 0;
+    long bad_values = 0;
+    long unordered = 0;
+    long too_many = 0;
+    for(auto& scenario: scenarios){
+        for(int game_num=0;game_num<GAMES;game_num++){
+            game.reset_board(scenario.second -> make_board({1,2,3},4));
+            Board::Board board = game.board_copy();
+            while(!game.is_terminal(board)){
+                if(!game.is_stochastic(board)){
+                    std::vector<Actions::Action*> listed = Search::list_turn_plans(board,game,options);
+                    too_many+= listed.size()>options.width || listed.empty();
+                    std::set<size_t> ends = {};
+                    for(int plan_num=0;plan_num<listed.size();plan_num++){
+                        Search::TurnPlan* plan = static_cast<Search::TurnPlan*>(listed[plan_num]);
+                        Board::Board end = board;
+                        if(!plan_ok(game,board,plan,end)){
+                            bad_plans++;
+                            continue;
+                        }
+                        double value = game.is_terminal(end) ? (double) game.reward(end) : Heuristics::SmartCompoundHeuristic(end,options.alpha);
+                        bad_values+= value!=plan -> value;
+                        repeated_boards+= !ends.insert(end_key(end)).second;
+                        unordered+= plan_num>0 && plan -> value < static_cast<Search::TurnPlan*>(listed[plan_num-1]) -> value;
+                        plans++;
+                    }
+                    for(Actions::Action* plan: listed){
+                        delete plan;
+                    }
+                    boards++;
+                }
+                Actions::Action* action = game.is_stochastic(board) ? game.get_stochastic_action(board) : game.get_random_action_bygroup(board);
+                action -> execute(board);
+                delete action;
+            }
+        }
+    }
+    cout << "\t" << boards << " boards, " << plans << " plans: " << bad_plans << " illegal or not ending at a draw, " << repeated_boards << " ending on the same board as another, "
+        << bad_values << " with the wrong value, " << unordered << " out of order, " << too_many << " boards with no plans or too many\n";
+    bool plans_ok = bad_plans==0 && repeated_boards==0 && bad_values==0 && unordered==0 && too_many==0 && plans>0;
+    cout << "Turn plans legal, distinct and ranked: " << (plans_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && plans_ok;
+
+    // ===== Macro trees =====
+    const int TREES = 5;
+    const int SIMULATIONS = 300;
+    Search::TreeOptions tree_options;
+    tree_options.macro = options;
+    cout << "Growing " << TREES << " 2-determinized macro trees of " << SIMULATIONS << " simulations per scenario...\n";
+    long nodes = 0;
+    long wrong_edges = 0;
+    long bad_choices = 0;
+    for(auto& scenario: scenarios){
+        for(int tree_num=0;tree_num<TREES;tree_num++){
+            game.reset_board(scenario.second -> make_board({1,2,3},4));
+            Search::GameTree* tree = Search::make_tree(game,2,tree_options);
+            for(int sim=0;sim<SIMULATIONS;sim++){
+                Board::Board board = game.board_copy();
+                Search::Node* leaf = tree -> getBestLeaf(board,Search::tree_policy(tree_options));
+                leaf -> backprop(Heuristics::SmartCompoundHeuristic(board,options.alpha));
+            }
+            check_macro_tree(tree -> root,nodes,wrong_edges);
+
+            // The agent plays the first action of the plan it chooses, which has to be legal now
+            Board::Board root_board = game.board_copy();
+            Search::Node* chosen = tree -> bestRootChild(Search::UCB1Score);
+            Actions::Action* action = tree -> chosen_action(chosen);
+            bad_choices+= action!=static_cast<Search::TurnPlan*>(chosen -> get_action()) -> actions.front() || !is_listed(game,root_board,action);
+            delete tree;
+        }
+    }
+    cout << "\t" << nodes << " decision-node children: " << wrong_edges << " not a whole plan, " << bad_choices << " trees choosing an action that isn't legal on the root\n";
+    bool tree_ok = wrong_edges==0 && bad_choices==0 && nodes>0;
+    cout << "Macro tree edges are whole plans: " << (tree_ok ? "PASSED" : "FAILED") << "\n\n";
+    all_passed = all_passed && tree_ok;
+
+    for(auto& scenario: scenarios){
+        delete scenario.second;
+    }
+
+    cout << (all_passed ? "All turn plan checks PASSED" : "Some turn plan checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}
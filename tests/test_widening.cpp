@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../game_files/GameLogic.h"
+#include "../game_files/Actions.h"
+
+#include "../experimental_tools/Scenarios.h"
+
+#include "../agents/search_tools/Search.h"
+
+// build & run with: make test_widening
+
+using namespace std;
+
+// Walk the tree from `node` (reached with `board`) and check every decision node:
+// - it has no more children than progressive widening admits at its visits
+// - its children were admitted best prior first (children are kept in the order they were added)
+// - its children's priors are the shares action_prior() gives them among all the actions listed on its board
+void check_widening(GameLogic::Game& game,Search::Node* node,Board::Board& board,const Search::ProgressiveWidening& widening,
+    long& nodes,long& too_wide,long& out_of_order,long& wrong_priors){
+    if(!node -> stochastic && !node -> terminal && node -> n_children()>0){
+        nodes++;
+        double admitted = std::max(std::ceil(widening.coefficient * std::pow((double) node -> N_visits,widening.exponent)),1.);
+        too_wide+= node -> n_children()>admitted;
+
+        double total = 0;
+        for(Actions::Action* action: game.list_actions(board)){
+            total+=Search::action_prior(action,board);
+            delete action;
+        }
+        for(int child_num=0;child_num<node -> n_children();child_num++){
+            Search::Node* child = node -> getChild(child_num);
+            if(child_num>0 && child -> prior > node -> getChild(child_num-1) -> prior + 1e-12){
+                out_of_order++;
+            }
+            wrong_priors+= std::abs(child -> prior - Search::action_prior(child -> get_action(),board)/total)>1e-9;
+        }
+    }
+    for(int child_num=0;child_num<node -> n_children();child_num++){
+        Search::Node* child = node -> getChild(child_num);
+        if(child){
+            Board::Board child_board = board;
+            child -> get_action() -> execute(child_board);
+            check_widening(game,child,child_board,widening,nodes,too_wide,out_of_order,wrong_priors);
+        }
+    }
+}
+
+int main(){
+    srand(time(NULL));
+    rand();
+
+    std::vector<std::pair<std::string,Scenarios::Scenario*>> scenarios = {
+        {"VanillaGame",new Scenarios::VanillaGameScenario()},
+        {"BusyBoard",new Scenarios::BusyBoardScenario()},
+        {"CanWin",new Scenarios::CanWinScenario()}
+    };
+    GameLogic::Game game;
+
+    const int TREES = 10;
+    const int SIMULATIONS = 1000;
+    Search::TreeOptions widened;
+    widened.widening.enabled = true;
+    cout << "Growing " << TREES << " 2-determinized progressively widened trees of " << SIMULATIONS << " random-rollout simulations per scenario...\n";
+    long nodes = 0;
+    long too_wide = 0;
+    long out_of_order = 0;
+    long wrong_priors = 0;
+    for(auto& scenario: scenarios){
+        for(int tree_num=0;tree_num<TREES;tree_num++){
+            game.reset_board(scenario.second -> make_board({1,2,3},4));
+            Search::GameTree* tree = Search::make_tree(game,2,widened);
+            for(int sim=0;sim<SIMULATIONS;sim++){
+                Board::Board board = game.board_copy();
+                Search::Node* leaf = tree -> getBestLeaf(board,Search::tree_policy(widened));
+                leaf -> backprop(game.rollout(board,Heuristics::CureGoalConditions));
+            }
+            Board::Board root_board = game.board_copy();
+            check_widening(game,tree -> root,root_board,widened.widening,nodes,too_wide,out_of_order,wrong_priors);
+            delete tree;
+        }
+    }
+    cout << "\t" << nodes << " decision nodes with children: " << too_wide << " with more children than admitted, " << out_of_order << " admitted a lower prior first, "
+        << wrong_priors << " with a child whose prior isn't its share of action_prior()\n";
+
+    bool width_ok = too_wide==0 && nodes>0;
+    bool order_ok = out_of_order==0 && wrong_priors==0;
+    cout << "Children admitted within the widening bound: " << (width_ok ? "PASSED" : "FAILED") << "\n";
+    cout << "Children admitted in prior order, with normalized priors: " << (order_ok ? "PASSED" : "FAILED") << "\n\n";
+
+    for(auto& scenario: scenarios){
+        delete scenario.second;
+    }
+
+    bool all_passed = width_ok && order_ok;
+    cout << (all_passed ? "All progressive widening checks PASSED" : "Some progressive widening checks FAILED") << endl;
+    return all_passed ? 0 : 1;
+}